@@ -4,6 +4,7 @@
 
 #include "../common/misc_functions.h"
 #include "../common/eqemu_logsys.h"
+#include "../common/rdtsc.h"
 
 #include "dbcore.h"
 
@@ -40,6 +41,9 @@ DBcore::DBcore() {
 	pCompress = false;
 	pSSL = false;
 	pStatus = Closed;
+	query_count = 0;
+	query_time_us = 0;
+	query_max_us = 0;
 }
 
 DBcore::~DBcore() {
@@ -73,6 +77,8 @@ MySQLRequestResult DBcore::QueryDatabase(const char* query, uint32 querylen, boo
 	if (pStatus != Connected)
 		Open();
 
+	RDTSC_Timer query_timer(true);
+
 	// request query. != 0 indicates some kind of error.
 	if (mysql_real_query(&mysql, query, querylen) != 0)
 	{
@@ -128,6 +134,13 @@ MySQLRequestResult DBcore::QueryDatabase(const char* query, uint32 querylen, boo
         rowCount = (uint32)mysql_num_rows(res);
 
 	MySQLRequestResult requestResult(res, (uint32)mysql_affected_rows(&mysql), rowCount, (uint32)mysql_field_count(&mysql), (uint32)mysql_insert_id(&mysql));
+
+	query_timer.stop();
+	uint32 elapsed_us = static_cast<uint32>(query_timer.getTicks() * 1000 / RDTSC_Timer::ticksPerMS());
+	query_count++;
+	query_time_us += elapsed_us;
+	if (elapsed_us > query_max_us)
+		query_max_us = elapsed_us;
 	
 	if (Log.log_settings[Logs::MySQLQuery].is_category_enabled == 1)
 		Log.Out(Logs::General, Logs::MySQLQuery, "%s (%u rows returned)", query, rowCount, requestResult.RowCount());
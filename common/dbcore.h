@@ -29,6 +29,11 @@ public:
 	void	ping();
 	MYSQL*	getMySQL(){ return &mysql; }
 
+	//query timing, totals since startup, max since the last TakeQueryMaxUS()
+	uint64	GetQueryCount() const	{ return query_count; }
+	uint64	GetQueryTimeUS() const	{ return query_time_us; }
+	uint32	TakeQueryMaxUS()		{ uint32 m = query_max_us; query_max_us = 0; return m; }
+
 protected:
 	bool	Open(const char* iHost, const char* iUser, const char* iPassword, const char* iDatabase, uint32 iPort, uint32* errnum = 0, char* errbuf = 0, bool iCompress = false, bool iSSL = false);
 private:
@@ -46,6 +51,10 @@ private:
 	uint32	pPort;
 	bool	pSSL;
 
+	uint64	query_count;
+	uint64	query_time_us;
+	uint32	query_max_us;
+
 };
 
 
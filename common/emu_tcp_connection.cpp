@@ -30,6 +30,7 @@ tremendously.
 
 #include "emu_tcp_connection.h"
 #include "emu_tcp_server.h"
+#include "event_signal.h"
 #include "../common/servertalk.h"
 
 #ifdef FREEBSD //Timothy Whitman - January 7, 2003
@@ -65,7 +66,7 @@ EmuTCPConnection::EmuTCPConnection(uint32 ID, EmuTCPServer* iServer, SOCKET in_s
 	RelayServer = false;
 	RelayCount = 0;
 	RemoteID = 0;
-
+	WakeSignal = nullptr;
 }
 
 //client outgoing connection case (and client side relay)
@@ -85,6 +86,7 @@ EmuTCPConnection::EmuTCPConnection(bool iOldFormat, EmuTCPServer* iRelayServer,
 	pOldFormat = iOldFormat;
 	TCPMode = iMode;
 	PacketMode = packetModeZone;
+	WakeSignal = nullptr;
 #if TCPN_DEBUG_Memory >= 7
 	std::cout << "Constructor #1 on outgoing TCP# " << GetID() << std::endl;
 #endif
@@ -105,6 +107,7 @@ EmuTCPConnection::EmuTCPConnection(uint32 ID, EmuTCPServer* iServer, EmuTCPConne
 	ConnectionType = Incoming;
 	TCPMode = modePacket;
 	PacketMode = packetModeZone;
+	WakeSignal = nullptr;
 #if TCPN_DEBUG_Memory >= 7
 	std::cout << "Constructor #3 on outgoing TCP# " << GetID() << std::endl;
 #endif
@@ -270,6 +273,8 @@ void EmuTCPConnection::OutQueuePush(ServerPacket* pack) {
 	MOutQueueLock.lock();
 	OutQueue.push(pack);
 	MOutQueueLock.unlock();
+	if (WakeSignal)
+		WakeSignal->Signal();
 }
 
 
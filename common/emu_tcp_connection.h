@@ -26,6 +26,7 @@
 
 struct SPackSendQueue;
 class EmuTCPServer;
+class EventSignal;
 class ServerPacket;
 
 class EmuTCPConnection : public TCPConnection {
@@ -48,6 +49,7 @@ public:
 	virtual bool	SendPacket(EmuTCPNetPacket_Struct* tnps);
 	ServerPacket*	PopPacket(); // OutQueuePop()
 	void SetPacketMode(ePacketMode mode) { PacketMode = mode; }
+	void SetWakeSignal(EventSignal *signal) { WakeSignal = signal; }	//signalled from the connection thread for each packet queued for PopPacket()
 
 	eTCPMode		GetMode()	const		{ return TCPMode; }
 	ePacketMode		GetPacketMode() const	{ return(PacketMode); }
@@ -96,6 +98,7 @@ protected:
 	//output queue...
 	MyQueue<ServerPacket> OutQueue;
 	Mutex	MOutQueueLock;
+	EventSignal*	WakeSignal;
 };
 
 #endif /*EmuTCPCONNECTION_H_*/
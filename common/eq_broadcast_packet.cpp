@@ -0,0 +1,96 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "global_define.h"
+#include "eq_broadcast_packet.h"
+#include "eq_packet.h"
+#include "eq_stream_intf.h"
+#include "struct_strategy.h"
+
+//stands in for a stream while an encoder runs, keeping whatever it queues
+class EncodeCapture : public EQStreamInterface {
+public:
+	EncodeCapture(std::vector<EQBroadcastPacket::Encoded> &out) : m_out(out) { }
+
+	virtual void QueuePacket(const EQApplicationPacket *p, bool ack_req) {
+		if (p == nullptr)
+			return;
+		EQBroadcastPacket::Encoded e = { p->Copy(), ack_req };
+		m_out.push_back(e);
+	}
+	virtual void FastQueuePacket(EQApplicationPacket **p, bool ack_req) {
+		if (p == nullptr || *p == nullptr)
+			return;
+		EQBroadcastPacket::Encoded e = { *p, ack_req };
+		m_out.push_back(e);
+		*p = nullptr;
+	}
+
+	virtual EQApplicationPacket *PopPacket() { return nullptr; }
+	virtual void Close() { }
+	virtual void ReleaseFromUse() { }
+	virtual void RemoveData() { }
+	virtual uint32 GetRemoteIP() const { return 0; }
+	virtual uint16 GetRemotePort() const { return 0; }
+	virtual bool CheckState(EQStreamState state) { return state == ESTABLISHED; }
+	virtual std::string Describe() const { return "Broadcast encoder"; }
+	virtual bool IsInUse() { return true; }
+
+private:
+	std::vector<EQBroadcastPacket::Encoded> &m_out;
+};
+
+void EQStreamInterface::QueueBroadcast(EQBroadcastPacket *p, bool ack_req) {
+	QueuePacket(p->GetSource(), ack_req);
+}
+
+EQBroadcastPacket::EQBroadcastPacket(const EQApplicationPacket *source)
+:	m_source(source)
+{
+}
+
+EQBroadcastPacket::~EQBroadcastPacket() {
+	for (size_t i = 0; i < m_encodes.size(); i++) {
+		for (size_t j = 0; j < m_encodes[i].packets.size(); j++)
+			delete m_encodes[i].packets[j].packet;
+	}
+}
+
+const EQBroadcastPacket::Encoding &EQBroadcastPacket::Encode(const StructStrategy *structs, bool ack_req) {
+	for (size_t i = 0; i < m_encodes.size(); i++) {
+		if (m_encodes[i].structs == structs && m_encodes[i].ack_req == ack_req)
+			return m_encodes[i];
+	}
+
+	m_encodes.push_back(Encoding());
+	Encoding &enc = m_encodes.back();
+	enc.structs = structs;
+	enc.ack_req = ack_req;
+
+	//encoders take ownership of what they are given
+	EQApplicationPacket *copy = m_source->Copy();
+	EncodeCapture capture(enc.packets);
+	structs->Encode(&copy, &capture, ack_req);
+	return enc;
+}
+
+void EQBroadcastPacket::Queue(const StructStrategy *structs, EQStreamInterface *dest, bool ack_req) {
+	const Encoding &enc = Encode(structs, ack_req);
+	for (size_t i = 0; i < enc.packets.size(); i++)
+		dest->QueuePacket(enc.packets[i].packet, enc.packets[i].ack_req);
+}
@@ -0,0 +1,73 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef EQBROADCASTPACKET_H_
+#define EQBROADCASTPACKET_H_
+
+#include "types.h"
+
+#include <vector>
+
+class EQApplicationPacket;
+class EQStreamInterface;
+class StructStrategy;
+
+/*
+	One emu packet on its way to many streams.
+
+	The first stream of each client version runs the packet through its
+	StructStrategy, the wire packets that come out are kept and every later
+	stream of that version queues the same buffers, framing them into its
+	own sequence space. The encoded packets are never modified after they
+	are captured, so streams only read them.
+
+	The source packet is not owned and must outlive the broadcast, which is
+	meant to live on the stack of the helper sending it.
+*/
+class EQBroadcastPacket {
+public:
+	EQBroadcastPacket(const EQApplicationPacket *source);
+	~EQBroadcastPacket();
+
+	inline const EQApplicationPacket *GetSource() const { return m_source; }
+
+	//queue the packet encoded by `structs` into `dest`, encoding it on first use
+	void Queue(const StructStrategy *structs, EQStreamInterface *dest, bool ack_req);
+
+	inline uint32 GetEncodeCount() const { return m_encodes.size(); }
+
+private:
+	friend class EncodeCapture;
+
+	struct Encoded {
+		EQApplicationPacket *packet;
+		bool ack_req;
+	};
+
+	struct Encoding {
+		const StructStrategy *structs;
+		bool ack_req;
+		std::vector<Encoded> packets;
+	};
+
+	const Encoding &Encode(const StructStrategy *structs, bool ack_req);
+
+	const EQApplicationPacket *const m_source;
+	std::vector<Encoding> m_encodes;	//one per client version seen, a linear scan is fine for three
+};
+
+#endif /*EQBROADCASTPACKET_H_*/
@@ -790,7 +790,10 @@ void EQOldPacket::DecodePacket(uint16 length, uchar *pPacket)
 
 uint32 EQOldPacket::ReturnPacket(uchar** data, EQOldStream* netcon) {
 	*data = new uchar[dwExtraSize + 39];
-	uchar* buf = *data;
+	return ReturnPacket(*data, netcon);
+}
+
+uint32 EQOldPacket::ReturnPacket(uchar* buf, EQOldStream* netcon) {
 	uint32 o = 4;
 	bool clearFlags = false;
 	this->dwSEQ = netcon->SACK.dwGSQ;
@@ -142,6 +142,7 @@ public:
 public:
 	void  DecodePacket(uint16 length, uchar *pPacket);
 	uint32 ReturnPacket(uchar** data, EQOldStream* netcon);
+	uint32 ReturnPacket(uchar* buf, EQOldStream* netcon);	//buf holds at least dwExtraSize + 39 bytes
 	EQRawApplicationPacket *MakeAppPacket() const;
 	void Clear(void) 
 	{  
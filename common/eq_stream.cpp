@@ -1571,6 +1571,7 @@ EQOldStream::EQOldStream(sockaddr_in in, int fd_sock)
 	dwLastCACK = 0;
 	dwFragSeq  = 0;
 	listening_socket = fd_sock;
+	arsp_response = 0;
 			    
 	no_ack_received_timer = new Timer(500);
 	datarate_timer = new Timer(100, true);
@@ -1613,6 +1614,12 @@ EQOldStream::EQOldStream(sockaddr_in in, int fd_sock)
 	RateThreshold=RATEBASE/250;
 	DecayRate=DECAYBASE/250;
 	bTimeoutTrigger = false;
+	packets_sent = 0;
+	packets_resent = 0;
+	packets_recv = 0;
+	ack_rtt_total = 0;
+	ack_rtt_max = 0;
+	ack_rtt_count = 0;
 }
 
 EQOldStream::EQOldStream()
@@ -1662,6 +1669,12 @@ EQOldStream::EQOldStream()
 	isWriting = false;
 	RateThreshold=RATEBASE/250;
 	DecayRate=DECAYBASE/250;
+	packets_sent = 0;
+	packets_resent = 0;
+	packets_recv = 0;
+	ack_rtt_total = 0;
+	ack_rtt_max = 0;
+	ack_rtt_count = 0;
 }
 
 EQOldStream::~EQOldStream()
@@ -1674,6 +1687,38 @@ EQOldStream::~EQOldStream()
 	Log.Out(Logs::Detail, Logs::Netcode, "Killing outbound and inbound packet queue");
 	RemoveData();
 	SetState(CLOSED);
+	for (size_t i = 0; i < packet_pool.size(); i++)
+		safe_delete(packet_pool[i]);
+	packet_pool.clear();
+}
+
+//caller holds MOutboundQueue
+EQOldPacket *EQOldStream::AllocPacket()
+{
+	if (packet_pool.empty()) {
+		EQOldPacket *pack = new EQOldPacket();
+		pack->pExtra = new uchar[EQOLDSTREAM_MAX_FRAGMENT];
+		return pack;
+	}
+
+	EQOldPacket *pack = packet_pool.back();
+	packet_pool.pop_back();
+	uchar *extra = pack->pExtra;
+	pack->Clear();
+	pack->pExtra = extra;
+	return pack;
+}
+
+//caller holds MOutboundQueue
+void EQOldStream::ReleasePacket(EQOldPacket *pack)
+{
+	if (pack == nullptr)
+		return;
+	if (packet_pool.size() < EQOLDSTREAM_PACKET_POOL) {
+		packet_pool.push_back(pack);
+		return;
+	}
+	safe_delete(pack);
 }
 
 void EQOldStream::IncomingARSP(uint16 dwARSP) 
@@ -1687,7 +1732,14 @@ void EQOldStream::IncomingARSP(uint16 dwARSP)
 	{
 		if (dwARSP >= (*it)->dwARQ || (*it)->dwARQ > 60000 && dwARSP < 10000)
 		{
-			safe_delete(*it);
+			if ((*it)->LastSent) {
+				uint32 rtt = Timer::GetCurrentTime() - (*it)->LastSent;
+				ack_rtt_total += rtt;
+				ack_rtt_count++;
+				if (rtt > ack_rtt_max)
+					ack_rtt_max = rtt;
+			}
+			ReleasePacket(*it);
 			it = SendQueue.erase(it);
 		}
 		else
@@ -1740,6 +1792,7 @@ void EQOldStream::ParceEQPacket(uint16 dwSize, uchar* pPacket)
 	/************ DECODE PACKET ************/
 	EQOldPacket* pack = new EQOldPacket(pPacket, dwSize);
 	pack->DecodePacket(dwSize, pPacket);
+	packets_recv++;
 	if (ProcessPacket(pack, false))
 	{
 		safe_delete(pack);//delete pack;
@@ -1767,7 +1820,7 @@ void EQOldStream::RemoveData()
 	EQOldPacket* pack = 0;
 	while (!SendQueue.empty()) {
 		pack = SendQueue.front();
-		safe_delete(pack);
+		ReleasePacket(pack);
 		SendQueue.pop_front();
 	}
 	SendQueue.clear();
@@ -1980,7 +2033,7 @@ void EQOldStream::CheckBufferedPackets()
 
 void EQOldStream::MakeClosePacket()
 {
-	EQOldPacket *pack = new EQOldPacket();
+	EQOldPacket *pack = AllocPacket();
 	pack->HDR.a6_Closing    = 1;// Agz: Lets try to uncomment this line again
 	pack->HDR.a2_Closing    = 1;// and this
 	pack->HDR.a1_ARQ        = 1;// and this
@@ -2001,28 +2054,19 @@ void EQOldStream::MakeClosePacket()
 	resent. This is used by the EQ servers for HP and position updates among 
 	other things. WARNING: I havent tested this yet.
 */
-void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req)
+//the payload is only read, so one encoded buffer can be framed into any number of streams
+void EQOldStream::MakeEQPacket(uint16 opcode, const uchar* buffer, uint32 size, bool ack_req)
 {
-	int16 restore_op = 0x0000;
-
 	/************ PM STATE = NOT ACTIVE ************/
-	if(CheckState(CLOSED) || CheckState(CLOSING) || CheckState(DISCONNECTING) || !app || app && app->GetRawOpcode() == 0)
-	{
-		return;
-	}
-
-	// Agz:Moved this to after finish check
-	if(app == nullptr)
+	if(CheckState(CLOSED) || CheckState(CLOSING) || CheckState(DISCONNECTING) || opcode == 0)
 	{
-		//cout << "EQPacketManager::MakeEQPacket app == nullptr" << endl;
 		return;
 	}
-	bool bFragment= false; //This is set later on if fragseq should be increased at the end.
 
 	/************ IF opcode is == 0xFFFF it is a request for pure ack creation ************/
-	if(app->GetRawOpcode() == 0xFFFF)
+	if(opcode == 0xFFFF)
 	{
-		EQOldPacket *pack = new EQOldPacket();
+		EQOldPacket *pack = AllocPacket();
 		if (ack_req) {
 			pack->HDR.a1_ARQ = 1;
 			pack->dwARQ = SACK.dwARQ++;
@@ -2037,7 +2081,8 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req)
 	}
 
 	/************ CHECK PACKET MANAGER STATE ************/
-	int fragsleft = (app->size >> 9);
+	int fragsleft = (size >> 9);
+	const uchar* data = buffer;
 	
 	if(fragsleft)
 	{
@@ -2050,16 +2095,16 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req)
 	{
 		for (int i=0; i<=fragsleft; i++)
 		{
-			EQOldPacket *pack = new EQOldPacket();
+			EQOldPacket *pack = AllocPacket();
 			//IF NON PURE ACK THEN ALWAYS INCLUDE A ACKSEQ              // Agz: Not anymore... Always include ackseq if not a fragmented packet
 			if (i==0 && ack_req) // If this will be a fragmented packet, only include ackseq in first fragment
 				pack->HDR.a4_ASQ = 1;                                   // This is what the eq servers does
 
 			/************ Caculate the next ACKSEQ/acknumber ************/
 			/************ Check if its a static ackseq ************/
-			if( HI_BYTE(app->GetRawOpcode()) == 0x2000)
+			if( HI_BYTE(opcode) == 0x2000)
 			{
-				if(app->size == 15)
+				if(size == 15)
 					pack->dbASQ_low = 0xb2;
 				else
 					pack->dbASQ_low = 0xa1;
@@ -2087,8 +2132,8 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req)
 			}
 
 			/************ Check if this packet should contain op ************/
-			if (app->GetRawOpcode() && i == 0) {
-				pack->dwOpCode = app->GetRawOpcode();
+			if (i == 0) {
+				pack->dwOpCode = opcode;
 			}
 			/************ End opcode check ************/
 
@@ -2098,23 +2143,24 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req)
 			}
 			/************ END FRAGMENT CHECK ************/
 
-			if(app->size && app->pBuffer)
+			if(size && buffer)
 			{
 				if (Log.log_settings[Logs::Server_Client_Packet].is_category_enabled == 1){
-					EmuOpcode app_opcode = (*OpMgr)->EQToEmu(app->opcode);
+					EmuOpcode app_opcode = (*OpMgr)->EQToEmu(opcode);
 					if (app_opcode != OP_SpecialMesg && 
 						(!RuleB(EventLog, SkipCommonPacketLogging) ||
 						(RuleB(EventLog, SkipCommonPacketLogging) && app_opcode != OP_MobHealth && app_opcode != OP_MobUpdate && app_opcode != OP_ClientUpdate))){
-					Log.Out(Logs::General, Logs::Server_Client_Packet, "[%s - 0x%04x] [Size: %u]", OpcodeManager::EmuToName(app_opcode), app->opcode, app->size);
+					Log.Out(Logs::General, Logs::Server_Client_Packet, "[%s - 0x%04x] [Size: %u]", OpcodeManager::EmuToName(app_opcode), opcode, size);
 					}
 				}
 
 				if (Log.log_settings[Logs::Server_Client_Packet_With_Dump].is_category_enabled == 1){
-					EmuOpcode app_opcode = (*OpMgr)->EQToEmu(app->opcode);
+					EmuOpcode app_opcode = (*OpMgr)->EQToEmu(opcode);
 					if (app_opcode != OP_SpecialMesg && 
 						(!RuleB(EventLog, SkipCommonPacketLogging) ||
 						(RuleB(EventLog, SkipCommonPacketLogging) && app_opcode != OP_MobHealth && app_opcode != OP_MobUpdate && app_opcode != OP_ClientUpdate))){
-						Log.Out(Logs::General, Logs::Server_Client_Packet_With_Dump, "[%s - 0x%04x] [Size: %u] %s", OpcodeManager::EmuToName(app_opcode), app->opcode, app->size, DumpProtocolPacketToString(app).c_str());
+						EQProtocolPacket dump(opcode, buffer, size);
+						Log.Out(Logs::General, Logs::Server_Client_Packet_With_Dump, "[%s - 0x%04x] [Size: %u] %s", OpcodeManager::EmuToName(app_opcode), opcode, size, DumpProtocolPacketToString(&dump).c_str());
 					}
 				}
 
@@ -2123,7 +2169,7 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req)
 					// If this is the last packet in the fragment group
 					if(i == fragsleft) {
 						// Calculate remaining bytes for this fragment
-						pack->dwExtraSize = app->size-510-512*((app->size/512)-1);
+						pack->dwExtraSize = size-510-512*((size/512)-1);
 					}
 					else if(i == 0) {
 						pack->dwExtraSize = 510; // The first packet in a fragment group has 510 bytes for data
@@ -2137,12 +2183,11 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req)
 				}
 				else
 				{
-					pack->dwExtraSize = (uint16)app->size;
+					pack->dwExtraSize = (uint16)size;
 				}
 
-				pack->pExtra = new uchar[pack->dwExtraSize];
-				memcpy((void*)pack->pExtra, (void*)app->pBuffer, pack->dwExtraSize);
-				app->pBuffer += pack->dwExtraSize; //Increase counter
+				memcpy((void*)pack->pExtra, (const void*)data, pack->dwExtraSize);
+				data += pack->dwExtraSize; //Increase counter
 			} 
 			/************ End update timers ************/
 
@@ -2153,8 +2198,6 @@ void EQOldStream::MakeEQPacket(EQProtocolPacket* app, bool ack_req)
 		{
 			dwFragSeq++;
 		}
-		app->pBuffer -= app->size; //Restore ptr.
-		app->opcode = restore_op;
 			        
 	} //end if
 	MOutboundQueue.unlock();
@@ -2177,31 +2220,33 @@ void EQOldStream::QueuePacket(const EQApplicationPacket *p, bool ack_req)
 {
 //	ack_req = true;	// It's broke right now, dont delete this line till fix it. =P
 
-	Log.Out(Logs::General, Logs::World_Server, DumpPacketToString(p));
-
 	if(p == nullptr)
 		return;
 
+	//the dump is built before Log.Out can check the category, skip it when nobody is listening
+	if (Log.log_settings[Logs::World_Server].is_category_enabled == 1)
+		Log.Out(Logs::General, Logs::World_Server, DumpPacketToString(p));
+
+	//the caller keeps ownership, a broadcast queues the same packet into many streams
 	if(OpMgr == nullptr || *OpMgr == nullptr) {
 		Log.Out(Logs::Detail, Logs::Netcode, _L "Packet enqueued into a stream with no opcode manager, dropping.");
-		delete p;
 		return;
 	}
 	uint16 opcode = (*OpMgr)->EmuToEQ(p->emu_opcode);
-	EQProtocolPacket* pack2 = new EQProtocolPacket(opcode, p->pBuffer, p->size);
-	MakeEQPacket( pack2, ack_req);
-	delete pack2;
+	MakeEQPacket(opcode, p->pBuffer, p->size, ack_req);
 }
 
 void EQOldStream::FastQueuePacket(EQApplicationPacket **p, bool ack_req)
 {
-	Log.Out(Logs::General, Logs::World_Server, DumpPacketToString(*p));
 	EQApplicationPacket *pack=*p;
 	*p = nullptr;		//clear caller's pointer.. effectively takes ownership
 
 	if(pack == nullptr)
 		return;
 
+	if (Log.log_settings[Logs::World_Server].is_category_enabled == 1)
+		Log.Out(Logs::General, Logs::World_Server, DumpPacketToString(pack));
+
 	if(OpMgr == nullptr || *OpMgr == nullptr) {
 		Log.Out(Logs::Detail, Logs::Netcode, _L "Packet enqueued into a stream with no opcode manager, dropping.");
 		delete pack;
@@ -2215,13 +2260,10 @@ void EQOldStream::FastQueuePacket(EQApplicationPacket **p, bool ack_req)
 	if(p == nullptr)
 		return;
 
-	EQProtocolPacket* pack2 = new EQProtocolPacket(opcode, pack->pBuffer, pack->size);
-
 	if(pack->emu_opcode != OP_MobUpdate && pack->emu_opcode != OP_MobHealth && pack->emu_opcode != OP_HPUpdate)
 		Log.Out(Logs::Detail, Logs::Netcode, _L "Sending old opcode 0x%x" __L, opcode);
-	MakeEQPacket(pack2, ack_req);
+	MakeEQPacket(opcode, pack->pBuffer, pack->size, ack_req);
 	delete pack;
-	delete pack2;
 }
 
 EQApplicationPacket *EQOldStream::PopPacket()
@@ -2285,7 +2327,7 @@ void EQOldStream::OutboundQueueClear()
 	MOutboundQueue.lock();
 	while (!SendQueue.empty()) {
 		p = SendQueue.front();
-		safe_delete(p);
+		ReleasePacket(p);
 		SendQueue.pop_front();
 	}
 	SendQueue.clear();
@@ -2304,7 +2346,6 @@ void EQOldStream::SendPacketQueue(bool Block)
 	EQOldPacket* pack = 0;    
 	sockaddr_in to;	
 	uint32 size;
-	uchar* data;
 	memset((char *) &to, 0, sizeof(to));
 	to.sin_family = AF_INET;
 	to.sin_port = remote_port;
@@ -2313,8 +2354,7 @@ void EQOldStream::SendPacketQueue(bool Block)
 	/************ Should a pure ack be sent? ************/
 	if(GetState() == ESTABLISHED && (no_ack_sent_timer->Check(0) || keep_alive_timer->Check(0)))
 	{
-		EQProtocolPacket app(0xFFFF, nullptr, 0);
-		MakeEQPacket(&app, SACK.dwGSQcount > 45);
+		MakeEQPacket(0xFFFF, nullptr, 0, SACK.dwGSQcount > 45);
 	}
 	std::deque<EQOldPacket*>::iterator packit = SendQueue.begin();
 	while (packit != SendQueue.end() && !DataQueueFull()) {
@@ -2340,23 +2380,24 @@ void EQOldStream::SendPacketQueue(bool Block)
 
 			if (pack->HDR.a2_Closing && pack->HDR.a6_Closing) //Closing bits. Terminates the connection properly.
 			{
-				size = pack->ReturnPacket(&data, this);
-				sendto(listening_socket, (char*) data, size, 0, (sockaddr*) &to, sizeof(to));
+				size = pack->ReturnPacket(datagram, this);
+				sendto(listening_socket, (char*) datagram, size, 0, (sockaddr*) &to, sizeof(to));
 				dataflow += size;
-				safe_delete_array(data);
-				safe_delete(pack);
+				ReleasePacket(pack);
 				packit = SendQueue.erase(packit);
 				continue;
 			}
 			else //Send a packet!
 			{
-				size = pack->ReturnPacket(&data, this);
-				sendto(listening_socket, (char*) data, size, 0, (sockaddr*) &to, sizeof(to));
-				safe_delete_array(data);
+				size = pack->ReturnPacket(datagram, this);
+				sendto(listening_socket, (char*) datagram, size, 0, (sockaddr*) &to, sizeof(to));
 				dataflow += size;
+				packets_sent++;
+				if (pack->LastSent)
+					packets_resent++;
 				pack->LastSent = Timer::GetCurrentTime();
 				if (!pack->HDR.a1_ARQ) { //Wtf is this for?
-					safe_delete(pack);
+					ReleasePacket(pack);
 					packit = SendQueue.erase(packit);
 					continue;
 				}
@@ -2391,15 +2432,13 @@ void EQOldStream::FinalizePacketQueue()
 	to.sin_addr.s_addr = remote_ip;
 
 	uint32 size;
-	uchar* data;
 	// Set state to closing, and send off the finalized packet.
 	MakeClosePacket();
 	while (!SendQueue.empty()) {
 		p = SendQueue.front();
-		size = p->ReturnPacket(&data, this);
-		sendto(listening_socket, (char*) data, size, 0, (sockaddr*) &to, sizeof(to));
-		safe_delete_array(data);
-		safe_delete(p);
+		size = p->ReturnPacket(datagram, this);
+		sendto(listening_socket, (char*) datagram, size, 0, (sockaddr*) &to, sizeof(to));
+		ReleasePacket(p);
 		SendQueue.erase(SendQueue.begin());
 	}
 	// ************ Connection finished ************ //
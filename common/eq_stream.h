@@ -69,6 +69,9 @@ template <typename type>                    // HI_LOSWAPlong
 type  HI_LOSWAPlong (type a) {return (LO_WORD(a)<<16) | (HIWORD(a)>>16);}  
 
 #define EQOLDSTREAM_OUTBOUD_THRESHOLD 9
+#define EQOLDSTREAM_MAX_FRAGMENT 513								//largest payload MakeEQPacket puts in one datagram, the last fragment of a group can run one past 512
+#define EQOLDSTREAM_MAX_DATAGRAM (EQOLDSTREAM_MAX_FRAGMENT + 39)	//payload plus the largest header ReturnPacket writes
+#define EQOLDSTREAM_PACKET_POOL 256								//free outbound packets kept per stream
 
 // Added struct
 typedef struct
@@ -444,7 +447,7 @@ class EQOldStream : public EQStreamInterface {
 				
 		// parce/make packets
 		void ParceEQPacket(uint16 dwSize, uchar* pPacket);
-		void MakeEQPacket(EQProtocolPacket* app, bool ack_req=true); //Make a fragment eq packet and put them on the SQUEUE/RSQUEUE
+		void MakeEQPacket(uint16 opcode, const uchar* buffer, uint32 size, bool ack_req=true); //Make a fragment eq packet and put them on the SQUEUE/RSQUEUE
 		void MakeClosePacket();
 		// Add ack to packet if requested
 		void AddAck(EQOldPacket *pack)
@@ -494,6 +497,12 @@ class EQOldStream : public EQStreamInterface {
 		void CheckBufferedPackets();
 		EQRawApplicationPacket *MakeApplicationPacket(EQOldPacket *p);
 
+		//outbound packets are recycled with their payload buffer, so a busy stream stops allocating
+		EQOldPacket *AllocPacket();
+		void ReleasePacket(EQOldPacket *pack);
+		std::vector<EQOldPacket *> packet_pool;
+		uchar datagram[EQOLDSTREAM_MAX_DATAGRAM];	//SendPacketQueue serializes here, sendto copies it out
+
 		FragmentGroupList fragment_group_list;
 		std::vector<EQOldPacket *> buffered_packets; // Buffer of incoming packets
 
@@ -521,6 +530,14 @@ class EQOldStream : public EQStreamInterface {
 		int32	datarate_tic;	// bytes/100ms
 		int32	dataflow;
 
+		//transport counters, reported by loadgen
+		uint32	packets_sent;
+		uint32	packets_resent;
+		uint32	packets_recv;
+		uint32	ack_rtt_total;
+		uint32	ack_rtt_max;
+		uint32	ack_rtt_count;
+
 	public:
 		//interface used by application (EQStreamInterface)
 		virtual void QueuePacket(const EQApplicationPacket *p, bool ack_req=true);
@@ -560,6 +577,11 @@ class EQOldStream : public EQStreamInterface {
 		float			GetDataRate()					{ return (float)datarate_sec / 1024; } // conversion back to kb/second
 		inline bool		DataQueueFull()					{ return (dataflow > datarate_sec); }
 		inline int32	GetDataFlow()					{ return dataflow; }
+		uint32			GetPacketsSent() const			{ return packets_sent; }
+		uint32			GetPacketsResent() const		{ return packets_resent; }
+		uint32			GetPacketsRecv() const			{ return packets_recv; }
+		uint32			GetAckRTTMax() const			{ return ack_rtt_max; }
+		uint32			GetAckRTTAverage() const		{ return ack_rtt_count ? ack_rtt_total / ack_rtt_count : 0; }
 		ACK_INFO    SACK; //Server -> client info.
 		ACK_INFO    CACK; //Client -> server info.
 		uint16       dwLastCACK;
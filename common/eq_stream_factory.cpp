@@ -1,6 +1,7 @@
 #include "global_define.h"
 #include "eqemu_logsys.h"
 #include "eq_stream_factory.h"
+#include "event_signal.h"
 
 #ifdef _WINDOWS
 	#include <winsock.h>
@@ -66,6 +67,7 @@ EQStreamFactory::EQStreamFactory(EQStreamType type, int port, uint32 timeout)
 	StreamType=type;
 	Port=port;
 	sock=-1;
+	WakeSignal=nullptr;
 }
 
 void EQStreamFactory::Close()
@@ -225,6 +227,8 @@ timeval sleep_time;
 						s->AddBytesRecv(length);
 						s->Process(buffer,length);
 						s->SetLastPacketTime(Timer::GetCurrentTime());
+						if (WakeSignal)
+							WakeSignal->Signal();	//only new streams wake the zone loop, see zone/net.cpp
 					}
 					else {
 						EQOldStream *s = new EQOldStream(from, sock);
@@ -235,6 +239,8 @@ timeval sleep_time;
 						//s->AddBytesRecv(length);
 						s->SetLastPacketTime(Timer::GetCurrentTime());
 						s->ReceiveData(buffer,length);
+						if (WakeSignal)
+							WakeSignal->Signal();
 					}
 
 					MStreams.unlock();
@@ -10,6 +10,7 @@
 #include "../common/timeoutmgr.h"
 
 class EQStream;
+class EventSignal;
 class Timer;
 
 class EQStreamFactory : private Timeoutable {
@@ -44,8 +45,10 @@ class EQStreamFactory : private Timeoutable {
 
 		uint32 stream_timeout;
 
+		EventSignal *WakeSignal;	//signalled when a new stream is queued for Pop()/PopOld()
+
 	public:
-		EQStreamFactory(EQStreamType type, uint32 timeout = 45000) : Timeoutable(5000), stream_timeout(timeout) { ReaderRunning=false; WriterRunning=false; StreamType=type; sock=-1; }
+		EQStreamFactory(EQStreamType type, uint32 timeout = 45000) : Timeoutable(5000), stream_timeout(timeout) { ReaderRunning=false; WriterRunning=false; StreamType=type; sock=-1; WakeSignal=nullptr; }
 		EQStreamFactory(EQStreamType type, int port, uint32 timeout = 45000);
 
 		EQStream *Pop();
@@ -64,6 +67,8 @@ class EQStreamFactory : private Timeoutable {
 		void StopReader() { MReaderRunning.lock(); ReaderRunning=false; MReaderRunning.unlock(); }
 		void StopWriter() { MWriterRunning.lock(); WriterRunning=false; MWriterRunning.unlock(); WriterWork.Signal(); }
 		void SignalWriter() { WriterWork.Signal(); }
+		//signalled from the reader thread after every datagram it hands to a stream
+		void SetWakeSignal(EventSignal *signal) { WakeSignal=signal; }
 };
 
 #endif
@@ -15,6 +15,7 @@ typedef enum {
 } EQStreamState;
 
 class EQApplicationPacket;
+class EQBroadcastPacket;
 
 class EQStreamInterface {
 public:
@@ -22,6 +23,8 @@ public:
 
 	virtual void QueuePacket(const EQApplicationPacket *p, bool ack_req=true) = 0;
 	virtual void FastQueuePacket(EQApplicationPacket **p, bool ack_req=true) = 0;
+	//the same packet to many streams, streams that know their encoding share it (eq_broadcast_packet.cpp)
+	virtual void QueueBroadcast(EQBroadcastPacket *p, bool ack_req=true);
 	virtual EQApplicationPacket *PopPacket() = 0;
 	virtual void Close() = 0;
 
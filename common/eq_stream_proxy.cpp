@@ -1,6 +1,7 @@
 
 #include "global_define.h"
 #include "eq_stream_proxy.h"
+#include "eq_broadcast_packet.h"
 #include "eq_stream.h"
 #include "struct_strategy.h"
 
@@ -54,6 +55,12 @@ void EQStreamProxy::FastQueuePacket(EQApplicationPacket **p, bool ack_req) {
 	m_structs->Encode(p, m_stream, ack_req);
 }
 
+void EQStreamProxy::QueueBroadcast(EQBroadcastPacket *p, bool ack_req) {
+	if(p == nullptr)
+		return;
+	p->Queue(m_structs, m_stream, ack_req);
+}
+
 EQApplicationPacket *EQStreamProxy::PopPacket() {
 	EQApplicationPacket *pack = m_stream->PopPacket();
 	if(pack == nullptr)
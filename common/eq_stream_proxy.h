@@ -21,6 +21,7 @@ public:
 	//EQStreamInterface:
 	virtual void QueuePacket(const EQApplicationPacket *p, bool ack_req=true);
 	virtual void FastQueuePacket(EQApplicationPacket **p, bool ack_req=true);
+	virtual void QueueBroadcast(EQBroadcastPacket *p, bool ack_req=true);
 	virtual EQApplicationPacket *PopPacket();
 	virtual void Close();
 	virtual uint32 GetRemoteIP() const;
@@ -0,0 +1,110 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "global_define.h"
+#include "event_signal.h"
+
+#ifndef _WINDOWS
+	#include <fcntl.h>
+	#include <poll.h>
+	#include <unistd.h>
+	#ifdef __linux__
+		#include <sys/eventfd.h>
+	#endif
+#endif
+
+EventSignal::EventSignal()
+:	pending(false)
+{
+#ifdef _WINDOWS
+	event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+#elif defined(__linux__)
+	read_fd = write_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+	int fds[2];
+	read_fd = write_fd = -1;
+	if (pipe(fds) == 0) {
+		fcntl(fds[0], F_SETFL, O_NONBLOCK);
+		fcntl(fds[1], F_SETFL, O_NONBLOCK);
+		read_fd = fds[0];
+		write_fd = fds[1];
+	}
+#endif
+}
+
+EventSignal::~EventSignal() {
+#ifdef _WINDOWS
+	if (event)
+		CloseHandle(event);
+#else
+	if (write_fd != read_fd && write_fd >= 0)
+		close(write_fd);
+	if (read_fd >= 0)
+		close(read_fd);
+#endif
+}
+
+void EventSignal::Signal() {
+	if (pending.exchange(true))
+		return;
+
+#ifdef _WINDOWS
+	if (event)
+		SetEvent(event);
+#elif defined(__linux__)
+	uint64 one = 1;
+	if (write_fd >= 0 && write(write_fd, &one, sizeof(one)) < 0) {
+		//only fails when the counter is full, which still wakes the reader
+	}
+#else
+	char one = 1;
+	if (write_fd >= 0 && write(write_fd, &one, 1) < 0) {
+		//a full pipe wakes the reader just the same
+	}
+#endif
+}
+
+bool EventSignal::Wait(uint32 timeout_ms) {
+#ifdef _WINDOWS
+	if (!event) {
+		Sleep(timeout_ms);
+		return false;
+	}
+	if (WaitForSingleObject(event, timeout_ms) != WAIT_OBJECT_0)
+		return false;
+#else
+	if (read_fd < 0) {
+		usleep(timeout_ms * 1000);
+		return false;
+	}
+
+	struct pollfd pfd;
+	pfd.fd = read_fd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	if (poll(&pfd, 1, timeout_ms) <= 0)
+		return false;
+
+	char buf[64];
+	while (read(read_fd, buf, sizeof(buf)) > 0)
+		;
+#endif
+	//cleared after the drain, a signal landing in between is for work the caller is about to do anyway
+	pending = false;
+	return true;
+}
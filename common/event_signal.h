@@ -0,0 +1,59 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef EVENT_SIGNAL_H
+#define EVENT_SIGNAL_H
+
+/*
+	Lets network threads wake a main loop that is waiting for its next timer.
+
+	A signal raised while nobody waits is kept, so the next Wait() returns at
+	once; any number of signals between two waits wake it once. Only the first
+	signal after a wait reaches the kernel, the rest just see the pending flag.
+
+	Linux uses an eventfd, other unix a non blocking pipe and windows an auto
+	reset event.
+*/
+
+#include "types.h"
+
+#ifdef _WINDOWS
+	#include <windows.h>
+#endif
+
+#include <atomic>
+
+class EventSignal
+{
+public:
+	EventSignal();
+	~EventSignal();
+
+	void	Signal();	//safe from any thread
+	bool	Wait(uint32 timeout_ms);	//true when woken by a signal, false on timeout
+
+private:
+	std::atomic<bool> pending;
+#ifdef _WINDOWS
+	HANDLE	event;
+#else
+	int	read_fd;
+	int	write_fd;	//the same descriptor as read_fd for an eventfd
+#endif
+};
+
+#endif
@@ -74,6 +74,24 @@ void CoutTimestamp(bool ms) {
 }
 
 
+uint64 GetResidentMemory() {
+#if defined(_WINDOWS) || defined(FREEBSD) || defined(DARWIN)
+	return 0;
+#else
+	FILE *f = fopen("/proc/self/statm", "r");
+	if (f == nullptr)
+		return 0;
+
+	unsigned long size = 0, resident = 0;
+	int read = fscanf(f, "%lu %lu", &size, &resident);
+	fclose(f);
+	if (read != 2)
+		return 0;
+
+	return static_cast<uint64>(resident) * sysconf(_SC_PAGESIZE);
+#endif
+}
+
 int32 filesize(FILE* fp) {
 #ifdef _WINDOWS
 	return _filelength(_fileno(fp));
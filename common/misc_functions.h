@@ -46,6 +46,7 @@
 	}
 
 int32	filesize(FILE* fp);
+uint64	GetResidentMemory();	//bytes, 0 where the platform is not supported
 uint32	ResolveIP(const char* hostname, char* errbuf = 0);
 bool	ParseAddress(const char* iAddress, uint32* oIP, uint16* oPort, char* errbuf = 0);
 void	CoutTimestamp(bool ms = true);
@@ -0,0 +1,132 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_NPC_TYPES_H
+#define _EQEMU_NPC_TYPES_H
+
+#include "types.h"
+#include "eq_constants.h"
+
+/*
+	One npc_types row. Lives in the npc_types shared memory segment, so it
+	must stay plain data with no pointers.
+*/
+#pragma pack(1)
+struct NPCType
+{
+	char	name[64];
+	char	lastname[70]; 
+	int32	cur_hp;
+	int32	max_hp; 
+	float	size;
+	float	runspeed;
+	float	walkspeed;
+	uint8	gender;
+	uint16	race;
+	uint8	class_;
+	uint8	bodytype;	// added for targettype support
+	uint8	deity;		//not loaded from DB
+	uint8	level;
+	uint32	npc_id;
+	uint8	texture;
+	uint8	helmtexture;
+	uint32	loottable_id;
+	uint32	npc_spells_id;
+	uint32	npc_spells_effects_id;
+	int32	npc_faction_id;
+	uint32	merchanttype;
+	uint32	trap_template;
+	uint8	light;
+	uint32	AC;
+	uint32	Mana;	//not loaded from DB
+	uint32	ATK;	//not loaded from DB
+	uint32	STR;
+	uint32	STA;
+	uint32	DEX;
+	uint32	AGI;
+	uint32	INT;
+	uint32	WIS;
+	uint32	CHA;
+	int32	MR;
+	int32	FR;
+	int32	CR;
+	int32	PR;
+	int32	DR;
+	int32	Corrup;
+	int32   PhR;
+	uint8	haircolor;
+	uint8	beardcolor;
+	uint8	eyecolor1;			// the eyecolors always seem to be the same, maybe left and right eye?
+	uint8	eyecolor2;
+	uint8	hairstyle;
+	uint8	luclinface;			//
+	uint8	beard;				//
+	uint32	armor_tint[_MaterialCount];
+	uint32	min_dmg;
+	uint32	max_dmg;
+	int16	attack_count;
+	char	special_abilities[512];
+	uint16	d_melee_texture1;
+	uint16	d_melee_texture2;
+	char	ammo_idfile[30];
+	uint8	prim_melee_type;
+	uint8	sec_melee_type;
+	uint8	ranged_type;
+	int32	hp_regen;
+	int32	mana_regen;
+	int32	aggroradius; // added for AI improvement - neotokyo
+	int32	assistradius; // assist radius, defaults to aggroradis if not set
+	uint8	see_invis;			// See Invis flag added
+	bool	see_invis_undead;	// See Invis vs. Undead flag added
+	bool	see_hide;
+	bool	see_improved_hide;
+	bool	qglobal;
+	bool	npc_aggro;
+	uint8	spawn_limit;	//only this many may be in zone at a time (0=no limit)
+	uint8	mount_color;	//only used by horse class
+	uint8	attack_delay;	//delay between attacks in 10ths of a second
+	int		accuracy_rating;	//10 = 1% accuracy
+	int		avoidance_rating;	//10 = 1% avoidance
+	bool	findable;		//can be found with find command
+	bool	trackable;
+	int16	slow_mitigation;	
+	uint8	maxlevel;
+	uint32	scalerate;
+	bool	private_corpse;
+	bool	unique_spawn_by_name;
+	bool	underwater;
+	uint32	emoteid;
+	float	spellscale;
+	float	healscale;
+	bool	no_target_hotkey;
+	bool	raid_target;
+	uint8 	probability;
+	uint32  combat_hp_regen;
+	uint32  combat_mana_regen;
+	bool	aggro_pc;
+	uint8	armtexture;
+	uint8	bracertexture;
+	uint8	handtexture;
+	uint8	legtexture;
+	uint8	feettexture;
+	uint8	chesttexture;
+	float	ignore_distance;
+};
+#pragma pack()
+
+#endif
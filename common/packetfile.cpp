@@ -5,10 +5,11 @@
 #endif
 
 #include <errno.h>
+#include <stddef.h>
 #include <string.h>
 #include <time.h>
 #include "packetfile.h"
-#include "../common/eq_opcodes.h"
+#include "../common/emu_opcodes.h"
 #include "../common/eq_packet_structs.h"
 #include "../common/misc.h"
 #include <map>
@@ -30,7 +31,7 @@ bool PacketFileWriter::SetPacketStamp(const char *name, uint32 stamp) {
 		return(false);
 	}
 
-	unsigned long magic = 0;
+	uint32 magic = 0;
 
 	if(fread(&magic, sizeof(magic), 1, in) != 1) {
 		fprintf(stderr, "Error reading header from packet file: %s\n", strerror(errno));
@@ -40,8 +41,7 @@ bool PacketFileWriter::SetPacketStamp(const char *name, uint32 stamp) {
 
 	PacketFileReader *ret = NULL;
 	if(magic == OLD_PACKET_FILE_MAGIC) {
-		OldPacketFileHeader *pos = 0;
-		uint32 stamp_pos = (uint32) &pos->packet_file_stamp;
+		long stamp_pos = offsetof(OldPacketFileHeader, packet_file_stamp);
 		fseek(in, stamp_pos, SEEK_SET);
 		OldPacketFileHeader hdr;
 		hdr.packet_file_stamp = stamp;
@@ -51,8 +51,7 @@ bool PacketFileWriter::SetPacketStamp(const char *name, uint32 stamp) {
 			return(false);
 		}
 	} else if(magic == PACKET_FILE_MAGIC) {
-		PacketFileHeader *pos = 0;
-		uint32 stamp_pos = (uint32) &pos->packet_file_stamp;
+		long stamp_pos = offsetof(PacketFileHeader, packet_file_stamp);
 		fseek(in, stamp_pos, SEEK_SET);
 		PacketFileHeader hdr;
 		hdr.packet_file_stamp = stamp;
@@ -177,7 +176,7 @@ PacketFileReader *PacketFileReader::OpenPacketFile(const char *name) {
 		return(NULL);
 	}
 
-	unsigned long magic = 0;
+	uint32 magic = 0;
 
 	if(fread(&magic, sizeof(magic), 1, in) != 1) {
 		fprintf(stderr, "Error reading header to packet file: %s\n", strerror(errno));
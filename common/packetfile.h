@@ -4,6 +4,11 @@
 #include "../common/types.h"
 #include <stdio.h>
 #include <time.h>
+#ifdef WIN32
+	#include <winsock2.h>
+#else
+	#include <sys/time.h>
+#endif
 //#include <zlib.h>
 
 //constants used in the packet file header
@@ -41,8 +46,8 @@ struct PacketFileSection {
 #define TO_SERVER_FLAG 0x01
 #define SetToClient(pfs) pfs.flags = pfs.flags&~TO_SERVER_FLAG
 #define SetToServer(pfs) pfs.flags = pfs.flags|TO_SERVER_FLAG
-#define IsToClient(pfs) (pfs.flags&TO_SERVER_FLAG == 0)
-#define IsToServer(pfs) (pfs.flags&TO_SERVER_FLAG != 0)
+#define IsToClient(pfs) ((pfs.flags&TO_SERVER_FLAG) == 0)
+#define IsToServer(pfs) ((pfs.flags&TO_SERVER_FLAG) != 0)
 
 
 class PacketFileWriter {
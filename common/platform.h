@@ -13,7 +13,8 @@ enum EQEmuExePlatform
 	ExePlatformLaunch,
 	ExePlatformSharedMemory,
 	ExePlatformClientImport,
-	ExePlatformClientExport
+	ExePlatformClientExport,
+	ExePlatformLoadGen
 };
 
 void RegisterExecutablePlatform(EQEmuExePlatform p);
@@ -81,8 +81,13 @@ int64 RDTSC_Timer::rdtsc() {
 	//fall back to get time of day
 	timeval t;
 	gettimeofday(&t, nullptr);
-	res = ((int64)t.tv_sec) * 1000 + t.tv_usec;
+	res = ((int64)t.tv_sec) * 1000000 + t.tv_usec;
 #endif
+#else
+	//no rdtsc on this platform, microseconds from time of day
+	timeval t;
+	gettimeofday(&t, nullptr);
+	res = ((int64)t.tv_sec) * 1000000 + t.tv_usec;
 #endif
 	return(res);
 }
@@ -33,6 +33,7 @@ RULE_INT ( Character, EmptyCorpseDecayTimeMS, 10800000 ) // 3 hours
 RULE_INT ( Character, CorpseResTimeMS, 10800000 ) // time before cant res corpse(3 hours)
 RULE_INT ( Character, DuelCorpseResTimeMS, 600000 ) // time before cant res corpse after a duel (10 minutes)
 RULE_INT ( Character, CorpseOwnerOnlineTimeMS, 30000 ) // how often corpse will check if its owner is online
+RULE_INT ( Character, CorpseSaveDelayMS, 1000 ) // how often changed player corpses are written to the db together, 0 writes each change at once
 RULE_BOOL( Character, LeaveCorpses, true )
 RULE_BOOL( Character, LeaveNakedCorpses, true )
 RULE_INT ( Character, MaxDraggedCorpses, 2 )
@@ -148,6 +149,7 @@ RULE_INT (World, TellQueueSize, 20)
 RULE_BOOL (World, UseDBUpdate, false) //Automatic Database Upgrade Script
 RULE_BOOL (World, AdjustRespawnTimes, true) //Determines if spawntimes with a boot time variable take effect or not. Set to false in the db for emergency patches.
 RULE_INT (World, BootHour, 0) // Sets the in-game hour world will set when it first boots. 0-24 are valid options, where 0 disables this rule.
+RULE_INT (World, MetricsPort, 0) // Port on 127.0.0.1 serving world and zone counters as plain text for scraping, 0 disables.
 RULE_CATEGORY_END()
 
 RULE_CATEGORY( Zone )
@@ -180,6 +182,10 @@ RULE_REAL ( Zone, GroupEXPRange, 500 )
 RULE_BOOL ( Zone, IdleWhenEmpty, true) // After timer is expired, if zone is empty it will idle. Boat zones are excluded, as this will break boat functionality.
 RULE_INT ( Zone, IdleTimer, 600000) // 10 minutes
 RULE_INT ( Zone, BoatDistance, 50) //In zones where boat name is not set in the PP, this is how far away from the boat the client must be to move them to the boat's current location.
+RULE_INT ( Zone, ProfileReportInterval, 60000) // ms between tick profile summaries sent to world for #profile zones, 0 disables.
+RULE_INT ( Zone, OpcodeStatsLogInterval, 0) // ms between per opcode packet stats dumps to the zone log, 0 disables.
+RULE_INT ( Zone, MetricsReportInterval, 15000) // ms between counter reports sent to world for the metrics endpoint, 0 disables.
+RULE_INT ( Zone, MaxLoopWaitMS, 50) // Longest the main loop waits for its next timer when no packet wakes it, 0 goes back to a fixed sleep between passes.
 RULE_CATEGORY_END()
 
 RULE_CATEGORY( AlKabor )
@@ -404,6 +410,7 @@ RULE_INT ( Aggro, PetSpellAggroMod, 10 )
 RULE_REAL ( Aggro, TunnelVisionAggroMod, 0.75 ) //people not currently the top hate generate this much hate on a Tunnel Vision mob
 RULE_INT ( Aggro, IntAggroThreshold, 75 ) // Int <= this will aggro regardless of level difference.
 RULE_BOOL ( Aggro, UseLevelAggro, true) // Level 18+ and Undead will aggro regardless of level difference. (this will disabled Rule:IntAggroThreshold if set to true)
+RULE_INT ( Aggro, ScanThreads, 0 ) // Threads besides the main one that run the range search of npc to npc aggro scans before each mob pass, 0 leaves each scan to search on its own.
 RULE_CATEGORY_END()
 
 RULE_CATEGORY ( Chat )
@@ -464,6 +471,12 @@ RULE_CATEGORY( Console )
 RULE_INT ( Console, SessionTimeOut, 600000 )	// Amount of time in ms for the console session to time out
 RULE_CATEGORY_END()
 
+RULE_CATEGORY( Lua )
+RULE_INT ( Lua, GCStepSize, 0 ) // Size of the collector steps the zone loop runs between passes, the collector does not run on its own while this is set. 0 leaves it to Lua.
+RULE_INT ( Lua, GCStepBudgetMS, 2 ) // ms the zone loop may spend stepping the collector after each pass.
+RULE_INT ( Lua, EventInstructionLimit, 0 ) // VM instructions a single event may run before it is aborted with an error, 0 disables.
+RULE_CATEGORY_END()
+
 RULE_CATEGORY( QueryServ )
 RULE_BOOL( QueryServ, PlayerLogChat, false) // Logs Player Chat 
 RULE_BOOL( QueryServ, PlayerLogTrades, false) // Logs Player Trades
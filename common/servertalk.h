@@ -84,6 +84,9 @@
 #define ServerOP_DepopPlayerCorpse	0x0065
 #define ServerOP_RequestTellQueue	0x0066 // client asks for it's tell queues
 #define ServerOP_ChangeSharedMem	0x0067
+#define ServerOP_ZoneProfile		0x0068	// periodic tick profile summary from a zone
+#define ServerOP_ZoneProfileRequest	0x0069	// #profile zones, world answers with the slowest zones
+#define ServerOP_ZoneMetrics		0x006A	// periodic counters from a zone for the world metrics endpoint
 
 #define ServerOP_RaidAdd			0x0100 //in use
 #define ServerOP_RaidRemove			0x0101 //in use
@@ -559,6 +562,45 @@ struct ServerUptime_Struct {
 	char	adminname[64];
 };
 
+struct ServerZoneProfile_Struct {
+	uint32	zoneid;
+	uint32	instanceid;
+	uint32	clients;
+	uint32	samples;			// ticks in the window
+	uint32	tick_p50;			// microseconds
+	uint32	tick_p99;
+	uint32	tick_max;
+	uint32	worst_phase_p99;
+	char	worst_phase[32];
+};
+
+struct ServerZoneProfileRequest_Struct {
+	char	adminname[64];
+	uint32	count;
+};
+
+// packet and query counters are running totals since the zone booted
+struct ServerZoneMetrics_Struct {
+	uint32	zoneid;
+	uint16	instanceid;
+	uint16	unused;
+	uint32	tick_p50;			// microseconds over the profiler window
+	uint32	tick_p99;
+	uint32	tick_max;
+	uint32	clients;
+	uint32	npcs;
+	uint32	mobs;
+	uint32	corpses;
+	uint32	db_query_max_us;	// since the previous report
+	uint64	packets_in;
+	uint64	bytes_in;
+	uint64	packets_out;
+	uint64	bytes_out;
+	uint64	db_queries;
+	uint64	db_query_time_us;
+	uint64	rss_bytes;
+};
+
 struct ServerPetitionUpdate_Struct {
 	uint32 petid; // Petition Number
 	uint8 status; // 0x00 = ReRead DB -- 0x01 = Checkout -- More? Dunno... lol
@@ -835,6 +877,13 @@ struct ServerRaidGeneralAction_Struct {
 	uint32 rid;
 	uint32 gid;
 	char playername[64];
+	//the member as the sending zone now has it, so other zones can apply the change in memory
+	uint32 charid;
+	uint8 _class;
+	uint8 level;
+	uint8 isgroupleader;
+	uint8 israidleader;
+	uint8 islooter;
 };
 
 struct ServerRaidGroupAction_Struct { //add / remove depends on opcode.
@@ -18,6 +18,7 @@
 #include "eqemu_exception.h"
 #include "loottable.h"
 #include "faction.h"
+#include "npc_types.h"
 #include "features.h"
 
 #pragma warning( disable : 4305 4309 4244 4800 )
@@ -774,6 +775,273 @@ bool SharedDatabase::LoadNPCFactionLists(const std::string &prefix) {
 	return true;
 }
 
+std::string SharedDatabase::GetNPCTypesQuery() {
+	return "SELECT npc_types.id, npc_types.name, npc_types.level, npc_types.race, "
+		"npc_types.class, npc_types.hp, npc_types.mana, npc_types.gender, "
+		"npc_types.texture, npc_types.helmtexture, npc_types.size, "
+		"npc_types.loottable_id, npc_types.merchant_id, "
+		"npc_types.trap_template, "
+		"npc_types.STR, npc_types.STA, npc_types.DEX, npc_types.AGI, npc_types._INT, "
+		"npc_types.WIS, npc_types.CHA, npc_types.MR, npc_types.CR, npc_types.DR, "
+		"npc_types.FR, npc_types.PR, npc_types.Corrup, npc_types.PhR, "
+		"npc_types.mindmg, npc_types.maxdmg, npc_types.attack_count, npc_types.special_abilities, "
+		"npc_types.npc_spells_id, npc_types.npc_spells_effects_id, npc_types.d_melee_texture1, "
+		"npc_types.d_melee_texture2, npc_types.ammo_idfile, npc_types.prim_melee_type, "
+		"npc_types.sec_melee_type, npc_types.ranged_type, npc_types.runspeed, npc_types.findable, "
+		"npc_types.trackable, npc_types.hp_regen_rate, npc_types.mana_regen_rate, "
+		"npc_types.aggroradius, npc_types.assistradius, npc_types.bodytype, npc_types.npc_faction_id, "
+		"npc_types.face, npc_types.luclin_hairstyle, npc_types.luclin_haircolor, "
+		"npc_types.luclin_eyecolor, npc_types.luclin_eyecolor2, npc_types.luclin_beardcolor,"
+		"npc_types.luclin_beard, npc_types.armortint_id, "
+		"npc_types.armortint_red, npc_types.armortint_green, npc_types.armortint_blue, "
+		"npc_types.see_invis, npc_types.see_invis_undead, npc_types.lastname, "
+		"npc_types.qglobal, npc_types.AC, npc_types.npc_aggro, npc_types.spawn_limit, "
+		"npc_types.see_hide, npc_types.see_improved_hide, npc_types.ATK, npc_types.Accuracy, "
+		"npc_types.Avoidance, npc_types.slow_mitigation, npc_types.maxlevel, npc_types.scalerate, "
+		"npc_types.private_corpse, npc_types.unique_spawn_by_name, npc_types.underwater, "
+		"npc_types.emoteid, npc_types.spellscale, npc_types.healscale, npc_types.no_target_hotkey,"
+		"npc_types.raid_target, npc_types.attack_delay, npc_types.walkspeed, npc_types.combat_hp_regen, "
+		"npc_types.combat_mana_regen, npc_types.light, npc_types.aggro_pc, "
+		"npc_types.armtexture, npc_types.bracertexture, npc_types.handtexture, npc_types.legtexture, "
+		"npc_types.feettexture, npc_types.chesttexture, npc_types.ignore_distance, "
+		"npc_types_tint.id, "
+		"npc_types_tint.red1h, npc_types_tint.grn1h, npc_types_tint.blu1h, "
+		"npc_types_tint.red2c, npc_types_tint.grn2c, npc_types_tint.blu2c, "
+		"npc_types_tint.red3a, npc_types_tint.grn3a, npc_types_tint.blu3a, "
+		"npc_types_tint.red4b, npc_types_tint.grn4b, npc_types_tint.blu4b, "
+		"npc_types_tint.red5g, npc_types_tint.grn5g, npc_types_tint.blu5g, "
+		"npc_types_tint.red6l, npc_types_tint.grn6l, npc_types_tint.blu6l, "
+		"npc_types_tint.red7f, npc_types_tint.grn7f, npc_types_tint.blu7f, "
+		"npc_types_tint.red8x, npc_types_tint.grn8x, npc_types_tint.blu8x, "
+		"npc_types_tint.red9x, npc_types_tint.grn9x, npc_types_tint.blu9x "
+		"FROM npc_types LEFT JOIN npc_types_tint ON npc_types_tint.id = npc_types.armortint_id";
+}
+
+void SharedDatabase::FillNPCType(NPCType *npc, MySQLRequestRow &row) {
+	memset(npc, 0, sizeof(NPCType));
+
+	npc->npc_id = atoi(row[0]);
+
+	strn0cpy(npc->name, row[1], 50);
+
+	npc->level = atoi(row[2]);
+	npc->race = atoi(row[3]);
+	npc->class_ = atoi(row[4]);
+	npc->max_hp = atoi(row[5]);
+	npc->cur_hp = npc->max_hp;
+	npc->Mana = atoi(row[6]);
+	npc->gender = atoi(row[7]);
+	npc->texture = atoi(row[8]);
+	npc->helmtexture = atoi(row[9]);
+	npc->size = atof(row[10]);
+	npc->loottable_id = atoi(row[11]);
+	npc->merchanttype = atoi(row[12]);
+	npc->trap_template = atoi(row[13]);
+	npc->STR = atoi(row[14]);
+	npc->STA = atoi(row[15]);
+	npc->DEX = atoi(row[16]);
+	npc->AGI = atoi(row[17]);
+	npc->INT = atoi(row[18]);
+	npc->WIS = atoi(row[19]);
+	npc->CHA = atoi(row[20]);
+	npc->MR = atoi(row[21]);
+	npc->CR = atoi(row[22]);
+	npc->DR = atoi(row[23]);
+	npc->FR = atoi(row[24]);
+	npc->PR = atoi(row[25]);
+	npc->Corrup = atoi(row[26]);
+	npc->PhR = atoi(row[27]);
+	npc->min_dmg = atoi(row[28]);
+	npc->max_dmg = atoi(row[29]);
+	npc->attack_count = atoi(row[30]);
+	if (row[31] != nullptr)
+		strn0cpy(npc->special_abilities, row[31], 512);
+	else
+		npc->special_abilities[0] = '\0';
+	npc->npc_spells_id = atoi(row[32]);
+	npc->npc_spells_effects_id = atoi(row[33]);
+	npc->d_melee_texture1 = atoi(row[34]);
+	npc->d_melee_texture2 = atoi(row[35]);
+	strn0cpy(npc->ammo_idfile, row[36], 30);
+	npc->prim_melee_type = atoi(row[37]);
+	npc->sec_melee_type = atoi(row[38]);
+	npc->ranged_type = atoi(row[39]);
+	npc->runspeed= atof(row[40]);
+	npc->findable = atoi(row[41]) == 0? false : true;
+	npc->trackable = atoi(row[42]) == 0? false : true;
+	npc->hp_regen = atoi(row[43]);
+	npc->mana_regen = atoi(row[44]);
+
+	// set defaultvalue for aggroradius
+	npc->aggroradius = (int32)atoi(row[45]);
+	if (npc->aggroradius <= 0)
+		npc->aggroradius = 70;
+
+	npc->assistradius = (int32)atoi(row[46]);
+	if (npc->assistradius <= 0)
+		npc->assistradius = npc->aggroradius;
+
+	if (row[47] && strlen(row[47]))
+		npc->bodytype = (uint8)atoi(row[47]);
+	else
+		npc->bodytype = 0;
+
+	npc->npc_faction_id = atoi(row[48]);
+
+	npc->luclinface = atoi(row[49]);
+	npc->hairstyle = atoi(row[50]);
+	npc->haircolor = atoi(row[51]);
+	npc->eyecolor1 = atoi(row[52]);
+	npc->eyecolor2 = atoi(row[53]);
+	npc->beardcolor = atoi(row[54]);
+	npc->beard = atoi(row[55]);
+
+	uint32 armor_tint_id = atoi(row[56]);
+
+	npc->armor_tint[0] = (atoi(row[57]) & 0xFF) << 16;
+	npc->armor_tint[0] |= (atoi(row[58]) & 0xFF) << 8;
+	npc->armor_tint[0] |= (atoi(row[59]) & 0xFF);
+	npc->armor_tint[0] |= (npc->armor_tint[0]) ? (0xFF << 24) : 0;
+
+	// row[96] onward is the joined npc_types_tint row, null when there is none
+	if (armor_tint_id == 0) {
+		for (int index = MaterialChest; index <= EmuConstants::MATERIAL_END; index++)
+			npc->armor_tint[index] = npc->armor_tint[0];
+	}
+	else if (npc->armor_tint[0] == 0 && row[96] != nullptr) {
+		for (int index = EmuConstants::MATERIAL_BEGIN; index <= EmuConstants::MATERIAL_END; index++) {
+			npc->armor_tint[index] = atoi(row[97 + index * 3]) << 16;
+			npc->armor_tint[index] |= atoi(row[97 + index * 3 + 1]) << 8;
+			npc->armor_tint[index] |= atoi(row[97 + index * 3 + 2]);
+			npc->armor_tint[index] |= (npc->armor_tint[index]) ? (0xFF << 24) : 0;
+		}
+	}
+
+	npc->see_invis = atoi(row[60]);
+	npc->see_invis_undead = atoi(row[61]) == 0? false: true;	// Set see_invis_undead flag
+	if (row[62] != nullptr)
+		strn0cpy(npc->lastname, row[62], 32);
+
+	npc->qglobal = atoi(row[63]) == 0? false: true;	// qglobal
+	npc->AC = atoi(row[64]);
+	npc->npc_aggro = atoi(row[65]) == 0? false: true;
+	npc->spawn_limit = atoi(row[66]);
+	npc->see_hide = atoi(row[67]) == 0? false: true;
+	npc->see_improved_hide = atoi(row[68]) == 0? false: true;
+	npc->ATK = atoi(row[69]);
+	npc->accuracy_rating = atoi(row[70]);
+	npc->avoidance_rating = atoi(row[71]);
+	npc->slow_mitigation = atoi(row[72]);
+	npc->maxlevel = atoi(row[73]);
+	npc->scalerate = atoi(row[74]);
+	npc->private_corpse = atoi(row[75]) == 1 ? true: false;
+	npc->unique_spawn_by_name = atoi(row[76]) == 1 ? true: false;
+	npc->underwater = atoi(row[77]) == 1 ? true: false;
+	npc->emoteid = atoi(row[78]);
+	npc->spellscale = atoi(row[79]);
+	npc->healscale = atoi(row[80]);
+	npc->no_target_hotkey = atoi(row[81]) == 1 ? true: false;
+	npc->raid_target = atoi(row[82]) == 0 ? false: true;
+	npc->attack_delay = atoi(row[83]);
+	npc->walkspeed= atof(row[84]);
+	npc->combat_hp_regen = atoi(row[85]);
+	npc->combat_mana_regen = atoi(row[86]);
+	npc->light = (atoi(row[87]) & 0x0F);
+	npc->aggro_pc = atoi(row[88]) == 1 ? true : false;
+	npc->armtexture = atoi(row[89]);
+	npc->bracertexture = atoi(row[90]);
+	npc->handtexture = atoi(row[91]);
+	npc->legtexture = atoi(row[92]);
+	npc->feettexture = atoi(row[93]);
+	npc->chesttexture = atoi(row[94]);
+	npc->ignore_distance = atof(row[95]);
+}
+
+void SharedDatabase::GetNPCTypesCount(int32 &npc_type_count, uint32 &max_id) {
+	npc_type_count = -1;
+	max_id = 0;
+
+	const std::string query = "SELECT MAX(id), count(*) FROM npc_types";
+	auto results = QueryDatabase(query);
+	if (!results.Success()) {
+		return;
+	}
+
+	if (results.RowCount() == 0)
+		return;
+
+	auto row = results.begin();
+
+	if(row[0])
+		max_id = atoi(row[0]);
+
+	if (row[1])
+		npc_type_count = atoi(row[1]);
+}
+
+void SharedDatabase::LoadNPCTypes(void *data, uint32 size, int32 npc_types, uint32 max_npc_type_id) {
+	EQEmu::FixedMemoryHashSet<NPCType> hash(reinterpret_cast<uint8*>(data), size, npc_types, max_npc_type_id);
+
+	auto results = QueryDatabase(GetNPCTypesQuery());
+	if (!results.Success()) {
+		return;
+	}
+
+	NPCType npc;
+	for (auto row = results.begin(); row != results.end(); ++row) {
+		FillNPCType(&npc, row);
+
+		try {
+			hash.insert(npc.npc_id, npc);
+		} catch(std::exception &ex) {
+			Log.Out(Logs::General, Logs::Error, "Database::LoadNPCTypes: %s", ex.what());
+			break;
+		}
+	}
+}
+
+bool SharedDatabase::LoadNPCTypes(const std::string &prefix) {
+	//spawned npcs copy their type out of the segment, see NPC::NPC()
+	npc_types_mmf.reset(nullptr);
+	npc_types_hash.reset(nullptr);
+
+	try {
+		EQEmu::IPCMutex mutex("npc_types");
+		mutex.Lock();
+		std::string file_name = std::string("shared/") + prefix + std::string("npc_types");
+		npc_types_mmf = std::unique_ptr<EQEmu::MemoryMappedFile>(new EQEmu::MemoryMappedFile(file_name));
+		npc_types_hash = std::unique_ptr<EQEmu::FixedMemoryHashSet<NPCType>>(new EQEmu::FixedMemoryHashSet<NPCType>(reinterpret_cast<uint8*>(npc_types_mmf->Get()), npc_types_mmf->Size()));
+		mutex.Unlock();
+	} catch(std::exception& ex) {
+		Log.Out(Logs::General, Logs::Error, "Error Loading npc types: %s", ex.what());
+		return false;
+	}
+
+	return true;
+}
+
+const NPCType* SharedDatabase::GetSharedNPCType(uint32 id) {
+	if(!npc_types_hash || id > npc_types_hash->max_key()) {
+		return nullptr;
+	}
+
+	if(npc_types_hash->exists(id)) {
+		return &(npc_types_hash->at(id));
+	}
+
+	return nullptr;
+}
+
+bool SharedDatabase::IsSharedNPCType(const NPCType *npc_type) {
+	if(!npc_type || !npc_types_mmf) {
+		return false;
+	}
+
+	const uint8 *begin = reinterpret_cast<const uint8*>(npc_types_mmf->Get());
+	const uint8 *p = reinterpret_cast<const uint8*>(npc_type);
+	return p >= begin && p < begin + npc_types_mmf->Size();
+}
+
 // Create appropriate ItemInst class
 ItemInst* SharedDatabase::CreateItem(uint32 item_id, int16 charges)
 {
@@ -17,6 +17,7 @@
 
 struct Item_Struct;
 struct NPCFactionList;
+struct NPCType;
 struct Faction;
 struct LootTable_Struct;
 struct LootDrop_Struct;
@@ -88,6 +89,13 @@ public:
 		void LoadNPCFactionLists(void *data, uint32 size, uint32 list_count, uint32 max_lists);
 		bool LoadNPCFactionLists(const std::string &prefix);
 
+		//npc types
+		void GetNPCTypesCount(int32 &npc_type_count, uint32 &max_id);
+		void LoadNPCTypes(void *data, uint32 size, int32 npc_types, uint32 max_npc_type_id);
+		bool LoadNPCTypes(const std::string &prefix);
+		const NPCType* GetSharedNPCType(uint32 id);
+		bool IsSharedNPCType(const NPCType *npc_type);
+
 		//loot
 		void GetLootTableInfo(uint32 &loot_table_count, uint32 &max_loot_table, uint32 &loot_table_entries);
 		void GetLootDropInfo(uint32 &loot_drop_count, uint32 &max_loot_drop, uint32 &loot_drop_entries);
@@ -114,11 +122,17 @@ public:
 
 protected:
 
+		//the npc_types select, append a WHERE clause for single rows
+		std::string GetNPCTypesQuery();
+		void FillNPCType(NPCType *npc, MySQLRequestRow &row);
+
 		std::unique_ptr<EQEmu::MemoryMappedFile> skill_caps_mmf;
 		std::unique_ptr<EQEmu::MemoryMappedFile> items_mmf;
 		std::unique_ptr<EQEmu::FixedMemoryHashSet<Item_Struct>> items_hash;
 		std::unique_ptr<EQEmu::MemoryMappedFile> faction_mmf;
 		std::unique_ptr<EQEmu::FixedMemoryHashSet<NPCFactionList>> faction_hash;
+		std::unique_ptr<EQEmu::MemoryMappedFile> npc_types_mmf;
+		std::unique_ptr<EQEmu::FixedMemoryHashSet<NPCType>> npc_types_hash;
 		std::unique_ptr<EQEmu::MemoryMappedFile> loot_table_mmf;
 		std::unique_ptr<EQEmu::FixedMemoryVariableHashSet<LootTable_Struct>> loot_table_hash;
 		std::unique_ptr<EQEmu::MemoryMappedFile> loot_drop_mmf;
@@ -40,6 +40,7 @@ public:
 	bool	Connected() const	{ return (pConnected && tcpc.Connected()); }
 
 	void	SetPassword(const char *password) { m_password = password; }
+	void	SetWakeSignal(EventSignal *signal) { tcpc.SetWakeSignal(signal); }
 	bool	Connect();
 	void	AsyncConnect();
 	void	Disconnect();
@@ -0,0 +1,376 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*
+	loadgen: packet capture replay load generator
+
+	Replays the client->server half of one or more packet files (the format
+	written by PacketFileWriter) against a running server, using one
+	EQOldStream per simulated client over its own UDP socket. Captures are
+	loaded once and shared between clients, client N replays capture
+	N % captures so several sessions can be mixed in one run.
+
+	usage: loadgen <host> <port> <clients> <compression> <stagger ms> <capture> [capture ...]
+
+	compression divides the recorded gaps between packets, 1 replays in real
+	time, 10 replays ten times faster. Clients are started [stagger ms] apart.
+
+	Packets are replayed verbatim, the server has to accept the recorded
+	session (matching test accounts, auth and character names) for the
+	replay to get past zone entry. Old format packet files have no direction
+	or timing information and are rejected.
+
+	Reported per run: response latency (request to the next packet from the
+	server) percentiles, resend ratio and ack round trip from the streams.
+*/
+
+#include "../common/global_define.h"
+#include "../common/eqemu_logsys.h"
+#include "../common/eq_packet.h"
+#include "../common/eq_stream.h"
+#include "../common/misc_functions.h"
+#include "../common/packetfile.h"
+#include "../common/platform.h"
+#include "../common/timer.h"
+
+#ifdef _WINDOWS
+	#include <winsock2.h>
+	#include <windows.h>
+#else
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+	#include <unistd.h>
+#endif
+
+#include <fcntl.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+EQEmuLogSys Log;
+
+#define LOADGEN_MAX_PACKET 65536
+#define LOADGEN_REPORT_INTERVAL 10000
+#define LOADGEN_LINGER 2000
+#define LOADGEN_CLOSE_TIMEOUT 5000
+
+struct CapturedPacket {
+	uint32 offset;	//ms since the first client packet of the capture
+	uint16 opcode;
+	std::vector<uchar> data;
+};
+
+struct Capture {
+	std::string name;
+	std::vector<CapturedPacket> packets;
+};
+
+static bool LoadCapture(const char *name, Capture &cap) {
+	PacketFileReader *reader = PacketFileReader::OpenPacketFile(name);
+	if(reader == nullptr)
+		return false;
+
+	cap.name = name;
+
+	uchar *buffer = new uchar[LOADGEN_MAX_PACKET];
+	bool have_start = false;
+	timeval start;
+	uint32 skipped = 0;
+
+	while(true) {
+		uint16 eq_op;
+		uint32 len = LOADGEN_MAX_PACKET;
+		bool to_server;
+		timeval tv;
+		if(!reader->ReadPacket(eq_op, len, buffer, to_server, tv))
+			break;
+
+		if(!to_server) {
+			skipped++;
+			continue;
+		}
+
+		if(tv.tv_sec == 0 && tv.tv_usec == 0) {
+			fprintf(stderr, "%s: packet without a timestamp, old format captures can not be replayed\n", name);
+			safe_delete_array(buffer);
+			safe_delete(reader);
+			return false;
+		}
+
+		if(!have_start) {
+			start = tv;
+			have_start = true;
+		}
+
+		CapturedPacket p;
+		p.offset = (tv.tv_sec - start.tv_sec) * 1000 + (tv.tv_usec - start.tv_usec) / 1000;
+		p.opcode = eq_op;
+		p.data.assign(buffer, buffer + len);
+		cap.packets.push_back(p);
+	}
+
+	safe_delete_array(buffer);
+	safe_delete(reader);
+
+	printf("Loaded %s: %u client packets (%u server packets ignored)\n", name, (uint32)cap.packets.size(), skipped);
+	return !cap.packets.empty();
+}
+
+class LoadClient {
+public:
+	LoadClient(const Capture *capture, const sockaddr_in &server, uint32 start_time);
+	~LoadClient();
+
+	bool Open();
+	void Process(uint32 now, double compression, std::vector<uint32> &latency);
+	bool Done() const { return done; }
+
+	const EQOldStream *GetStream() const { return stream; }
+
+private:
+	void Drain(uint32 now, std::vector<uint32> &latency);
+
+	const Capture *capture;
+	sockaddr_in server;
+	int sock;
+	EQOldStream *stream;
+	uint32 start_time;
+	uint32 finished_time;
+	uint32 awaiting_since;	//send time of the oldest unanswered request, 0 when nothing is pending
+	size_t next;
+	bool done;
+};
+
+LoadClient::LoadClient(const Capture *c, const sockaddr_in &s, uint32 t)
+: capture(c), server(s), sock(-1), stream(nullptr), start_time(t), finished_time(0), awaiting_since(0), next(0), done(false)
+{
+}
+
+LoadClient::~LoadClient() {
+	safe_delete(stream);
+	if(sock >= 0) {
+#ifdef _WINDOWS
+		closesocket(sock);
+#else
+		close(sock);
+#endif
+	}
+}
+
+bool LoadClient::Open() {
+	sock = socket(AF_INET, SOCK_DGRAM, 0);
+	if(sock < 0)
+		return false;
+
+	sockaddr_in address;
+	memset((char *) &address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = 0;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	if(bind(sock, (struct sockaddr *) &address, sizeof(address)) < 0)
+		return false;
+
+#ifdef _WINDOWS
+	unsigned long nonblock = 1;
+	ioctlsocket(sock, FIONBIO, &nonblock);
+#else
+	fcntl(sock, F_SETFL, O_NONBLOCK);
+#endif
+
+	stream = new EQOldStream(server, sock);
+	//the server treats ack 0 / sequence 0 as already seen, start where the client does
+	stream->SACK.dwARQ = 1;
+	stream->SACK.dwGSQ = 1;
+	return true;
+}
+
+void LoadClient::Drain(uint32 now, std::vector<uint32> &latency) {
+	uchar buffer[2048];
+	sockaddr_in from;
+	while(true) {
+#ifdef _WINDOWS
+		int socklen = sizeof(from);
+		int length = recvfrom(sock, (char *) buffer, sizeof(buffer), 0, (struct sockaddr *) &from, &socklen);
+#else
+		socklen_t socklen = sizeof(from);
+		int length = recvfrom(sock, buffer, sizeof(buffer), 0, (struct sockaddr *) &from, &socklen);
+#endif
+		if(length < 2)
+			break;
+		stream->ReceiveData(buffer, length);
+	}
+
+	EQApplicationPacket *app;
+	while((app = stream->PopPacket())) {
+		if(awaiting_since) {
+			latency.push_back(now - awaiting_since);
+			awaiting_since = 0;
+		}
+		safe_delete(app);
+	}
+}
+
+void LoadClient::Process(uint32 now, double compression, std::vector<uint32> &latency) {
+	if(done || now < start_time)
+		return;
+
+	Drain(now, latency);
+
+	uint32 elapsed = static_cast<uint32>((now - start_time) * compression);
+	while(next < capture->packets.size() && capture->packets[next].offset <= elapsed) {
+		const CapturedPacket &p = capture->packets[next];
+		stream->MakeEQPacket(p.opcode, p.data.empty() ? nullptr : &p.data[0], p.data.size(), true);
+		if(!awaiting_since)
+			awaiting_since = now;
+		next++;
+	}
+
+	stream->CheckTimers();
+	stream->SendPacketQueue();
+
+	if(next < capture->packets.size())
+		return;
+
+	if(!finished_time) {
+		finished_time = now;
+	} else if(stream->CheckState(ESTABLISHED) && now - finished_time >= LOADGEN_LINGER) {
+		stream->Close();
+	} else if(stream->CheckClosed() || stream->CheckState(DISCONNECTING) || now - finished_time >= LOADGEN_LINGER + LOADGEN_CLOSE_TIMEOUT) {
+		done = true;
+	}
+}
+
+static uint32 Percentile(const std::vector<uint32> &sorted, double pct) {
+	if(sorted.empty())
+		return 0;
+	return sorted[static_cast<size_t>(pct * (sorted.size() - 1) + 0.5)];
+}
+
+static void Report(const char *label, const std::vector<LoadClient *> &clients, std::vector<uint32> latency) {
+	uint32 sent = 0, resent = 0, recv = 0, rtt_max = 0, rtt_total = 0, active = 0;
+	for(size_t i = 0; i < clients.size(); ++i) {
+		const EQOldStream *s = clients[i]->GetStream();
+		if(s == nullptr)
+			continue;
+		sent += s->GetPacketsSent();
+		resent += s->GetPacketsResent();
+		recv += s->GetPacketsRecv();
+		rtt_total += s->GetAckRTTAverage();
+		rtt_max = std::max(rtt_max, s->GetAckRTTMax());
+		if(!clients[i]->Done())
+			active++;
+	}
+
+	std::sort(latency.begin(), latency.end());
+	printf("[%s] clients %u/%u, sent %u, resent %u (%.2f%%), recv %u, ack rtt avg %u max %u ms\n",
+		label, active, (uint32)clients.size(), sent, resent, sent ? 100.0 * resent / sent : 0.0, recv,
+		clients.empty() ? 0 : rtt_total / (uint32)clients.size(), rtt_max);
+	printf("[%s] response latency ms: p50 %u, p90 %u, p99 %u, max %u (%u samples)\n",
+		label, Percentile(latency, 0.50), Percentile(latency, 0.90), Percentile(latency, 0.99),
+		Percentile(latency, 1.0), (uint32)latency.size());
+}
+
+int main(int argc, char **argv) {
+	RegisterExecutablePlatform(ExePlatformLoadGen);
+	Log.LoadLogSettingsDefaults();
+
+	if(argc < 7) {
+		fprintf(stderr, "Usage: %s <host> <port> <clients> <compression> <stagger ms> <capture> [capture ...]\n", argv[0]);
+		return 1;
+	}
+
+	char errbuf[ERRBUF_SIZE];
+	uint32 ip = ResolveIP(argv[1], errbuf);
+	if(ip == 0) {
+		fprintf(stderr, "Unable to resolve %s: %s\n", argv[1], errbuf);
+		return 1;
+	}
+
+	sockaddr_in server;
+	memset((char *) &server, 0, sizeof(server));
+	server.sin_family = AF_INET;
+	server.sin_port = htons(atoi(argv[2]));
+	server.sin_addr.s_addr = ip;
+
+	uint32 client_count = atoi(argv[3]);
+	double compression = atof(argv[4]);
+	uint32 stagger = atoi(argv[5]);
+	if(client_count == 0 || compression <= 0.0) {
+		fprintf(stderr, "Client count and compression must be positive.\n");
+		return 1;
+	}
+
+	std::vector<Capture> captures;
+	for(int i = 6; i < argc; ++i) {
+		Capture cap;
+		if(LoadCapture(argv[i], cap))
+			captures.push_back(cap);
+	}
+	if(captures.empty()) {
+		fprintf(stderr, "No usable captures.\n");
+		return 1;
+	}
+
+	Timer::SetCurrentTime();
+	uint32 start = Timer::GetCurrentTime();
+
+	std::vector<LoadClient *> clients;
+	for(uint32 i = 0; i < client_count; ++i) {
+		LoadClient *c = new LoadClient(&captures[i % captures.size()], server, start + i * stagger);
+		if(!c->Open()) {
+			fprintf(stderr, "Unable to open a socket for client %u\n", i);
+			safe_delete(c);
+			break;
+		}
+		clients.push_back(c);
+	}
+
+	printf("Replaying %u capture(s) with %u clients against %s:%s at %.1fx\n",
+		(uint32)captures.size(), (uint32)clients.size(), argv[1], argv[2], compression);
+
+	std::vector<uint32> latency;
+	uint32 last_report = start;
+	bool running = !clients.empty();
+	while(running) {
+		Timer::SetCurrentTime();
+		uint32 now = Timer::GetCurrentTime();
+
+		running = false;
+		for(size_t i = 0; i < clients.size(); ++i) {
+			clients[i]->Process(now, compression, latency);
+			if(!clients[i]->Done())
+				running = true;
+		}
+
+		if(now - last_report >= LOADGEN_REPORT_INTERVAL) {
+			Report("progress", clients, latency);
+			last_report = now;
+		}
+
+		Sleep(1);
+	}
+
+	Report("total", clients, latency);
+
+	for(size_t i = 0; i < clients.size(); ++i)
+		safe_delete(clients[i]);
+
+	return 0;
+}
@@ -29,6 +29,7 @@
 #include "../common/string_util.h"
 #include "items.h"
 #include "npc_faction.h"
+#include "npc_types.h"
 #include "loot.h"
 #include "skill_caps.h"
 #include "spells.h"
@@ -66,6 +67,7 @@ int main(int argc, char **argv) {
 	bool load_all = true;
 	bool load_items = false;
 	bool load_factions = false;
+	bool load_npc_types = false;
 	bool load_loot = false;
 	bool load_skill_caps = false;
 	bool load_spells = false;
@@ -94,6 +96,13 @@ int main(int argc, char **argv) {
 				}
 				break;
 	
+			case 'n':
+				if(strcasecmp("npc_types", argv[i]) == 0) {
+					load_npc_types = true;
+					load_all = false;
+				}
+				break;
+	
 			case 'l':
 				if(strcasecmp("loot", argv[i]) == 0) {
 					load_loot = true;
@@ -150,6 +159,16 @@ int main(int argc, char **argv) {
 		}
 	}
 	
+	if(load_all || load_npc_types) {
+		Log.Out(Logs::General, Logs::Status, "Loading npc types...");
+		try {
+			LoadNPCTypes(&database, hotfix_name);
+		} catch(std::exception &ex) {
+			Log.Out(Logs::General, Logs::Error, "%s", ex.what());
+			return 1;
+		}
+	}
+	
 	if(load_all || load_loot) {
 		Log.Out(Logs::General, Logs::Status, "Loading loot...");
 		try {
@@ -0,0 +1,149 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2014 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_BROADCAST_PACKET_H
+#define __EQEMU_TESTS_BROADCAST_PACKET_H
+
+#include "cppunit/cpptest.h"
+#include "../common/eq_broadcast_packet.h"
+#include "../common/eq_packet.h"
+#include "../common/eq_stream_intf.h"
+#include "../common/struct_strategy.h"
+
+#include <vector>
+
+//widens every byte to two, counting how often it runs
+class BroadcastTestStrategy : public StructStrategy {
+public:
+	BroadcastTestStrategy() {
+		encoders[OP_MobHealth] = Encode_MobHealth;
+	}
+
+	virtual std::string Describe() const { return "Broadcast test"; }
+	virtual const EQClientVersion ClientVersion() const { return EQClientMac; }
+
+	static int encodes;
+
+private:
+	static void Encode_MobHealth(EQApplicationPacket **p, EQStreamInterface *dest, bool ack_req) {
+		encodes++;
+		EQApplicationPacket *in = *p;
+		*p = nullptr;
+
+		EQApplicationPacket *out = new EQApplicationPacket(OP_MobHealth, in->size * 2);
+		for (uint32 i = 0; i < in->size; i++) {
+			out->pBuffer[i * 2] = in->pBuffer[i];
+			out->pBuffer[i * 2 + 1] = in->pBuffer[i];
+		}
+		delete in;
+		dest->FastQueuePacket(&out, ack_req);
+	}
+};
+
+int BroadcastTestStrategy::encodes = 0;
+
+class BroadcastTestStream : public EQStreamInterface {
+public:
+	~BroadcastTestStream() {
+		for (size_t i = 0; i < queued.size(); i++)
+			delete queued[i];
+	}
+
+	virtual void QueuePacket(const EQApplicationPacket *p, bool ack_req) { queued.push_back(p->Copy()); }
+	virtual void FastQueuePacket(EQApplicationPacket **p, bool ack_req) { queued.push_back(*p); *p = nullptr; }
+	virtual EQApplicationPacket *PopPacket() { return nullptr; }
+	virtual void Close() { }
+	virtual void ReleaseFromUse() { }
+	virtual void RemoveData() { }
+	virtual uint32 GetRemoteIP() const { return 0; }
+	virtual uint16 GetRemotePort() const { return 0; }
+	virtual bool CheckState(EQStreamState state) { return state == ESTABLISHED; }
+	virtual std::string Describe() const { return "Broadcast test stream"; }
+	virtual bool IsInUse() { return true; }
+
+	std::vector<EQApplicationPacket *> queued;
+};
+
+class BroadcastPacketTest : public Test::Suite {
+	typedef void(BroadcastPacketTest::*TestFunction)(void);
+public:
+	BroadcastPacketTest() {
+		TEST_ADD(BroadcastPacketTest::EncodeOncePerStrategy);
+		TEST_ADD(BroadcastPacketTest::EncodeOncePerAckMode);
+		TEST_ADD(BroadcastPacketTest::SourceUntouched);
+	}
+
+	~BroadcastPacketTest() {
+	}
+
+	private:
+	void EncodeOncePerStrategy() {
+		BroadcastTestStrategy mac, trilogy;
+		BroadcastTestStream streams[4];
+		const uchar data[3] = { 1, 2, 3 };
+		EQApplicationPacket app(OP_MobHealth, data, sizeof(data));
+
+		BroadcastTestStrategy::encodes = 0;
+		{
+			EQBroadcastPacket bp(&app);
+			bp.Queue(&mac, &streams[0], true);
+			bp.Queue(&mac, &streams[1], true);
+			bp.Queue(&trilogy, &streams[2], true);
+			bp.Queue(&mac, &streams[3], true);
+			TEST_ASSERT_EQUALS(bp.GetEncodeCount(), 2);
+		}
+		TEST_ASSERT_EQUALS(BroadcastTestStrategy::encodes, 2);
+
+		for (int i = 0; i < 4; i++) {
+			TEST_ASSERT_EQUALS(streams[i].queued.size(), 1);
+			TEST_ASSERT_EQUALS(streams[i].queued[0]->size, 6);
+			TEST_ASSERT(streams[i].queued[0]->GetOpcode() == OP_MobHealth);
+			TEST_ASSERT_EQUALS(streams[i].queued[0]->pBuffer[5], 3);
+		}
+	}
+
+	void EncodeOncePerAckMode() {
+		BroadcastTestStrategy mac;
+		BroadcastTestStream streams[2];
+		const uchar data[1] = { 7 };
+		EQApplicationPacket app(OP_MobHealth, data, sizeof(data));
+
+		BroadcastTestStrategy::encodes = 0;
+		EQBroadcastPacket bp(&app);
+		bp.Queue(&mac, &streams[0], true);
+		bp.Queue(&mac, &streams[1], false);
+		TEST_ASSERT_EQUALS(BroadcastTestStrategy::encodes, 2);
+	}
+
+	void SourceUntouched() {
+		BroadcastTestStrategy mac;
+		BroadcastTestStream stream;
+		const uchar data[2] = { 4, 5 };
+		EQApplicationPacket app(OP_MobHealth, data, sizeof(data));
+
+		{
+			EQBroadcastPacket bp(&app);
+			bp.Queue(&mac, &stream, true);
+		}
+		TEST_ASSERT_EQUALS(app.size, 2);
+		TEST_ASSERT_EQUALS(app.pBuffer[0], 4);
+		TEST_ASSERT_EQUALS(app.pBuffer[1], 5);
+	}
+};
+
+#endif
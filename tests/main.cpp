@@ -29,6 +29,11 @@
 #include "string_util_test.h"
 #include "data_verification_test.h"
 #include "skills_util_test.h"
+#include "broadcast_packet_test.h"
+#include "worker_pool_test.h"
+#include "../common/eqemu_logsys.h"
+
+EQEmuLogSys Log;
 
 int main() {
 	try {
@@ -44,6 +49,8 @@ int main() {
 		tests.add(new StringUtilTest());
 		tests.add(new DataVerificationTest());
 		tests.add(new SkillsUtilsTest());
+		tests.add(new BroadcastPacketTest());
+		tests.add(new WorkerPoolTest());
 		tests.run(*output, true);
 	} catch(...) {
 		return -1;
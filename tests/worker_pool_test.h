@@ -0,0 +1,77 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_WORKER_POOL_H
+#define __EQEMU_TESTS_WORKER_POOL_H
+
+#include "cppunit/cpptest.h"
+#include "../zone/worker_pool.h"
+
+#include <vector>
+
+class WorkerPoolTest : public Test::Suite {
+	typedef void(WorkerPoolTest::*TestFunction)(void);
+public:
+	WorkerPoolTest() {
+		TEST_ADD(WorkerPoolTest::NoThreads);
+		TEST_ADD(WorkerPoolTest::EveryIndexOnce);
+		TEST_ADD(WorkerPoolTest::RunRightAfterSetThreads);
+	}
+
+	~WorkerPoolTest() {
+	}
+
+	private:
+	//runs the job and checks each index was done exactly once
+	bool RunJob(WorkerPool &pool, uint32 count, uint32 chunk) {
+		std::vector<uint32> hits(count, 0);
+		pool.Run(count, chunk, [&hits](uint32 i) { hits[i]++; });
+		for (uint32 i = 0; i < count; i++) {
+			if (hits[i] != 1)
+				return false;
+		}
+		return true;
+	}
+
+	void NoThreads() {
+		WorkerPool pool;
+		TEST_ASSERT_EQUALS(pool.GetThreads(), 0);
+		TEST_ASSERT(RunJob(pool, 100, 4));
+	}
+
+	void EveryIndexOnce() {
+		WorkerPool pool;
+		pool.SetThreads(3);
+		TEST_ASSERT_EQUALS(pool.GetThreads(), 3);
+		for (int i = 0; i < 50; i++)
+			TEST_ASSERT(RunJob(pool, 1000, 4));
+	}
+
+	//new threads that haven't reached their wait yet must still pick up the first job
+	void RunRightAfterSetThreads() {
+		WorkerPool pool;
+		for (uint32 i = 0; i < 500; i++) {
+			pool.SetThreads(1 + i % 4);
+			TEST_ASSERT(RunJob(pool, 64, 4));
+		}
+		pool.SetThreads(0);
+		TEST_ASSERT(RunJob(pool, 64, 4));
+	}
+};
+
+#endif
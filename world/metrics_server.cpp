@@ -0,0 +1,188 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "../common/global_define.h"
+#include "../common/eqemu_logsys.h"
+#include "../common/misc_functions.h"
+#include "../common/string_util.h"
+#include "../common/timer.h"
+
+#include "clientlist.h"
+#include "metrics_server.h"
+#include "worlddb.h"
+#include "zonelist.h"
+
+#include <string.h>
+
+#ifndef _WINDOWS
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+	#include <arpa/inet.h>
+	#include <errno.h>
+	#include <fcntl.h>
+	#define INVALID_SOCKET -1
+	#define SOCKET_ERROR -1
+#endif
+
+#define METRICS_MAX_ACCEPTS 8		//new connections taken per Process(), the rest wait for the next loop
+#define METRICS_MAX_CONNECTIONS 32
+#define METRICS_TIMEOUT_MS 5000
+
+extern ClientList client_list;
+extern ZSList zoneserver_list;
+
+static void CloseSocket(SOCKET s) {
+#ifdef _WINDOWS
+	closesocket(s);
+#else
+	close(s);
+#endif
+}
+
+static void SetNonBlocking(SOCKET s) {
+#ifdef _WINDOWS
+	unsigned long nonblocking = 1;
+	ioctlsocket(s, FIONBIO, &nonblocking);
+#else
+	fcntl(s, F_SETFL, O_NONBLOCK);
+#endif
+}
+
+MetricsServer::MetricsServer() {
+	sock = 0;
+}
+
+MetricsServer::~MetricsServer() {
+	Close();
+}
+
+bool MetricsServer::Open(uint16 port) {
+	if (sock != 0)
+		return false;
+
+	struct sockaddr_in address;
+	memset((char *) &address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	sock = socket(AF_INET, SOCK_STREAM, 0);
+	if (sock == INVALID_SOCKET) {
+		sock = 0;
+		Log.Out(Logs::General, Logs::World_Server, "Metrics listener: socket() failed.");
+		return false;
+	}
+
+	int reuse_addr = 1;
+	setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (char *) &reuse_addr, sizeof(reuse_addr));
+
+	if (bind(sock, (struct sockaddr *) &address, sizeof(address)) < 0 || listen(sock, SOMAXCONN) == SOCKET_ERROR) {
+		Log.Out(Logs::General, Logs::World_Server, "Metrics listener: unable to listen on 127.0.0.1:%u.", port);
+		CloseSocket(sock);
+		sock = 0;
+		return false;
+	}
+
+	SetNonBlocking(sock);
+
+	Log.Out(Logs::General, Logs::World_Server, "Metrics listener started on 127.0.0.1:%u.", port);
+	return true;
+}
+
+void MetricsServer::Close() {
+	for (std::list<Connection>::iterator it = connections.begin(); it != connections.end(); ++it)
+		CloseSocket(it->sock);
+	connections.clear();
+
+	if (sock != 0)
+		CloseSocket(sock);
+	sock = 0;
+}
+
+void MetricsServer::Process() {
+	if (sock == 0)
+		return;
+
+	Accept();
+
+	std::list<Connection>::iterator it = connections.begin();
+	while (it != connections.end()) {
+		if (Flush(*it)) {
+			++it;
+			continue;
+		}
+		CloseSocket(it->sock);
+		it = connections.erase(it);
+	}
+}
+
+void MetricsServer::Accept() {
+	for (int i = 0; i < METRICS_MAX_ACCEPTS && connections.size() < METRICS_MAX_CONNECTIONS; i++) {
+		SOCKET s = accept(sock, nullptr, nullptr);
+		if (s == INVALID_SOCKET)
+			return;
+		SetNonBlocking(s);
+
+		//the page is built once per connection, when it is accepted
+		std::string body;
+		WriteMetrics(body);
+
+		Connection conn;
+		conn.sock = s;
+		conn.sent = 0;
+		conn.accepted = Timer::GetCurrentTime();
+		conn.response = StringFormat("HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+			"Content-Length: %u\r\nConnection: close\r\n\r\n", (uint32)body.length());
+		conn.response += body;
+		connections.push_back(conn);
+	}
+}
+
+bool MetricsServer::Flush(Connection& conn) {
+	if (Timer::GetCurrentTime() - conn.accepted > METRICS_TIMEOUT_MS)
+		return false;
+
+	//drain the request so the close does not reset the connection under the response
+	char request[1024];
+	while (recv(conn.sock, request, sizeof(request), 0) > 0)
+		;
+
+	while (conn.sent < conn.response.length()) {
+		int len = send(conn.sock, conn.response.c_str() + conn.sent, conn.response.length() - conn.sent, 0);
+		if (len <= 0)
+			return true;	//socket buffer full, or an error the timeout will clean up
+		conn.sent += len;
+	}
+
+	return false;
+}
+
+void MetricsServer::WriteMetrics(std::string& out) {
+	out += "# TYPE eqemu_world_zones gauge\n";
+	out += StringFormat("eqemu_world_zones %d\n", zoneserver_list.GetZoneCount());
+	out += "# TYPE eqemu_world_players gauge\n";
+	out += StringFormat("eqemu_world_players %d\n", client_list.GetClientCount());
+	out += "# TYPE eqemu_world_db_queries_total counter\n";
+	out += StringFormat("eqemu_world_db_queries_total %llu\n", (unsigned long long)database.GetQueryCount());
+	out += "# TYPE eqemu_world_db_query_microseconds_total counter\n";
+	out += StringFormat("eqemu_world_db_query_microseconds_total %llu\n", (unsigned long long)database.GetQueryTimeUS());
+	out += "# TYPE eqemu_world_resident_bytes gauge\n";
+	out += StringFormat("eqemu_world_resident_bytes %llu\n", (unsigned long long)GetResidentMemory());
+
+	zoneserver_list.WriteMetrics(out);
+}
@@ -0,0 +1,67 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+/*
+	Plain text scrape endpoint for world and zone counters.
+
+	Listens on 127.0.0.1 only and is polled from the world main loop, so the
+	zone list is read on the thread that owns it. Every connection gets one
+	HTTP/1.0 response in the prometheus text format, written out over as many
+	loops as the socket needs, and is closed; the request itself is not
+	parsed, any path returns the same page. Zones push
+	their counters with ServerOP_ZoneMetrics, see ZSList::WriteMetrics().
+*/
+
+#ifndef _WINDOWS
+	#include "../common/unix.h"
+#endif
+#include "../common/types.h"
+
+#include <list>
+#include <string>
+
+class MetricsServer
+{
+public:
+	MetricsServer();
+	~MetricsServer();
+
+	bool	Open(uint16 port);
+	void	Close();
+	void	Process();
+	inline bool	IsOpen() const	{ return sock != 0; }
+
+private:
+	struct Connection {
+		SOCKET		sock;
+		std::string	response;
+		size_t		sent;
+		uint32		accepted;	//Timer::GetCurrentTime()
+	};
+
+	void	Accept();
+	bool	Flush(Connection& conn);	//false once the connection is finished with
+	void	WriteMetrics(std::string& out);
+
+	SOCKET	sock;
+	std::list<Connection> connections;
+};
+
+#endif
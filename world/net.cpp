@@ -83,6 +83,7 @@
 #include "launcher_list.h"
 #include "wguild_mgr.h"
 #include "ucs.h"
+#include "metrics_server.h"
 #include "queryserv.h"
 #include "web_interface.h"
 #include "../zone/remote_call_subscribe.h"
@@ -94,6 +95,7 @@ ClientList client_list;
 ZSList zoneserver_list;
 LoginServerList loginserverlist;
 EQWHTTPServer http_server;
+MetricsServer metrics_server;
 UCSConnection UCSLink;
 QueryServConnection QSLink;
 WebInterfaceConnection WILink;
@@ -387,6 +389,8 @@ int main(int argc, char** argv) {
 		Log.Out(Logs::General, Logs::World_Server,"Failed to start client (UDP) listener (port 9000)");
 		return 1;
 	}
+	if (RuleI(World, MetricsPort) > 0)
+		metrics_server.Open(RuleI(World, MetricsPort));
 
 	//register all the patches we have avaliable with the stream identifier.
 	EQStreamIdentifier stream_identifier;
@@ -529,6 +533,7 @@ int main(int argc, char** argv) {
 		console_list.Process();
 		zoneserver_list.Process();
 		launcher_list.Process();
+		metrics_server.Process();
 		UCSLink.Process();
 		QSLink.Process();
 
@@ -566,6 +571,7 @@ int main(int argc, char** argv) {
 	tcps.Close();
 	Log.Out(Logs::General, Logs::World_Server, "Client (UDP) listener stopped.");
 	eqsf.Close();
+	metrics_server.Close();
 	Log.Out(Logs::General, Logs::World_Server, "Signaling HTTP service to stop...");
 	http_server.Stop();
 	Log.CloseFileLogs();
@@ -26,6 +26,9 @@
 #include "../common/string_util.h"
 #include "../common/random.h"
 
+#include <algorithm>
+#include <stddef.h>
+
 extern uint32			numzones;
 extern bool holdzones;
 extern ConsoleList		console_list;
@@ -283,6 +286,90 @@ void ZSList::ListLockedZones(const char* to, WorldTCPConnection* connection) {
 	connection->SendEmoteMessage(to, 0, 0, 0, "%i zones locked.", x);
 }
 
+static bool CompareZoneProfile(const ZoneServer* a, const ZoneServer* b) {
+	return a->GetProfile()->tick_p99 > b->GetProfile()->tick_p99;
+}
+
+void ZSList::ShowSlowestZones(const char* to, uint32 count, WorldTCPConnection* connection) {
+	std::vector<ZoneServer*> zones;
+	LinkedListIterator<ZoneServer*> iterator(list);
+
+	iterator.Reset();
+	while (iterator.MoreElements()) {
+		if (iterator.GetData()->GetZoneID() && iterator.GetData()->GetProfile())
+			zones.push_back(iterator.GetData());
+		iterator.Advance();
+	}
+
+	if (zones.empty()) {
+		connection->SendEmoteMessage(to, 0, 0, 0, "No zone has reported a profile yet.");
+		return;
+	}
+
+	std::sort(zones.begin(), zones.end(), CompareZoneProfile);
+	if (count == 0 || count > zones.size())
+		count = zones.size();
+
+	connection->SendEmoteMessage(to, 0, 0, 0, "Slowest %u of %u zones by p99 tick time (ms):", count, (uint32)zones.size());
+	for (uint32 i = 0; i < count; i++) {
+		const ServerZoneProfile_Struct* zp = zones[i]->GetProfile();
+		connection->SendEmoteMessage(to, 0, 0, 0, "  #%u %s (%u:%u) clients: %u p50: %.2f p99: %.2f max: %.2f worst: %s %.2f",
+			zones[i]->GetID(), zones[i]->GetZoneName(), zp->zoneid, zp->instanceid, zp->clients,
+			zp->tick_p50 / 1000.0f, zp->tick_p99 / 1000.0f, zp->tick_max / 1000.0f,
+			zp->worst_phase, zp->worst_phase_p99 / 1000.0f);
+	}
+}
+
+struct ZoneMetricField {
+	const char*	name;
+	const char*	type;
+	size_t		offset;
+	bool		wide;	//uint64 rather than uint32
+};
+
+static const ZoneMetricField zone_metric_fields[] = {
+	{ "eqemu_zone_tick_p50_microseconds",		"gauge",	offsetof(ServerZoneMetrics_Struct, tick_p50),			false },
+	{ "eqemu_zone_tick_p99_microseconds",		"gauge",	offsetof(ServerZoneMetrics_Struct, tick_p99),			false },
+	{ "eqemu_zone_tick_max_microseconds",		"gauge",	offsetof(ServerZoneMetrics_Struct, tick_max),			false },
+	{ "eqemu_zone_clients",						"gauge",	offsetof(ServerZoneMetrics_Struct, clients),			false },
+	{ "eqemu_zone_npcs",						"gauge",	offsetof(ServerZoneMetrics_Struct, npcs),				false },
+	{ "eqemu_zone_mobs",						"gauge",	offsetof(ServerZoneMetrics_Struct, mobs),				false },
+	{ "eqemu_zone_corpses",						"gauge",	offsetof(ServerZoneMetrics_Struct, corpses),			false },
+	{ "eqemu_zone_packets_in_total",			"counter",	offsetof(ServerZoneMetrics_Struct, packets_in),			true },
+	{ "eqemu_zone_bytes_in_total",				"counter",	offsetof(ServerZoneMetrics_Struct, bytes_in),			true },
+	{ "eqemu_zone_packets_out_total",			"counter",	offsetof(ServerZoneMetrics_Struct, packets_out),		true },
+	{ "eqemu_zone_bytes_out_total",				"counter",	offsetof(ServerZoneMetrics_Struct, bytes_out),			true },
+	{ "eqemu_zone_db_queries_total",			"counter",	offsetof(ServerZoneMetrics_Struct, db_queries),			true },
+	{ "eqemu_zone_db_query_microseconds_total",	"counter",	offsetof(ServerZoneMetrics_Struct, db_query_time_us),	true },
+	{ "eqemu_zone_db_query_max_microseconds",	"gauge",	offsetof(ServerZoneMetrics_Struct, db_query_max_us),	false },
+	{ "eqemu_zone_resident_bytes",				"gauge",	offsetof(ServerZoneMetrics_Struct, rss_bytes),			true }
+};
+
+//the last report of every booted zone in the prometheus text format, one group per metric
+void ZSList::WriteMetrics(std::string& out) {
+	std::vector<ZoneServer*> zones;
+	LinkedListIterator<ZoneServer*> iterator(list);
+
+	iterator.Reset();
+	while (iterator.MoreElements()) {
+		if (iterator.GetData()->GetZoneID() && iterator.GetData()->GetMetrics())
+			zones.push_back(iterator.GetData());
+		iterator.Advance();
+	}
+
+	for (size_t f = 0; f < sizeof(zone_metric_fields) / sizeof(zone_metric_fields[0]); f++) {
+		const ZoneMetricField& field = zone_metric_fields[f];
+		out += StringFormat("# TYPE %s %s\n", field.name, field.type);
+		for (size_t i = 0; i < zones.size(); i++) {
+			const uchar* base = (const uchar*) zones[i]->GetMetrics();
+			uint64 value = field.wide ? *(const uint64*)(base + field.offset) : *(const uint32*)(base + field.offset);
+			out += StringFormat("%s{zone=\"%s\",zone_id=\"%u\",instance=\"%u\",server_id=\"%u\"} %llu\n",
+				field.name, zones[i]->GetZoneName(), zones[i]->GetZoneID(), zones[i]->GetInstanceID(),
+				zones[i]->GetID(), (unsigned long long)value);
+		}
+	}
+}
+
 void ZSList::SendZoneStatus(const char* to, int16 admin, WorldTCPConnection* connection) {
 	LinkedListIterator<ZoneServer*> iterator(list);
 	struct in_addr in;
@@ -5,6 +5,7 @@
 #include "../common/eqtime.h"
 #include "../common/timer.h"
 #include "../common/linked_list.h"
+#include <string>
 #include <vector>
 
 class WorldTCPConnection;
@@ -48,6 +49,8 @@ public:
 	bool	SetLockedZone(uint16 iZoneID, bool iLock);
 	bool	IsZoneLocked(uint16 iZoneID);
 	void	ListLockedZones(const char* to, WorldTCPConnection* connection);
+	void	ShowSlowestZones(const char* to, uint32 count, WorldTCPConnection* connection);
+	void	WriteMetrics(std::string& out);
 	Timer*	shutdowntimer;
 	Timer*	reminder;
 	void	NextGroupIDs(uint32 &start, uint32 &end);
@@ -61,6 +61,8 @@ ZoneServer::ZoneServer(EmuTCPConnection* itcpc)
 	authenticated = false;
 	staticzone = false;
 	pNumPlayers = 0;
+	has_profile = false;
+	has_metrics = false;
 }
 
 ZoneServer::~ZoneServer() {
@@ -81,6 +83,8 @@ bool ZoneServer::SetZone(uint32 iZoneID, uint32 iInstanceID, bool iStaticZone) {
 
 	zoneID = iZoneID;
 	instanceID = iInstanceID;
+	has_profile = false;
+	has_metrics = false;
 	if(iZoneID!=0)
 		oldZoneID = iZoneID;
 	if (zoneID == 0) {
@@ -921,6 +925,31 @@ bool ZoneServer::Process() {
 				}
 				break;
 			}
+			case ServerOP_ZoneProfile: {
+				if (pack->size != sizeof(ServerZoneProfile_Struct)) {
+					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_ZoneProfile. Got: %d, Expected: %d",pack->size,sizeof(ServerZoneProfile_Struct));
+					break;
+				}
+				SetProfile((ServerZoneProfile_Struct*) pack->pBuffer);
+				break;
+			}
+			case ServerOP_ZoneProfileRequest: {
+				if (pack->size != sizeof(ServerZoneProfileRequest_Struct)) {
+					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_ZoneProfileRequest. Got: %d, Expected: %d",pack->size,sizeof(ServerZoneProfileRequest_Struct));
+					break;
+				}
+				ServerZoneProfileRequest_Struct* zpr = (ServerZoneProfileRequest_Struct*) pack->pBuffer;
+				zoneserver_list.ShowSlowestZones(zpr->adminname, zpr->count, this);
+				break;
+			}
+			case ServerOP_ZoneMetrics: {
+				if (pack->size != sizeof(ServerZoneMetrics_Struct)) {
+					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_ZoneMetrics. Got: %d, Expected: %d",pack->size,sizeof(ServerZoneMetrics_Struct));
+					break;
+				}
+				SetMetrics((ServerZoneMetrics_Struct*) pack->pBuffer);
+				break;
+			}
 			case ServerOP_Petition: {
 				zoneserver_list.SendPacket(pack);
 				break;
@@ -20,6 +20,7 @@
 
 #include "world_tcp_connection.h"
 #include "../common/emu_tcp_connection.h"
+#include "../common/servertalk.h"
 #include <string.h>
 #include <string>
 
@@ -69,6 +70,15 @@ public:
 
 	inline uint32		GetInstanceID() { return instanceID; }
 	inline void			SetInstanceID(uint32 i) { instanceID = i; }
+
+	//last tick profile reported by the zone, nullptr until the first report
+	inline const ServerZoneProfile_Struct* GetProfile() const { return has_profile ? &profile : nullptr; }
+	inline void			SetProfile(const ServerZoneProfile_Struct* p) { memcpy(&profile, p, sizeof(profile)); has_profile = true; }
+	inline void			ClearProfile()		{ has_profile = false; }
+
+	//last counters reported by the zone for the metrics endpoint, nullptr until the first report
+	inline const ServerZoneMetrics_Struct* GetMetrics() const { return has_metrics ? &metrics : nullptr; }
+	inline void			SetMetrics(const ServerZoneMetrics_Struct* m) { memcpy(&metrics, m, sizeof(metrics)); has_metrics = true; }
 private:
 	EmuTCPConnection* const tcpc;
 
@@ -89,6 +99,10 @@ private:
 	uint32	instanceID;	//instance ids contain a zone id, and a zone version
 	std::string launcher_name;	//the launcher which started us
 	std::string launched_name;	//the name of the zone we launched.
+	ServerZoneProfile_Struct profile;
+	bool	has_profile;
+	ServerZoneMetrics_Struct metrics;
+	bool	has_metrics;
 };
 
 #endif
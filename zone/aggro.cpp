@@ -27,6 +27,7 @@
 #include "entity.h"
 #include "mob.h"
 #include "water_map.h"
+#include "worker_pool.h"
 
 #ifdef BOTS
 #include "bot.h"
@@ -34,17 +35,95 @@
 
 #include "map.h"
 
+#include <algorithm>
+
 extern Zone* zone;
 //#define LOSDEBUG 6
 
+//runs the range search of ThinkAggroScans()
+static WorkerPool aggro_scan_pool;
+
 //look around a client for things which might aggro the client.
-void EntityList::CheckClientAggro(Client *around)
+#define AGGRO_GRID_CELL 128.0f
+#define AGGRO_GRID_WIDE 16	//cells a box may cover before it is checked for every client instead
+
+static inline int AggroGridCell(float v)
 {
-	for (auto it = mob_list.begin(); it != mob_list.end(); ++it) {
+	return static_cast<int>(floorf(v / AGGRO_GRID_CELL));
+}
+
+static inline uint32 AggroGridKey(int cx, int cy)
+{
+	return (static_cast<uint32>(static_cast<uint16>(cx)) << 16) | static_cast<uint16>(cy);
+}
+
+/*
+	Files the aggro box of every mob that can aggro a client under each grid
+	cell it overlaps. Built on the first client check of a loop pass and used
+	by every client checked in that pass, so a client only runs CheckWillAggro
+	against the mobs whose box it could be standing in.
+*/
+void EntityList::BuildAggroGrid()
+{
+	aggro_grid.clear();
+	aggro_grid_wide.clear();
+
+	uint32 order = 0;
+	for (auto it = mob_list.begin(); it != mob_list.end(); ++it, ++order) {
 		Mob *mob = it->second;
-		if (mob->IsClient())	//also ensures that mob != around
+		if (mob->IsClient() || mob->IsPet())
+			continue;
+
+		float range = mob->GetAggroRange();
+		if (range < 0.0f)	//the range test in CheckWillAggro fails for everyone
+			continue;
+
+		AggroGridEntry entry = { order, it->first };
+		if (range > AGGRO_GRID_CELL * AGGRO_GRID_WIDE) {
+			aggro_grid_wide.push_back(entry);
 			continue;
-		if (mob->IsPet())
+		}
+
+		int x0 = AggroGridCell(mob->GetX() - range);
+		int x1 = AggroGridCell(mob->GetX() + range);
+		int y0 = AggroGridCell(mob->GetY() - range);
+		int y1 = AggroGridCell(mob->GetY() + range);
+		if ((x1 - x0 + 1) * (y1 - y0 + 1) > AGGRO_GRID_WIDE) {
+			aggro_grid_wide.push_back(entry);
+			continue;
+		}
+
+		for (int cx = x0; cx <= x1; ++cx) {
+			for (int cy = y0; cy <= y1; ++cy)
+				aggro_grid[AggroGridKey(cx, cy)].push_back(entry);
+		}
+	}
+
+	aggro_grid_time = Timer::GetCurrentTime();
+}
+
+void EntityList::CheckClientAggro(Client *around)
+{
+	if (aggro_grid_time != Timer::GetCurrentTime())
+		BuildAggroGrid();
+
+	//the mobs that could have the client in their box, in mob_list order like the full scan was
+	std::vector<AggroGridEntry> candidates(aggro_grid_wide);
+	auto cell = aggro_grid.find(AggroGridKey(AggroGridCell(around->GetX()), AggroGridCell(around->GetY())));
+	if (cell != aggro_grid.end()) {
+		candidates.insert(candidates.end(), cell->second.begin(), cell->second.end());
+		if (!aggro_grid_wide.empty())
+			std::sort(candidates.begin(), candidates.end(),
+				[](const AggroGridEntry &a, const AggroGridEntry &b) { return a.order < b.order; });
+	}
+
+	for (auto it = candidates.begin(); it != candidates.end(); ++it) {
+		//aggro can kill or depop mobs, so look each one up again
+		auto found = mob_list.find(it->id);
+		if (found == mob_list.end())
+			continue;
+		Mob *mob = found->second;
+		if (mob->IsClient() || mob->IsPet())
 			continue;
 		if (mob->CheckWillAggro(around) && !mob->CheckAggro(around))
 		{
@@ -428,11 +507,94 @@ bool Mob::CheckWillAggro(Mob *mob) {
 	return(false);
 }
 
+/*
+	Splits the npc to npc aggro scans of this mob pass in two. Here, before any mob
+	moves, every npc whose scan is due gets the npcs inside its aggro box and radius,
+	searched in parallel against one snapshot of positions. The scans themselves still
+	run from AI_Process() on this thread in the usual order and only call
+	CheckWillAggro() on that list, so faction, the THREATENLY roll and LOS are applied
+	exactly as before. A npc that walks into range during the pass is found by the next
+	scan instead of this one.
+*/
+void EntityList::ThinkAggroScans() {
+	ai_aggro_scans.clear();
+
+	int thread_count = RuleI(Aggro, ScanThreads);
+	if (thread_count <= 0) {
+		aggro_scan_pool.SetThreads(0);
+		return;
+	}
+	aggro_scan_pool.SetThreads(thread_count);
+
+	struct Position {
+		uint16 id;
+		float x, y, z;
+	};
+
+	struct Scan {
+		uint16 id;
+		float x, y, z;
+		float range;
+		std::vector<uint16> *found;
+	};
+
+	std::vector<Scan> scans;
+	for (auto it = npc_list.begin(); it != npc_list.end(); ++it) {
+		NPC *npc = it->second;
+		if (!npc->IsAIControlled() || !npc->WillAggroNPCs() || npc->IsEngaged() || !npc->AIScanAreaDue())
+			continue;
+
+		Scan scan = { it->first, npc->GetX(), npc->GetY(), npc->GetZ(), npc->GetAggroRange(), nullptr };
+		scans.push_back(scan);
+	}
+
+	if (scans.empty())
+		return;
+
+	std::vector<Position> positions;
+	positions.reserve(npc_list.size());
+	for (auto it = npc_list.begin(); it != npc_list.end(); ++it) {
+		Position pos = { it->first, it->second->GetX(), it->second->GetY(), it->second->GetZ() };
+		positions.push_back(pos);
+	}
+
+	//the map is only touched here, the workers each fill the list they were handed
+	for (size_t i = 0; i < scans.size(); ++i)
+		scans[i].found = &ai_aggro_scans[scans[i].id];
+
+	aggro_scan_pool.Run(scans.size(), 4, [&scans, &positions](uint32 i) {
+		const Scan &scan = scans[i];
+		float range2 = scan.range * scan.range;
+		for (size_t j = 0; j < positions.size(); ++j) {
+			const Position &pos = positions[j];
+			//the same box and radius CheckWillAggro() rejects on first
+			float dx = std::abs(pos.x - scan.x);
+			float dy = std::abs(pos.y - scan.y);
+			float dz = std::abs(pos.z - scan.z);
+			if (dx > scan.range || dy > scan.range || dz > scan.range)
+				continue;
+			if (dx * dx + dy * dy + dz * dz > range2)
+				continue;
+			scan.found->push_back(pos.id);
+		}
+	});
+}
+
 // This is for npc_aggro npc->npc only.
 Mob* EntityList::AICheckCloseAggro(Mob* sender, float iAggroRange, float iAssistRange) {
 	if (!sender || !sender->IsNPC())
 		return(nullptr);
 
+	auto scan = ai_aggro_scans.find(sender->GetID());
+	if (scan != ai_aggro_scans.end()) {
+		for (size_t i = 0; i < scan->second.size(); ++i) {
+			NPC *mob = GetNPCByID(scan->second[i]);
+			if (mob && sender->CheckWillAggro(mob))
+				return mob;
+		}
+		return nullptr;
+	}
+
 
 	//npc->client is checked elsewhere, no need to check again
 	auto it = npc_list.begin();
@@ -1070,10 +1232,8 @@ bool Mob::CheckRegion(Mob* other, bool skipwater) {
 
 	WaterRegionType ThisRegionType;
 	WaterRegionType OtherRegionType;
-	auto position = glm::vec3(GetX(), GetY(), GetZ());
-	auto other_position = glm::vec3(other->GetX(), other->GetY(), other->GetZ());
-	ThisRegionType = zone->watermap->ReturnRegionType(position);
-	OtherRegionType = zone->watermap->ReturnRegionType(other_position);
+	ThisRegionType = GetRegionType();
+	OtherRegionType = other->GetRegionType();
 
 	Log.Out(Logs::Moderate, Logs::Maps, "Caster Region: %d Other Region: %d", ThisRegionType, OtherRegionType);
 
@@ -1103,9 +1263,10 @@ bool Mob::CheckLosFN(float posX, float posY, float posZ, float mobSize) {
 	}
 	else
 	{
-		if((zone->watermap && !zone->watermap->InWater(myloc) && !zone->watermap->InVWater(myloc)
-			&& !zone->watermap->InWater(oloc) && !zone->watermap->InVWater(oloc))
-			|| !zone->watermap)
+		WaterRegionType my_region = GetRegionType();
+		WaterRegionType other_region = zone->watermap ? zone->watermap->ReturnRegionType(oloc) : RegionTypeNormal;
+		if(my_region != RegionTypeWater && my_region != RegionTypeVWater
+			&& other_region != RegionTypeWater && other_region != RegionTypeVWater)
 		{
 			mybestz = zone->zonemap->FindBestZ(myloc, nullptr);
 			obestz = zone->zonemap->FindBestZ(oloc, nullptr);
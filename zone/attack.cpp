@@ -2153,7 +2153,7 @@ void Mob::AddToHateList(Mob* other, int32 hate, int32 damage, bool iYellForHelp,
 	}
 
 	if(IsNPC() && CastToNPC()->IsUnderwaterOnly() && zone->HasWaterMap()) {
-		if(!zone->watermap->InLiquid(glm::vec3(other->GetPosition()))) {
+		if(!other->IsInLiquid()) {
 			return;
 		}
 	}
@@ -0,0 +1,432 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "../common/global_define.h"
+#include "../common/eq_constants.h"
+#include "../common/item_struct.h"
+
+#include "bazaar_index.h"
+#include "zonedb.h"
+
+#include <ctype.h>
+#include <string.h>
+
+BazaarIndex::BazaarIndex() {
+	live_count = 0;
+}
+
+uint32 BazaarIndex::PriceBucket(uint32 cost) {
+	uint32 bucket = 0;
+	while (cost) {
+		bucket++;
+		cost >>= 1;
+	}
+	return bucket;
+}
+
+//case insensitive substring match, the way items.name LIKE '%name%' matched it.
+//apostrophes were turned into the LIKE single character wildcard, so they still match anything
+static bool NameMatches(const char *name, const std::string &pattern) {
+	size_t len = strlen(name);
+	if (pattern.length() > len)
+		return false;
+
+	for (size_t start = 0; start + pattern.length() <= len; start++) {
+		size_t i = 0;
+		for (; i < pattern.length(); i++) {
+			if (pattern[i] != '\'' && tolower(name[start + i]) != tolower(pattern[i]))
+				break;
+		}
+		if (i == pattern.length())
+			return true;
+	}
+	return false;
+}
+
+//the items table has no endurance, attack, regen, haste or damage shield columns,
+//those searches always came back empty and still do
+static bool HasStat(const Item_Struct *item, uint32 stat) {
+	switch (stat) {
+		case 0xFFFF:		return true;
+		case STAT_AC:		return item->AC > 0;
+		case STAT_AGI:		return item->AAgi > 0;
+		case STAT_CHA:		return item->ACha > 0;
+		case STAT_DEX:		return item->ADex > 0;
+		case STAT_INT:		return item->AInt > 0;
+		case STAT_STA:		return item->ASta > 0;
+		case STAT_STR:		return item->AStr > 0;
+		case STAT_WIS:		return item->AWis > 0;
+		case STAT_COLD:		return item->CR > 0;
+		case STAT_DISEASE:	return item->DR > 0;
+		case STAT_FIRE:		return item->FR > 0;
+		case STAT_MAGIC:	return item->MR > 0;
+		case STAT_POISON:	return item->PR > 0;
+		case STAT_HP:		return item->HP > 0;
+		case STAT_MANA:		return item->Mana > 0;
+		default:			return false;
+	}
+}
+
+static bool HasType(const Item_Struct *item, uint32 type) {
+	switch (type) {
+		case 0xFFFF:
+			return true;
+		case 0:
+			// 1H Slashing
+			return item->ItemType == 0 && item->Damage > 0;
+		case 31:
+			return item->ItemClass == 2;
+		case 46:
+		case 47:
+		case 48:
+			//spell searches, keyed on items.spellid which this items table does not have
+			return false;
+		case 49:
+			return item->Focus.Effect > 0;
+		default:
+			return item->ItemType == type;
+	}
+}
+
+static bool HasBit(uint32 mask, uint32 bit) {
+	return bit < 32 && (mask & (1 << bit)) != 0;
+}
+
+bool BazaarIndex::Matches(const Entry &entry, const Filter &filter) {
+	const Item_Struct *item = entry.item;
+	if (item == nullptr)
+		return false;
+
+	if (filter.char_id != 0 && entry.char_id != filter.char_id)
+		return false;
+	if (filter.min_price != 0 && entry.cost < filter.min_price)
+		return false;
+	if (filter.max_price != 0 && entry.cost > filter.max_price)
+		return false;
+
+	//class and race are 1 based, slot is 0 based
+	if (filter.class_ != 0xFFFF && (filter.class_ == 0 || !HasBit(item->Classes, filter.class_ - 1)))
+		return false;
+	if (filter.race != 0xFFFF && (filter.race == 0 || !HasBit(item->Races, filter.race - 1)))
+		return false;
+	if (filter.slot != 0xFFFF && !HasBit(item->Slots, filter.slot))
+		return false;
+
+	if (!HasType(item, filter.type) || !HasStat(item, filter.stat))
+		return false;
+
+	return filter.name.empty() || NameMatches(item->Name, filter.name);
+}
+
+void BazaarIndex::Link(uint32 index) {
+	const Entry &entry = entries[index];
+	if (entry.item == nullptr)
+		return;
+
+	for (uint32 bit = 0; bit < 32; bit++) {
+		if (HasBit(entry.item->Classes, bit))
+			class_postings[bit].insert(index);
+		if (HasBit(entry.item->Races, bit))
+			race_postings[bit].insert(index);
+		if (HasBit(entry.item->Slots, bit))
+			slot_postings[bit].insert(index);
+	}
+	type_postings[entry.item->ItemType].insert(index);
+	price_postings[PriceBucket(entry.cost)].insert(index);
+}
+
+void BazaarIndex::Unlink(uint32 index) {
+	const Entry &entry = entries[index];
+	if (entry.item == nullptr)
+		return;
+
+	for (uint32 bit = 0; bit < 32; bit++) {
+		if (HasBit(entry.item->Classes, bit))
+			class_postings[bit].erase(index);
+		if (HasBit(entry.item->Races, bit))
+			race_postings[bit].erase(index);
+		if (HasBit(entry.item->Slots, bit))
+			slot_postings[bit].erase(index);
+	}
+	type_postings[entry.item->ItemType].erase(index);
+	price_postings[PriceBucket(entry.cost)].erase(index);
+}
+
+void BazaarIndex::Release(uint32 index) {
+	Unlink(index);
+	entries[index].item = nullptr;
+	entries[index].char_id = 0;
+	free_entries.push_back(index);
+	live_count--;
+}
+
+BazaarIndex::Entry *BazaarIndex::Find(uint32 char_id, uint8 slot) {
+	if (slot >= BAZAAR_TRADER_SLOTS)
+		return nullptr;
+
+	auto it = traders.find(char_id);
+	if (it == traders.end() || it->second.entries[slot] == 0)
+		return nullptr;
+
+	return &entries[it->second.entries[slot] - 1];
+}
+
+const BazaarIndex::Entry *BazaarIndex::GetEntry(uint32 char_id, uint8 slot) const {
+	return const_cast<BazaarIndex *>(this)->Find(char_id, slot);
+}
+
+const BazaarIndex::Entry *BazaarIndex::FindSerial(uint32 char_id, uint32 serial_number) const {
+	auto it = traders.find(char_id);
+	if (it == traders.end())
+		return nullptr;
+
+	//lowest slot first, like the ORDER BY slot_id this replaces
+	for (int i = 0; i < BAZAAR_TRADER_SLOTS; i++) {
+		uint32 index = it->second.entries[i];
+		if (index != 0 && entries[index - 1].serial_number == serial_number)
+			return &entries[index - 1];
+	}
+	return nullptr;
+}
+
+void BazaarIndex::Add(uint32 char_id, uint8 slot, uint32 item_id, uint32 serial_number, int32 charges, uint32 cost) {
+	if (slot >= BAZAAR_TRADER_SLOTS)
+		return;
+
+	//same primary key as the table, a second save to a slot replaces it
+	Remove(char_id, slot);
+
+	uint32 index;
+	if (!free_entries.empty()) {
+		index = free_entries.back();
+		free_entries.pop_back();
+	}
+	else {
+		index = entries.size();
+		entries.push_back(Entry());
+	}
+
+	auto it = traders.find(char_id);
+	if (it == traders.end()) {
+		Trader trader;
+		memset(&trader, 0, sizeof(trader));
+		it = traders.insert(std::make_pair(char_id, trader)).first;
+	}
+	it->second.entries[slot] = index + 1;
+	it->second.count++;
+
+	Entry &entry = entries[index];
+	entry.char_id = char_id;
+	entry.item_id = item_id;
+	entry.serial_number = serial_number;
+	entry.charges = charges;
+	entry.cost = cost;
+	entry.slot = slot;
+	entry.item = database.GetItem(item_id);
+	live_count++;
+
+	Link(index);
+}
+
+void BazaarIndex::Remove(uint32 char_id, uint8 slot) {
+	if (slot >= BAZAAR_TRADER_SLOTS)
+		return;
+
+	auto it = traders.find(char_id);
+	if (it == traders.end() || it->second.entries[slot] == 0)
+		return;
+
+	Release(it->second.entries[slot] - 1);
+	it->second.entries[slot] = 0;
+	if (--it->second.count == 0)
+		traders.erase(it);
+}
+
+void BazaarIndex::RemoveItem(uint32 char_id, uint32 item_id) {
+	auto it = traders.find(char_id);
+	if (it == traders.end())
+		return;
+
+	for (int i = 0; i < BAZAAR_TRADER_SLOTS; i++) {
+		uint32 index = it->second.entries[i];
+		if (index != 0 && entries[index - 1].item_id == item_id) {
+			Release(index - 1);
+			it->second.entries[i] = 0;
+			it->second.count--;
+		}
+	}
+	if (it->second.count == 0)
+		traders.erase(it);
+}
+
+void BazaarIndex::RemoveTrader(uint32 char_id) {
+	auto it = traders.find(char_id);
+	if (it == traders.end())
+		return;
+
+	for (int i = 0; i < BAZAAR_TRADER_SLOTS; i++) {
+		if (it->second.entries[i] != 0)
+			Release(it->second.entries[i] - 1);
+	}
+	traders.erase(it);
+}
+
+void BazaarIndex::Clear() {
+	entries.clear();
+	free_entries.clear();
+	traders.clear();
+	live_count = 0;
+
+	for (int i = 0; i < 32; i++) {
+		class_postings[i].clear();
+		race_postings[i].clear();
+		slot_postings[i].clear();
+	}
+	for (int i = 0; i < 256; i++)
+		type_postings[i].clear();
+	for (int i = 0; i < BAZAAR_PRICE_BUCKETS; i++)
+		price_postings[i].clear();
+}
+
+void BazaarIndex::SetCharges(uint32 char_id, uint32 serial_number, int32 charges) {
+	auto it = traders.find(char_id);
+	if (it == traders.end())
+		return;
+
+	for (int i = 0; i < BAZAAR_TRADER_SLOTS; i++) {
+		uint32 index = it->second.entries[i];
+		if (index != 0 && entries[index - 1].serial_number == serial_number)
+			entries[index - 1].charges = charges;
+	}
+}
+
+void BazaarIndex::SetPrice(uint32 char_id, uint32 item_id, uint32 cost) {
+	auto it = traders.find(char_id);
+	if (it == traders.end())
+		return;
+
+	for (int i = 0; i < BAZAAR_TRADER_SLOTS; i++) {
+		uint32 index = it->second.entries[i];
+		if (index == 0 || entries[index - 1].item_id != item_id)
+			continue;
+		//the price bucket may change, the other postings are keyed on the item
+		Unlink(index - 1);
+		entries[index - 1].cost = cost;
+		Link(index - 1);
+	}
+}
+
+void BazaarIndex::SetPrice(uint32 char_id, uint32 item_id, int32 charges, uint32 cost) {
+	auto it = traders.find(char_id);
+	if (it == traders.end())
+		return;
+
+	for (int i = 0; i < BAZAAR_TRADER_SLOTS; i++) {
+		uint32 index = it->second.entries[i];
+		if (index == 0 || entries[index - 1].item_id != item_id || entries[index - 1].charges != charges)
+			continue;
+		Unlink(index - 1);
+		entries[index - 1].cost = cost;
+		Link(index - 1);
+	}
+}
+
+void BazaarIndex::Search(const Filter &filter, uint32 limit, std::vector<Result> &out) const {
+	std::vector<uint32> candidates;
+	bool all = true;
+
+	//pick the shortest posting list the filters narrow the search to
+	const Postings *best = nullptr;
+	if (filter.class_ != 0xFFFF && filter.class_ >= 1 && filter.class_ <= 32)
+		best = &class_postings[filter.class_ - 1];
+	if (filter.race != 0xFFFF && filter.race >= 1 && filter.race <= 32 &&
+		(best == nullptr || race_postings[filter.race - 1].size() < best->size()))
+		best = &race_postings[filter.race - 1];
+	if (filter.slot != 0xFFFF && filter.slot < 32 &&
+		(best == nullptr || slot_postings[filter.slot].size() < best->size()))
+		best = &slot_postings[filter.slot];
+	if (filter.type != 0xFFFF && filter.type != 31 && filter.type != 49 && filter.type < 256 &&
+		(best == nullptr || type_postings[filter.type].size() < best->size()))
+		best = &type_postings[filter.type];
+	if (best) {
+		candidates.assign(best->begin(), best->end());
+		all = false;
+	}
+
+	if (filter.min_price != 0 || filter.max_price != 0) {
+		uint32 first = PriceBucket(filter.min_price);
+		uint32 last = filter.max_price != 0 ? PriceBucket(filter.max_price) : BAZAAR_PRICE_BUCKETS - 1;
+		size_t count = 0;
+		for (uint32 i = first; i <= last; i++)
+			count += price_postings[i].size();
+		if (all || count < candidates.size()) {
+			candidates.clear();
+			for (uint32 i = first; i <= last; i++)
+				candidates.insert(candidates.end(), price_postings[i].begin(), price_postings[i].end());
+			all = false;
+		}
+	}
+
+	if (filter.char_id != 0) {
+		auto it = traders.find(filter.char_id);
+		if (it == traders.end())
+			return;
+		if (all || candidates.size() > BAZAAR_TRADER_SLOTS) {
+			candidates.clear();
+			for (int i = 0; i < BAZAAR_TRADER_SLOTS; i++) {
+				if (it->second.entries[i] != 0)
+					candidates.push_back(it->second.entries[i] - 1);
+			}
+			all = false;
+		}
+	}
+
+	if (all) {
+		for (uint32 i = 0; i < entries.size(); i++) {
+			if (entries[i].char_id != 0)
+				candidates.push_back(i);
+		}
+	}
+
+	//group the way GROUP BY items.id, charges, char_id did, in the same order
+	std::map<std::pair<std::pair<uint32, int32>, uint32>, Result> groups;
+	for (size_t i = 0; i < candidates.size(); i++) {
+		const Entry &entry = entries[candidates[i]];
+		if (!Matches(entry, filter))
+			continue;
+
+		auto key = std::make_pair(std::make_pair(entry.item_id, entry.charges), entry.char_id);
+		auto group = groups.find(key);
+		if (group != groups.end()) {
+			group->second.count++;
+			continue;
+		}
+
+		Result result;
+		result.char_id = entry.char_id;
+		result.item_id = entry.item_id;
+		result.charges = entry.charges;
+		result.cost = entry.cost;
+		result.count = 1;
+		result.item = entry.item;
+		groups[key] = result;
+	}
+
+	for (auto it = groups.begin(); it != groups.end() && out.size() < limit; ++it)
+		out.push_back(it->second);
+}
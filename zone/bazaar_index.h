@@ -0,0 +1,130 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef BAZAAR_INDEX_H
+#define BAZAAR_INDEX_H
+
+/*
+	In memory copy of the trader table for the traders in this zone.
+
+	ZoneDatabase keeps it in step with every trader row it writes, so trader
+	windows and bazaar searches are answered from here and the table is only
+	written. The bazaar clears the table when it boots and traders can only
+	set up shop there, so the zone holding the traders holds all their rows.
+
+	Searches start from the shortest posting list the filters select (class,
+	race and slot bits, item type, price bucket or the one trader) and check
+	the remaining filters against the item of each candidate.
+*/
+
+#include "../common/types.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#define BAZAAR_TRADER_SLOTS 80
+#define BAZAAR_PRICE_BUCKETS 33	//one per bit length of the price, 0 through 32
+
+struct Item_Struct;
+
+class BazaarIndex
+{
+public:
+	struct Entry {
+		uint32	char_id;
+		uint32	item_id;
+		uint32	serial_number;
+		int32	charges;
+		uint32	cost;
+		uint8	slot;
+		const Item_Struct *item;	//nullptr when the item no longer exists, never matches a search
+	};
+
+	//0xFFFF means any for class, race, slot, type and stat, 0 means any for the rest
+	struct Filter {
+		uint32	char_id;
+		uint32	class_;
+		uint32	race;
+		uint32	slot;
+		uint32	type;
+		uint32	stat;
+		uint32	min_price;
+		uint32	max_price;
+		std::string	name;
+	};
+
+	//one line of the search window: a trader's copies of an item with the same charges
+	struct Result {
+		uint32	char_id;
+		uint32	item_id;
+		int32	charges;
+		uint32	cost;
+		uint32	count;
+		const Item_Struct *item;
+	};
+
+	BazaarIndex();
+
+	void	Add(uint32 char_id, uint8 slot, uint32 item_id, uint32 serial_number, int32 charges, uint32 cost);
+	void	Remove(uint32 char_id, uint8 slot);
+	void	RemoveItem(uint32 char_id, uint32 item_id);
+	void	RemoveTrader(uint32 char_id);
+	void	Clear();
+	void	SetCharges(uint32 char_id, uint32 serial_number, int32 charges);
+	void	SetPrice(uint32 char_id, uint32 item_id, uint32 cost);
+	void	SetPrice(uint32 char_id, uint32 item_id, int32 charges, uint32 cost);
+
+	const Entry *GetEntry(uint32 char_id, uint8 slot) const;
+	const Entry *FindSerial(uint32 char_id, uint32 serial_number) const;
+
+	//results are in item id, charges, trader order, cut at limit
+	void	Search(const Filter &filter, uint32 limit, std::vector<Result> &out) const;
+
+	inline uint32	GetCount() const	{ return live_count; }
+	inline uint32	GetTraderCount() const	{ return traders.size(); }
+
+private:
+	typedef std::set<uint32> Postings;
+
+	struct Trader {
+		uint32 entries[BAZAAR_TRADER_SLOTS];	//entry index + 1, 0 for an empty slot
+		uint32 count;
+	};
+
+	void	Link(uint32 index);
+	void	Unlink(uint32 index);
+	void	Release(uint32 index);
+	Entry	*Find(uint32 char_id, uint8 slot);
+
+	static uint32	PriceBucket(uint32 cost);
+	static bool	Matches(const Entry &entry, const Filter &filter);
+
+	std::vector<Entry>	entries;
+	std::vector<uint32>	free_entries;
+	std::map<uint32, Trader>	traders;
+	uint32	live_count;
+
+	Postings	class_postings[32];
+	Postings	race_postings[32];
+	Postings	slot_postings[32];
+	Postings	type_postings[256];
+	Postings	price_postings[BAZAAR_PRICE_BUCKETS];
+};
+
+#endif
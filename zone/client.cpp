@@ -38,6 +38,7 @@ extern volatile bool RunLoops;
 #include "../common/rulesys.h"
 #include "../common/string_util.h"
 #include "../common/data_verification.h"
+#include "../common/eq_broadcast_packet.h"
 #include "position.h"
 #include "net.h"
 #include "worldserver.h"
@@ -51,6 +52,7 @@ extern volatile bool RunLoops;
 #include "../common/crc32.h"
 #include "../common/packet_dump_file.h"
 #include "queryserv.h"
+#include "opcode_metrics.h"
 
 extern QueryServ* QServ;
 extern EntityList entity_list;
@@ -162,6 +164,8 @@ Client::Client(EQStreamInterface* ieqs)
 	port = ntohs(eqs->GetRemotePort());
 	client_state = CLIENT_CONNECTING;
 	Trader=false;
+	faction_con_version = 1;
+	faction_con_appearance = 0;
 	CustomerID = 0;
 	WID = 0;
 	account_id = 0;
@@ -567,8 +571,10 @@ bool Client::SendAllPackets() {
 	iterator.Reset();
 	while(iterator.MoreElements()) {
 		cp = iterator.GetData();
-		if(eqs)
+		if(eqs) {
+			OpcodeMetrics::AddOutbound(cp->app->GetOpcode(), cp->app->size);
 			eqs->FastQueuePacket((EQApplicationPacket **)&cp->app, cp->ack_req);
+		}
 		iterator.RemoveCurrent();
 		Log.Out(Logs::Moderate, Logs::Client_Server_Packet, "Transmitting a packet");
 	}
@@ -606,8 +612,25 @@ void Client::QueuePacket(const EQApplicationPacket* app, bool ack_req, CLIENT_CO
 		AddPacket(app, ack_req);
 	}
 	else
-		if(eqs)
+		if(eqs) {
+			OpcodeMetrics::AddOutbound(app->GetOpcode(), app->size);
 			eqs->QueuePacket(app, ack_req);
+		}
+}
+
+//broadcast helpers, the stream reuses the encoding of earlier clients on the same version
+void Client::QueuePacket(EQBroadcastPacket* bp, bool ack_req, CLIENT_CONN_STATUS required_state) {
+	const EQApplicationPacket *app = bp->GetSource();
+
+	//anything that would be held back or dropped goes through the normal path
+	if (client_state != CLIENT_CONNECTED || !eqs ||
+		(required_state != CLIENT_CONNECTINGALL && required_state != CLIENT_CONNECTED)) {
+		QueuePacket(app, ack_req, required_state);
+		return;
+	}
+
+	OpcodeMetrics::AddOutbound(app->GetOpcode(), app->size);
+	eqs->QueueBroadcast(bp, ack_req);
 }
 
 void Client::FastQueuePacket(EQApplicationPacket** app, bool ack_req, CLIENT_CONN_STATUS required_state) {
@@ -636,8 +659,10 @@ void Client::FastQueuePacket(EQApplicationPacket** app, bool ack_req, CLIENT_CON
 	}
 	else if (app != nullptr && *app != nullptr)
 	{
-		if(eqs)
+		if(eqs) {
+			OpcodeMetrics::AddOutbound((*app)->GetOpcode(), (*app)->size);
 			eqs->FastQueuePacket((EQApplicationPacket **)app, ack_req);
+		}
 		else if (app && (*app))
 			delete *app;
 		*app = 0;
@@ -4309,7 +4334,11 @@ FACTION_VALUE Client::GetFactionLevel(uint32 char_id, uint32 npc_id, uint32 p_ra
 	}
 
 	//First get the NPC's Primary faction
-	if(pFaction > 0)
+	if(pFaction > 0 && char_id == CharacterID() && p_race == GetRace() && p_class == GetClass() && p_deity == GetDeity())
+	{
+		fac = GetPrimaryFactionCon(pFaction);
+	}
+	else if(pFaction > 0)
 	{
 		//Get the faction data from the database
 		if(database.GetFactionData(&fmods, p_class, p_race, p_deity, pFaction, GetTexture(), GetGender()))
@@ -4338,6 +4367,50 @@ FACTION_VALUE Client::GetFactionLevel(uint32 char_id, uint32 npc_id, uint32 p_ra
 	return fac;
 }
 
+// Our own con with a primary faction, ignoring feign, invis, pets and the npc's aggro checks.
+// Cached per faction id until a faction hit, a bonus change or a new race, class,
+// deity, texture or gender (illusions) bumps the version.
+FACTION_VALUE Client::GetPrimaryFactionCon(int32 faction_id)
+{
+	uint64 appearance = (static_cast<uint64>(GetRace()) << 40) | (static_cast<uint64>(GetDeity()) << 24) |
+		(static_cast<uint64>(GetClass()) << 16) | (static_cast<uint64>(GetTexture()) << 8) | GetGender();
+	if (appearance != faction_con_appearance) {
+		faction_con_appearance = appearance;
+		InvalidateFactionCon();
+	}
+
+	// faction ids are small and dense, anything unusual just isn't cached
+	bool cacheable = faction_id <= 0xFFFF;
+	if (cacheable) {
+		if (faction_id >= static_cast<int32>(faction_con_cache.size())) {
+			FactionConCache empty = { 0, FACTION_INDIFFERENT };
+			faction_con_cache.resize(faction_id + 1, empty);
+		}
+		if (faction_con_cache[faction_id].version == faction_con_version)
+			return faction_con_cache[faction_id].con;
+	}
+
+	FACTION_VALUE fac = FACTION_INDIFFERENT;
+	FactionMods fmods;
+
+	//Get the faction data from the database
+	if(database.GetFactionData(&fmods, GetClass(), GetRace(), GetDeity(), faction_id, GetTexture(), GetGender()))
+	{
+		//Get the players current faction with pFaction
+		int32 tmpFactionValue = GetCharacterFactionLevel(faction_id);
+		//Tack on any bonuses from Alliance type spell effects
+		tmpFactionValue += GetFactionBonus(faction_id);
+		tmpFactionValue += GetItemFactionBonus(faction_id);
+		fac = CalculateFaction(&fmods, tmpFactionValue);
+	}
+
+	if (cacheable) {
+		faction_con_cache[faction_id].version = faction_con_version;
+		faction_con_cache[faction_id].con = fac;
+	}
+	return fac;
+}
+
 //Sets the characters faction standing with the specified NPC.
 void Client::SetFactionLevel(uint32 char_id, uint32 npc_id, uint8 char_class, uint8 char_race, uint8 char_deity, bool quest)
 {
@@ -4499,6 +4572,7 @@ void Client::UpdatePersonalFaction(int32 char_id, int32 npc_value, int32 faction
 			*current_value = this_faction_min;
 
 		database.SetCharacterFactionLevel(char_id, faction_id, *current_value, temp, factionvalues);
+		InvalidateFactionCon();
 	}
 
 return;
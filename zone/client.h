@@ -20,6 +20,7 @@
 
 class Client;
 class EQApplicationPacket;
+class EQBroadcastPacket;
 class EQStream;
 class Group;
 class Mob;
@@ -241,6 +242,7 @@ public:
 	void SendPacketQueue(bool Block = true);
 	void QueuePacket(const EQApplicationPacket* app, bool ack_req = true, CLIENT_CONN_STATUS = CLIENT_CONNECTINGALL, eqFilterType filter=FilterNone);
 	void FastQueuePacket(EQApplicationPacket** app, bool ack_req = true, CLIENT_CONN_STATUS = CLIENT_CONNECTINGALL);
+	void QueuePacket(EQBroadcastPacket* bp, bool ack_req = true, CLIENT_CONN_STATUS = CLIENT_CONNECTINGALL);
 	void ChannelMessageReceived(uint8 chan_num, uint8 language, uint8 lang_skill, const char* orig_message, const char* targetname=nullptr);
 	void ChannelMessageSend(const char* from, const char* to, uint8 chan_num, uint8 language, const char* message, ...);
 	void ChannelMessageSend(const char* from, const char* to, uint8 chan_num, uint8 language, uint8 lang_skill, const char* message, ...);
@@ -537,6 +539,7 @@ public:
 	void UpdatePersonalFaction(int32 char_id, int32 npc_value, int32 faction_id, int32 *current_value, int32 temp, int32 this_faction_min, int32 this_faction_max);
 	void SetFactionLevel(uint32 char_id, uint32 npc_id, uint8 char_class, uint8 char_race, uint8 char_deity, bool quest = false);
 	void SetFactionLevel2(uint32 char_id, int32 faction_id, uint8 char_class, uint8 char_race, uint8 char_deity, int32 value, uint8 temp);
+	inline void InvalidateFactionCon() { faction_con_version++; }
 	int32 GetRawItemAC();
 	uint16 GetCombinedAC_TEST();
 
@@ -1159,6 +1162,17 @@ private:
 
 	faction_map factionvalues;
 
+	// con with each primary faction from personal value, bonuses and
+	// faction mods, before the per npc checks in GetFactionLevel
+	struct FactionConCache {
+		uint32 version;
+		FACTION_VALUE con;
+	};
+	FACTION_VALUE GetPrimaryFactionCon(int32 faction_id);
+	std::vector<FactionConCache> faction_con_cache; // indexed by faction id
+	uint32 faction_con_version; // bumped by faction hits and bonus changes
+	uint64 faction_con_appearance; // race, class, deity, texture and gender the cache holds
+
 	FILE *SQL_log;
 	uint32 max_AAXP;
 	uint32 staminacount;
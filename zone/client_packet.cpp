@@ -60,6 +60,8 @@
 #include "water_map.h"
 #include "worldserver.h"
 #include "zone.h"
+#include "opcode_metrics.h"
+#include "zone_profiler.h"
 #include "remote_call_subscribe.h"
 #include "remote_call_subscribe.h"
 #include "../common/misc.h"
@@ -73,14 +75,13 @@ extern PetitionList petition_list;
 extern EntityList entity_list;
 typedef void (Client::*ClientPacketProc)(const EQApplicationPacket *app);
 
-//Use a map for connecting opcodes since it doesn't get used a lot and is sparse
-std::map<uint32, ClientPacketProc> ConnectingOpcodes;
-//Use a static array for connected, for speed
+//Use static arrays for both states, dispatch is a single index either way
+ClientPacketProc ConnectingOpcodes[_maxEmuOpcode];
 ClientPacketProc ConnectedOpcodes[_maxEmuOpcode];
 
 void MapOpcodes()
 {
-	ConnectingOpcodes.clear();
+	memset(ConnectingOpcodes, 0, sizeof(ConnectingOpcodes));
 	memset(ConnectedOpcodes, 0, sizeof(ConnectedOpcodes));
 
 	// Now put all the opcodes into their home...
@@ -275,15 +276,14 @@ void ClearMappedOpcode(EmuOpcode op)
 		return;
 
 	ConnectedOpcodes[op] = nullptr;
-	auto iter = ConnectingOpcodes.find(op);
-	if (iter != ConnectingOpcodes.end()) {
-		ConnectingOpcodes.erase(iter);
-	}
+	ConnectingOpcodes[op] = nullptr;
 }
 
 // client methods
 int Client::HandlePacket(const EQApplicationPacket *app)
 {
+	PROFILE_PHASE(PacketDispatch);
+
 	if (Log.log_settings[Logs::LogCategory::Netcode].is_category_enabled == 1) {
 		char buffer[64];
 		app->build_header_dump(buffer);
@@ -303,6 +303,7 @@ int Client::HandlePacket(const EQApplicationPacket *app)
 		}
 	
 	EmuOpcode opcode = app->GetOpcode();
+	OpcodeMetrics::ScopedInbound opcode_metrics(opcode, app->size);
 
 	#if EQDEBUG >= 11
 		std::cout << "Received 0x" << std::hex << std::setw(4) << std::setfill('0') << opcode << ", size=" << std::dec << app->size << std::endl;
@@ -319,7 +320,9 @@ int Client::HandlePacket(const EQApplicationPacket *app)
 
 	switch(client_state) {
 	case CLIENT_CONNECTING: {
-		if(ConnectingOpcodes.count(opcode) != 1) {
+		ClientPacketProc p;
+		p = ConnectingOpcodes[opcode];
+		if(p == nullptr) {
 			//Hate const cast but everything in lua needs to be non-const even if i make it non-mutable
 			std::vector<EQEmu::Any> args;
 			args.push_back(const_cast<EQApplicationPacket*>(app));
@@ -334,9 +337,6 @@ int Client::HandlePacket(const EQApplicationPacket *app)
 			break;
 		}
 
-		ClientPacketProc p;
-		p = ConnectingOpcodes[opcode];
-
 		//call the processing routine
 		(this->*p)(app);
 
@@ -996,6 +996,7 @@ void Client::Handle_Connect_OP_ZoneEntry(const EQApplicationPacket *app)
 	/* Flush and reload factions */
 	database.RemoveTempFactions(this);
 	database.LoadCharacterFactionValues(cid, factionvalues);
+	InvalidateFactionCon();
 
 	/* Load Character Account Data: Temp until I move */
 	query = StringFormat("SELECT `status`, `name`, `lsaccount_id`, `gmspeed`, `revoked`, `hideme`, `time_creation`, `gminvul`, `flymode`, `ignore_tells` FROM `account` WHERE `id` = %u", this->AccountID());
@@ -1473,7 +1474,7 @@ void Client::Handle_Connect_OP_ZoneEntry(const EQApplicationPacket *app)
 	{
 		// This prevents hopping on logging in.
 		glm::vec3 loc(m_Position.x, m_Position.y, m_Position.z);
-		if (!IsEncumbered() && m_pp.boatid == 0 && (!zone->HasWaterMap() || !zone->watermap->InLiquid(loc)) && 
+		if (!IsEncumbered() && m_pp.boatid == 0 && !IsInLiquid() && 
 			zone->GetZoneID() != hole && zone->GetZoneID() != freporte)
 		{
 			float bestz = zone->zonemap->FindBestZ(loc, nullptr);
@@ -6472,14 +6473,7 @@ void Client::Handle_OP_RaidCommand(const EQApplicationPacket *app)
 											}
 										}
 										else{
-											ServerPacket *pack = new ServerPacket(ServerOP_RaidChangeGroup, sizeof(ServerRaidGeneralAction_Struct));
-											ServerRaidGeneralAction_Struct *rga = (ServerRaidGeneralAction_Struct*)pack->pBuffer;
-											rga->rid = r->GetID();
-											strn0cpy(rga->playername, r->members[x].membername, 64);
-											rga->zoneid = zone->GetZoneID();
-											rga->instance_id = zone->GetInstanceID();
-											worldserver.SendPacket(pack);
-											safe_delete(pack);
+											r->SendMemberAction(ServerOP_RaidChangeGroup, r->members[x].membername);
 										}
 										break;
 									}
@@ -6538,14 +6532,7 @@ void Client::Handle_OP_RaidCommand(const EQApplicationPacket *app)
 								}
 							}
 							else{
-								ServerPacket *pack = new ServerPacket(ServerOP_RaidChangeGroup, sizeof(ServerRaidGeneralAction_Struct));
-								ServerRaidGeneralAction_Struct *rga = (ServerRaidGeneralAction_Struct*)pack->pBuffer;
-								rga->rid = r->GetID();
-								strn0cpy(rga->playername, r->members[x].membername, 64);
-								rga->zoneid = zone->GetZoneID();
-								rga->instance_id = zone->GetInstanceID();
-								worldserver.SendPacket(pack);
-								safe_delete(pack);
+								r->SendMemberAction(ServerOP_RaidChangeGroup, r->members[x].membername);
 							}
 							break;
 						}
@@ -7160,38 +7147,32 @@ void Client::Handle_OP_ShopPlayerBuy(const EQApplicationPacket *app)
 
 	uint32 item_id = 0;
 	uint8 quantity_left = 0;
-	std::list<MerchantList> merlist = zone->merchanttable[merchantid];
-	std::list<MerchantList>::const_iterator itr;
-	for (itr = merlist.begin(); itr != merlist.end(); ++itr){
-		MerchantList ml = *itr;
-		if (GetLevel() < ml.level_required) {
-			continue;
-		}
-
+	const MerchantList *merchant_item = zone->GetMerchantSlot(merchantid, mp->itemslot);
+	if (merchant_item != nullptr) {
 		int32 fac = tmp->GetPrimaryFaction();
-		if (fac != 0 && GetModCharacterFactionLevel(fac) < ml.faction_required) {
-			continue;
+		if (GetLevel() < merchant_item->level_required) {
+			merchant_item = nullptr;
 		}
-
-		if(ml.quantity > 0 && ml.qty_left <= 0)
+		else if (fac != 0 && GetModCharacterFactionLevel(fac) < merchant_item->faction_required) {
+			merchant_item = nullptr;
+		}
+		else if(merchant_item->quantity > 0 && merchant_item->qty_left <= 0)
 		{
-			continue;
+			merchant_item = nullptr;
 		}
-
-		if (mp->itemslot == ml.slot){
-			item_id = ml.item;
-			if(ml.quantity > 0 && ml.qty_left > 0)
-			{
-				quantity_left = ml.qty_left;
-			}
-			break;
+	}
+	if (merchant_item != nullptr) {
+		item_id = merchant_item->item;
+		if(merchant_item->quantity > 0 && merchant_item->qty_left > 0)
+		{
+			quantity_left = merchant_item->qty_left;
 		}
 	}
 	const Item_Struct* item = nullptr;
 	uint32 prevcharges = 0;
 	if (item_id == 0) { //check to see if its on the temporary table
-		std::list<TempMerchantList> tmp_merlist = zone->tmpmerchanttable[tmp->GetNPCTypeID()];
-		std::list<TempMerchantList>::const_iterator tmp_itr;
+		const std::vector<TempMerchantList> &tmp_merlist = zone->tmpmerchanttable[tmp->GetNPCTypeID()];
+		std::vector<TempMerchantList>::const_iterator tmp_itr;
 		TempMerchantList ml;
 		for (tmp_itr = tmp_merlist.begin(); tmp_itr != tmp_merlist.end(); ++tmp_itr){
 			ml = *tmp_itr;
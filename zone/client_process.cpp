@@ -918,17 +918,15 @@ void Client::BulkSendMerchantInventory(int merchant_id, int npcid)
 	const Item_Struct* handyitem = nullptr;
 	uint32 numItemSlots = 79; //The max number of items passed in the transaction.
 	const Item_Struct *item;
-	std::list<MerchantList> merlist = zone->merchanttable[merchant_id];
-	std::list<MerchantList>::const_iterator itr;
 	Mob* merch = entity_list.GetMobByNpcTypeID(npcid);
-	if (merlist.size() == 0) { //Attempt to load the data, it might have been missed if someone spawned the merchant after the zone was loaded
+	if (zone->merchanttable[merchant_id].empty()) { //Attempt to load the data, it might have been missed if someone spawned the merchant after the zone was loaded
 		zone->LoadNewMerchantData(merchant_id);
-		merlist = zone->merchanttable[merchant_id];
-		if (merlist.size() == 0)
-			return;
 	}
-	std::list<TempMerchantList> tmp_merlist = zone->tmpmerchanttable[npcid];
-	std::list<TempMerchantList>::iterator tmp_itr;
+	const std::vector<MerchantList> &merlist = zone->merchanttable[merchant_id];
+	std::vector<MerchantList>::const_iterator itr;
+	if (merlist.size() == 0)
+		return;
+	std::vector<TempMerchantList> &tmp_merlist = zone->tmpmerchanttable[npcid];
 
 	uint32 size = 0;
 	uint16 m = 0;
@@ -938,7 +936,7 @@ void Client::BulkSendMerchantInventory(int merchant_id, int npcid)
 	uint32 i=1;
 	uint8 handychance = 0;
 	for (itr = merlist.begin(); itr != merlist.end() && i <= numItemSlots; ++itr) {
-		MerchantList ml = *itr;
+		const MerchantList &ml = *itr;
 
 		if (GetLevel() < ml.level_required)
 			continue;
@@ -1004,10 +1002,10 @@ void Client::BulkSendMerchantInventory(int merchant_id, int npcid)
 			i = ml.slot + 1;
 		}
 	}
-	std::list<TempMerchantList> origtmp_merlist = zone->tmpmerchanttable[npcid];
-	tmp_merlist.clear();
-	for (tmp_itr = origtmp_merlist.begin(); tmp_itr != origtmp_merlist.end() && i <= numItemSlots; ++tmp_itr) {
-		TempMerchantList ml = *tmp_itr;
+	//the temp items are renumbered to follow the list, anything that no longer fits is dropped
+	size_t tmp_count = 0;
+	for (; tmp_count < tmp_merlist.size() && i <= numItemSlots; ++tmp_count) {
+		TempMerchantList &ml = tmp_merlist[tmp_count];
 		item = database.GetItem(ml.item);
 		ml.slot = i;
 		if (item) {
@@ -1041,9 +1039,9 @@ void Client::BulkSendMerchantInventory(int merchant_id, int npcid)
 				Log.Out(Logs::General, Logs::Trading, "%s was added to merchant in slot %d with %d charges", item->Name, ml.slot, ml.charges);
 			}
 		}
-		tmp_merlist.push_back(ml);
 		i++;
 	}
+	tmp_merlist.resize(tmp_count);
 
 	uint8 lastslot = i;
 
@@ -1061,8 +1059,6 @@ void Client::BulkSendMerchantInventory(int merchant_id, int npcid)
 	safe_delete(delitempacket);
 	Log.Out(Logs::General, Logs::Trading, "Cleared last merchant slot %d", lastslot);
 
-	//this resets the slot
-	zone->tmpmerchanttable[npcid] = tmp_merlist;
 	if (merch != nullptr && handyitem) {
 		char handy_id[8] = { 0 };
 		int greeting = zone->random.Int(0, 4);
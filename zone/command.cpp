@@ -66,6 +66,8 @@
 #include "titles.h"
 #include "water_map.h"
 #include "worldserver.h"
+#include "opcode_metrics.h"
+#include "zone_profiler.h"
 
 extern WorldServer worldserver;
 void CatchSignal(int sig_num);
@@ -304,6 +306,7 @@ int command_init(void){
 		command_add("object", "List|Add|Edit|Move|Rotate|Copy|Save|Undo|Delete - Manipulate static and tradeskill objects within the zone.", 200, command_object) ||
 		command_add("oocmute", "[1/0] - Mutes OOC chat.", 95, command_oocmute) ||
 		command_add("opcode", "- opcode management.", 180, command_opcode) ||
+		command_add("opcodestats", "[in | out] [count] | reset - Show per opcode packet counts, bytes and handler time for this zone.", 150, command_opcodestats) ||
 		command_add("open_shop", nullptr, 250, command_merchantopenshop) ||
 		command_add("optest", "- solar's private test command.", 180, command_optest) ||
 
@@ -318,6 +321,7 @@ int command_init(void){
 		command_add("petition", "Handles everything petition related. Use with no args or with 'help' for how to use.", 20, command_petition) ||
 		command_add("peqzone", "[zonename] - Go to specified zone, if you have > 75% health.", 255, command_peqzone) ||
 		command_add("pf", "- Display additional mob coordinate and wandering data.", 95, command_pf) ||
+		command_add("profile", "[reset | zones [count]] - Show this zone's tick profile, reset it, or list the slowest zones reported to world.", 150, command_profile) ||
 #ifdef EQPROFILE
 		command_add("profiledump", "- Dump profiling info to logs.", 250, command_profiledump) ||
 		command_add("profilereset", "- Reset profiling info.", 250, command_profilereset) ||
@@ -7098,6 +7102,45 @@ void command_packetprofile(Client *c, const Seperator *sep){
 }
 #endif
 
+void command_profile(Client *c, const Seperator *sep){
+	if (strcasecmp(sep->arg[1], "reset") == 0) {
+		ZoneProfiler::Reset();
+		c->Message(CC_Default, "Zone profile reset.");
+	}
+	else if (strcasecmp(sep->arg[1], "zones") == 0) {
+		if (!worldserver.Connected()) {
+			c->Message(CC_Default, "Error: World server disconnected");
+			return;
+		}
+		ServerPacket* pack = new ServerPacket(ServerOP_ZoneProfileRequest, sizeof(ServerZoneProfileRequest_Struct));
+		ServerZoneProfileRequest_Struct* zpr = (ServerZoneProfileRequest_Struct*)pack->pBuffer;
+		strn0cpy(zpr->adminname, c->GetName(), sizeof(zpr->adminname));
+		zpr->count = sep->IsNumber(2) ? atoi(sep->arg[2]) : 10;
+		worldserver.SendPacket(pack);
+		safe_delete(pack);
+	}
+	else {
+		ZoneProfiler::SendStats(c);
+	}
+}
+
+void command_opcodestats(Client *c, const Seperator *sep){
+	if (strcasecmp(sep->arg[1], "reset") == 0) {
+		OpcodeMetrics::Reset();
+		c->Message(CC_Default, "Opcode stats reset.");
+		return;
+	}
+
+	bool show_outbound = strcasecmp(sep->arg[1], "out") == 0;
+	uint32 count = 10;
+	if (sep->IsNumber(1))
+		count = atoi(sep->arg[1]);
+	else if (sep->IsNumber(2))
+		count = atoi(sep->arg[2]);
+
+	OpcodeMetrics::SendStats(c, show_outbound, count);
+}
+
 #ifdef EQPROFILE
 void command_profiledump(Client *c, const Seperator *sep){
 	DumpZoneProfile();
@@ -10532,7 +10575,7 @@ void command_npctype_cache(Client *c, const Seperator *sep){
 	if (sep->argnum > 0) {
 		for (int i = 0; i < sep->argnum; ++i) {
 			if (strcasecmp(sep->arg[i + 1], "all") == 0) {
-				c->Message(CC_Default, "Clearing all npc types from the cache.");
+				c->Message(CC_Default, "Clearing all npc types from the cache. Types in shared memory are refreshed by #hotfix.");
 				zone->ClearNPCTypeCache(-1);
 			}
 			else {
@@ -328,6 +328,8 @@ void command_trapinfo(Client* c, const Seperator *sep);
 void command_reloadtraps(Client* c, const Seperator *sep);
 void command_godmode(Client* c, const Seperator *sep);
 void command_skill_difficulty(Client* c, const Seperator *sep);
+void command_profile(Client *c, const Seperator *sep);
+void command_opcodestats(Client *c, const Seperator *sep);
 
 #ifdef EQPROFILE
 void command_profiledump(Client *c, const Seperator *sep);
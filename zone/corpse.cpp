@@ -213,6 +213,7 @@ Corpse::Corpse(NPC* in_npc, ItemList* in_itemlist, uint32 in_npctypeid, const NP
 	memset(item_tint, 0, sizeof(item_tint));
 
 	is_corpse_changed = false;
+	save_queued = false;
 	is_player_corpse = false;
 	is_locked = false;
 	being_looted_by = 0xFFFFFFFF;
@@ -330,6 +331,7 @@ Corpse::Corpse(Client* client, int32 in_rezexp, uint8 in_killedby) : Mob (
 	}
 
 	is_corpse_changed		= true;
+	save_queued				= false;
 	rez_experience			= in_rezexp;
 	gm_rez_experience		= in_rezexp;
 	is_player_corpse	= true;
@@ -549,6 +551,7 @@ Corpse::Corpse(uint32 in_dbid, uint32 in_charid, const char* in_charname, ItemLi
 	memset(item_tint, 0, sizeof(item_tint));
 
 	is_corpse_changed = false;
+	save_queued = false;
 	is_player_corpse = true;
 	is_locked = false;
 	being_looted_by = 0xFFFFFFFF;
@@ -590,7 +593,7 @@ Corpse::Corpse(uint32 in_dbid, uint32 in_charid, const char* in_charname, ItemLi
 
 Corpse::~Corpse() {
 	if (is_player_corpse && !(player_corpse_depop && corpse_db_id == 0)) {
-		Save();
+		Flush();
 	}
 	ItemList::iterator cur, end;
 	cur = itemlist.begin();
@@ -625,6 +628,27 @@ bool Corpse::Save() {
 	if (!is_corpse_changed)
 		return true;
 
+	/* A new corpse is written at once for its db id, later changes wait for the zone's next corpse flush */
+	if (corpse_db_id == 0 || RuleI(Character, CorpseSaveDelayMS) <= 0)
+		return Flush();
+
+	if (!save_queued) {
+		zone->QueueCorpseSave(GetID());
+		save_queued = true;
+	}
+	return true;
+}
+
+bool Corpse::Flush() {
+	save_queued = false;
+	if (!is_player_corpse)
+		return true;
+	/* Deleted, buried or sent to the graveyard, nothing left to write */
+	if (player_corpse_depop && corpse_db_id == 0)
+		return true;
+	if (!is_corpse_changed)
+		return true;
+
 	uint32 tmp = this->CountItems();
 	uint32 tmpsize = sizeof(PlayerCorpse_Struct) + (tmp * sizeof(player_lootitem::ServerLootItem_Struct));
 
@@ -699,6 +723,7 @@ void Corpse::Delete() {
 
 void Corpse::Bury() {
 	if (IsPlayerCorpse() && corpse_db_id != 0){
+		Flush();
 		database.BuryCharacterCorpse(corpse_db_id);
 	}
 	corpse_db_id = 0;
@@ -867,7 +892,7 @@ bool Corpse::Process() {
 
 	if (corpse_graveyard_timer.Check()) {
 		if (zone->HasGraveyard()) {
-			Save();
+			Flush();
 			player_corpse_depop = true;
 			database.SendCharacterCorpseToGraveyard(corpse_db_id, zone->graveyard_zoneid(),
 				(zone->GetZoneID() == zone->graveyard_zoneid()) ? zone->GetInstanceID() : 0, zone->GetGraveyardPoint());
@@ -894,7 +919,7 @@ bool Corpse::Process() {
 			rez_time = corpse_rez_timer.GetRemainingTime();
 			corpse_rez_timer.Disable();
 			is_corpse_changed = true;
-			Save();
+			Flush();
 		}
 	}
 	//Player is online. If rez timer is disabled, enable it.
@@ -928,7 +953,7 @@ bool Corpse::Process() {
 		}
 		else {
 			if (database.BuryCharacterCorpse(corpse_db_id)) {
-				Save();
+				Flush();
 				player_corpse_depop = true;
 				corpse_db_id = 0;
 				Log.Out(Logs::General, Logs::Corpse, "Tagged %s player corpse has buried.", this->GetName());
@@ -1080,7 +1105,8 @@ void Corpse::MakeLootRequestPackets(Client* client, const EQApplicationPacket* a
 			}
 
 			RemoveCash();
-			Save();
+			/* Coin is already on the looter, the corpse row can't wait for the next flush */
+			Flush();
 		}
 
 		outapp->priority = 6;
@@ -1296,9 +1322,10 @@ void Corpse::LootItem(Client* client, const EQApplicationPacket* app) {
 		}
 
 		/* Remove it from Corpse */
+		std::vector<std::pair<int16, uint32>> looted;
 		if (item_data){
-			/* Delete needs to be before RemoveItem because its deletes the pointer for item_data/bag_item_data */
-			database.DeleteItemOffCharacterCorpse(this->corpse_db_id, item_data->equip_slot, item_data->item_id);
+			/* Record needs to be before RemoveItem because its deletes the pointer for item_data/bag_item_data */
+			looted.push_back(std::make_pair(item_data->equip_slot, item_data->item_id));
 			/* Delete Item Instance */
 			RemoveItem(item_data->lootslot);
 		}
@@ -1307,14 +1334,18 @@ void Corpse::LootItem(Client* client, const EQApplicationPacket* app) {
 		if (item->ItemClass == ItemClassContainer && (GetPlayerKillItem() != -1 || GetPlayerKillItem() != 1)) {
 			for (int i = SUB_BEGIN; i < EmuConstants::ITEM_CONTAINER_SIZE; i++) {
 				if (bag_item_data[i]) {
-					/* Delete needs to be before RemoveItem because its deletes the pointer for item_data/bag_item_data */
-					database.DeleteItemOffCharacterCorpse(this->corpse_db_id, bag_item_data[i]->equip_slot, bag_item_data[i]->item_id);
+					/* Record needs to be before RemoveItem because its deletes the pointer for item_data/bag_item_data */
+					looted.push_back(std::make_pair(bag_item_data[i]->equip_slot, bag_item_data[i]->item_id));
 					/* Delete Item Instance */
 					RemoveItem(bag_item_data[i]);
 				}
 			}
 		}
 
+		/* The looter's inventory is already saved, so the rows go now, a whole bag in one delete */
+		if (IsPlayerCorpse())
+			database.DeleteItemsOffCharacterCorpse(this->corpse_db_id, looted);
+
 		if (GetPlayerKillItem() != -1){
 			SetPlayerKillItemID(0);
 		}
@@ -1508,7 +1539,7 @@ void Corpse::CompleteResurrection(bool timer_expired)
 	IsRezzed(true); // Players can rez this corpse for no XP (corpse gate) provided rezzable is true.
 	rez_experience = 0;
 	is_corpse_changed = true;
-	this->Save();
+	this->Flush(); // not queued, a crash before the flush would let the corpse be rezzed for exp again
 }
 
 void Corpse::Spawn() {
@@ -67,6 +67,8 @@ class Corpse : public Mob {
 	virtual void	DepopPlayerCorpse();
 	bool			Process();
 	bool			Save();
+	bool			Flush();
+	inline bool		IsSaveQueued() const	{ return save_queued; }
 	uint32			GetCharID()					{ return char_id; }
 	uint32			SetCharID(uint32 iCharID)	{ if (IsPlayerCorpse()) { return (char_id = iCharID); } return 0xFFFFFFFF; };
 	uint32			GetDecayTime()				{ if (!corpse_decay_timer.Enabled()) return 0xFFFFFFFF; else return corpse_decay_timer.GetRemainingTime(); }
@@ -144,6 +146,7 @@ protected:
 private:
 	bool		is_player_corpse;
 	bool		is_corpse_changed;
+	bool		save_queued; /* Waiting in Zone::FlushCorpseSaves() */
 	bool		is_locked;
 	int32		player_kill_item;
 	uint32		corpse_db_id;
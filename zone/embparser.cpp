@@ -109,17 +109,60 @@ const char *QuestEventSubroutines[_LargestEventID] = {
 	"EVENT_TICK"
 };
 
+//indexed by PerlLazyVar
+static const char *PerlLazyVarNames[_PerlLazyVarCount] = {
+	"charid",
+	"uguild_id",
+	"uguildrank",
+	"status",
+	"name",
+	"race",
+	"class",
+	"ulevel",
+	"userid",
+	"mname",
+	"mobid",
+	"mlevel",
+	"hpratio",
+	"x",
+	"y",
+	"z",
+	"h",
+	"targetid",
+	"targetname",
+	"faction",
+	"zoneid",
+	"zoneln",
+	"zonesn",
+	"instanceid",
+	"instanceversion",
+	"zonehour",
+	"zonemin",
+	"zonetime",
+	"zoneweather"
+};
+
+//the magic callbacks only get an index back, this is who they report to
+static PerlembParser *lazy_var_parser = nullptr;
+
 PerlembParser::PerlembParser() : perl(nullptr) {
 	global_npc_quest_status_ = questUnloaded;
 	player_quest_status_ = questUnloaded;
 	global_player_quest_status_ = questUnloaded;
+	lazy_var_parser = this;
 }
 
 PerlembParser::~PerlembParser() {
+	if(lazy_var_parser == this)
+		lazy_var_parser = nullptr;
 	safe_delete(perl);
 }
 
 void PerlembParser::ReloadQuests() {
+	//every handle belongs to the interpreter being torn down
+	package_index_.clear();
+	package_vars_.clear();
+
 	try {
 		if(perl == nullptr) {
 			perl = new Embperl;
@@ -173,35 +216,50 @@ int PerlembParser::EventCommon(QuestEventID event, uint32 objid, const char * da
 		return 0;
 	}
 
-	int char_id = 0;
-	ExportCharID(package_name, char_id, npcmob, mob);
+	int char_id = GetCharID(npcmob, mob);
 	ExportQGlobals(isPlayerQuest, isGlobalPlayerQuest, isGlobalNPC, isItemQuest, isSpellQuest,
 		package_name, npcmob, mob, char_id);
 
-	//ExportGenericVariables();
-	ExportMobVariables(isPlayerQuest, isGlobalPlayerQuest, isGlobalNPC, isItemQuest, isSpellQuest,
-		package_name, mob, npcmob);
-	ExportZoneVariables(package_name);
-	ExportItemVariables(package_name, mob);
+	//mob and zone variables are filled in by FillLazyVar() when the script reads them
+	uint32 package = GetPackageVars(package_name);
+	PerlEventVars event_vars;
+	event_vars.npcmob = npcmob;
+	event_vars.mob = mob;
+	event_vars.npc_quest = !isPlayerQuest && !isGlobalPlayerQuest && !isItemQuest && !isSpellQuest;
+	SnapshotEventVars(event_vars);
+	PerlEventVars *outer_vars = package_vars_[package].event;
+	package_vars_[package].event = &event_vars;
+
+	ExportItemVariables(package, mob);
 	ExportEventVariables(package_name, event, objid, data, npcmob, iteminst, mob, extradata, extra_pointers);
 
+	int ret_value = 0;
 	if(isPlayerQuest || isGlobalPlayerQuest){
-		return SendCommands(package_name.c_str(), sub_name, 0, mob, mob, nullptr);
+		ret_value = SendCommands(package_name.c_str(), sub_name, 0, mob, mob, nullptr);
 	}
 	else if(isItemQuest) {
-		return SendCommands(package_name.c_str(), sub_name, 0, mob, mob, iteminst);
+		ret_value = SendCommands(package_name.c_str(), sub_name, 0, mob, mob, iteminst);
 	}
 	else if(isSpellQuest)
 	{
 		if(mob) {
-			return SendCommands(package_name.c_str(), sub_name, 0, mob, mob, nullptr);
+			ret_value = SendCommands(package_name.c_str(), sub_name, 0, mob, mob, nullptr);
 		} else {
-			return SendCommands(package_name.c_str(), sub_name, 0, npcmob, mob, nullptr);
+			ret_value = SendCommands(package_name.c_str(), sub_name, 0, npcmob, mob, nullptr);
 		}
 	}
 	else {
-		return SendCommands(package_name.c_str(), sub_name, objid, npcmob, mob, nullptr);
+		ret_value = SendCommands(package_name.c_str(), sub_name, objid, npcmob, mob, nullptr);
+	}
+
+	//a nested event in the same package overwrote the variables, let the outer one read its own again
+	if(package < package_vars_.size() && package_vars_[package].event == &event_vars) {
+		package_vars_[package].event = outer_vars;
+		if(outer_vars)
+			outer_vars->filled.reset();
 	}
+
+	return ret_value;
 }
 
 int PerlembParser::EventNPC(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
@@ -874,7 +932,8 @@ void PerlembParser::GetQuestPackageName(bool &isPlayerQuest, bool &isGlobalPlaye
 	}
 }
 
-void PerlembParser::ExportCharID(const std::string &package_name, int &char_id, NPC *npcmob, Mob *mob) {
+int PerlembParser::GetCharID(NPC *npcmob, Mob *mob) {
+	int char_id = 0;
 	if (mob && mob->IsClient()) {  // some events like waypoint and spawn don't have a player involved
 		char_id = mob->CastToClient()->CharacterID();
 	} else {
@@ -887,7 +946,7 @@ void PerlembParser::ExportCharID(const std::string &package_name, int &char_id,
 			char_id = -static_cast<int>(mob->CastToNPC()->GetNPCTypeID());  // make char id negative npc id as a fudge
 		}
 	}
-	ExportVar(package_name.c_str(), "charid", char_id);
+	return char_id;
 }
 
 void PerlembParser::ExportQGlobals(bool isPlayerQuest, bool isGlobalPlayerQuest, bool isGlobalNPC, bool isItemQuest,
@@ -1006,70 +1065,223 @@ void PerlembParser::ExportQGlobals(bool isPlayerQuest, bool isGlobalPlayerQuest,
 	}
 }
 
-void PerlembParser::ExportMobVariables(bool isPlayerQuest, bool isGlobalPlayerQuest, bool isGlobalNPC, bool isItemQuest,
-		bool isSpellQuest, std::string &package_name, Mob *mob, NPC *npcmob)
-{
-	uint8 fac = 0;
-	if (mob && mob->IsClient()) {
-		ExportVar(package_name.c_str(), "uguild_id", mob->CastToClient()->GuildID());
-		ExportVar(package_name.c_str(), "uguildrank", mob->CastToClient()->GuildRank());
-		ExportVar(package_name.c_str(), "status", mob->CastToClient()->Admin());
+uint32 PerlembParser::GetPackageVars(const std::string &package_name) {
+	auto iter = package_index_.find(package_name);
+	if(iter != package_index_.end())
+		return iter->second;
+
+	uint32 package = package_vars_.size();
+	PerlPackageVars vars;
+	vars.event = nullptr;
+
+	struct ufuncs uf;
+	uf.uf_val = GetLazyVar;
+	uf.uf_set = SetLazyVar;
+	for(int i = 0; i < _PerlLazyVarCount; i++) {
+		std::string varname = package_name + "::" + PerlLazyVarNames[i];
+		SV *sv = get_sv(varname.c_str(), true);
+		uf.uf_index = (static_cast<IV>(package) << 8) | i;
+		sv_magic(sv, nullptr, PERL_MAGIC_uvar, (char *)&uf, sizeof(uf));
+		vars.vars[i] = sv;
 	}
 
-	if(!isPlayerQuest && !isGlobalPlayerQuest && !isItemQuest) {
-		if (mob && npcmob && mob->IsClient()) {
-			Client* client = mob->CastToClient();
+	vars.hasitem = get_hv((package_name + "::hasitem").c_str(), true);
+	vars.oncursor = get_hv((package_name + "::oncursor").c_str(), true);
 
-			fac = client->GetFactionLevel(client->CharacterID(), npcmob->GetID(), client->GetRace(),
-				client->GetClass(), client->GetDeity(), npcmob->GetPrimaryFaction(), npcmob);
-		}
-	}
+	package_vars_.push_back(vars);
+	package_index_[package_name] = package;
+	return package;
+}
 
-	if(mob) {
-		ExportVar(package_name.c_str(), "name", mob->GetName());
-		ExportVar(package_name.c_str(), "race", GetRaceName(mob->GetRace()));
-		ExportVar(package_name.c_str(), "class", GetEQClassName(mob->GetClass()));
-		ExportVar(package_name.c_str(), "ulevel", mob->GetLevel());
-		ExportVar(package_name.c_str(), "userid", mob->GetID());
+void PerlembParser::SnapshotEventVars(PerlEventVars &event_vars) {
+	NPC *npcmob = event_vars.npcmob;
+	Mob *mob = event_vars.mob;
+	event_vars.has_target = false;
+	event_vars.target_id = 0;
+	event_vars.faction = 0;
+	if(!event_vars.npc_quest || !npcmob) {
+		event_vars.hp_ratio = event_vars.x = event_vars.y = event_vars.z = event_vars.heading = 0.0f;
+		return;
 	}
 
-	if(!isPlayerQuest && !isGlobalPlayerQuest && !isItemQuest && !isSpellQuest)
-	{
-		if (npcmob)
-		{
-			ExportVar(package_name.c_str(), "mname", npcmob->GetName());
-			ExportVar(package_name.c_str(), "mobid", npcmob->GetID());
-			ExportVar(package_name.c_str(), "mlevel", npcmob->GetLevel());
-			ExportVar(package_name.c_str(), "hpratio",npcmob->GetHPRatio());
-			ExportVar(package_name.c_str(), "x", npcmob->GetX() );
-			ExportVar(package_name.c_str(), "y", npcmob->GetY() );
-			ExportVar(package_name.c_str(), "z", npcmob->GetZ() );
-			ExportVar(package_name.c_str(), "h", npcmob->GetHeading() );
-			if(npcmob->GetTarget()) {
-				ExportVar(package_name.c_str(), "targetid", npcmob->GetTarget()->GetID());
-				ExportVar(package_name.c_str(), "targetname", npcmob->GetTarget()->GetName());
-			}
-		}
+	event_vars.hp_ratio = npcmob->GetHPRatio();
+	event_vars.x = npcmob->GetX();
+	event_vars.y = npcmob->GetY();
+	event_vars.z = npcmob->GetZ();
+	event_vars.heading = npcmob->GetHeading();
+
+	Mob *target = npcmob->GetTarget();
+	if(target) {
+		event_vars.has_target = true;
+		event_vars.target_id = target->GetID();
+		event_vars.target_name = target->GetName();
+	}
 
-		if (fac) {
-			ExportVar(package_name.c_str(), "faction", itoa(fac));
-		}
+	if(mob && mob->IsClient()) {
+		Client *client = mob->CastToClient();
+		event_vars.faction = client->GetFactionLevel(client->CharacterID(), npcmob->GetID(), client->GetRace(),
+			client->GetClass(), client->GetDeity(), npcmob->GetPrimaryFaction(), npcmob);
 	}
 }
 
-void PerlembParser::ExportZoneVariables(std::string &package_name) {
-	if (zone) {
-		ExportVar(package_name.c_str(), "zoneid", zone->GetZoneID());
-		ExportVar(package_name.c_str(), "zoneln", zone->GetLongName());
-		ExportVar(package_name.c_str(), "zonesn", zone->GetShortName());
-		ExportVar(package_name.c_str(), "instanceid", zone->GetInstanceID());
-		ExportVar(package_name.c_str(), "instanceversion", zone->GetInstanceVersion());
-		TimeOfDay_Struct eqTime;
-		zone->zone_time.getEQTimeOfDay( time(0), &eqTime);
-		ExportVar(package_name.c_str(), "zonehour", eqTime.hour - 1);
-		ExportVar(package_name.c_str(), "zonemin", eqTime.minute);
-		ExportVar(package_name.c_str(), "zonetime", (eqTime.hour - 1) * 100 + eqTime.minute);
-		ExportVar(package_name.c_str(), "zoneweather", zone->zone_weather);
+I32 PerlembParser::GetLazyVar(pTHX_ IV index, SV *sv) {
+	if(lazy_var_parser)
+		lazy_var_parser->FillLazyVar(static_cast<uint32>(index >> 8), static_cast<int>(index & 0xFF), sv);
+	return 0;
+}
+
+I32 PerlembParser::SetLazyVar(pTHX_ IV index, SV *sv) {
+	if(lazy_var_parser)
+		lazy_var_parser->MarkLazyVar(static_cast<uint32>(index >> 8), static_cast<int>(index & 0xFF));
+	return 0;
+}
+
+//the script assigned the variable itself, keep its value for the rest of the event
+void PerlembParser::MarkLazyVar(uint32 package, int var) {
+	if(package >= package_vars_.size() || var >= _PerlLazyVarCount)
+		return;
+
+	PerlEventVars *event = package_vars_[package].event;
+	if(event)
+		event->filled[var] = true;
+}
+
+//called on every read of a lazy variable; outside of an event, or once filled, the value is left alone.
+//variables that don't apply to the event keep whatever they held before, as they always have.
+//npc position, hp, target and faction come from SnapshotEventVars() so they match the start of the event
+void PerlembParser::FillLazyVar(uint32 package, int var, SV *sv) {
+	if(package >= package_vars_.size() || var >= _PerlLazyVarCount)
+		return;
+
+	PerlEventVars *event = package_vars_[package].event;
+	if(!event || event->filled[var])
+		return;
+	event->filled[var] = true;
+
+	Mob *mob = event->mob;
+	NPC *npcmob = event->npcmob;
+	Client *client = (mob && mob->IsClient()) ? mob->CastToClient() : nullptr;
+
+	switch(var) {
+		case perlVarCharID:
+			sv_setiv(sv, GetCharID(npcmob, mob));
+			break;
+		case perlVarGuildID:
+			if(client)
+				sv_setiv(sv, static_cast<int>(client->GuildID()));
+			break;
+		case perlVarGuildRank:
+			if(client)
+				sv_setiv(sv, client->GuildRank());
+			break;
+		case perlVarStatus:
+			if(client)
+				sv_setiv(sv, client->Admin());
+			break;
+		case perlVarName:
+			if(mob)
+				sv_setpv(sv, mob->GetName());
+			break;
+		case perlVarRace:
+			if(mob)
+				sv_setpv(sv, GetRaceName(mob->GetRace()));
+			break;
+		case perlVarClass:
+			if(mob)
+				sv_setpv(sv, GetEQClassName(mob->GetClass()));
+			break;
+		case perlVarLevel:
+			if(mob)
+				sv_setiv(sv, mob->GetLevel());
+			break;
+		case perlVarUserID:
+			if(mob)
+				sv_setiv(sv, mob->GetID());
+			break;
+		case perlVarMobName:
+			if(event->npc_quest && npcmob)
+				sv_setpv(sv, npcmob->GetName());
+			break;
+		case perlVarMobID:
+			if(event->npc_quest && npcmob)
+				sv_setiv(sv, npcmob->GetID());
+			break;
+		case perlVarMobLevel:
+			if(event->npc_quest && npcmob)
+				sv_setiv(sv, npcmob->GetLevel());
+			break;
+		case perlVarHPRatio:
+			if(event->npc_quest && npcmob)
+				sv_setnv(sv, event->hp_ratio);
+			break;
+		case perlVarX:
+			if(event->npc_quest && npcmob)
+				sv_setnv(sv, event->x);
+			break;
+		case perlVarY:
+			if(event->npc_quest && npcmob)
+				sv_setnv(sv, event->y);
+			break;
+		case perlVarZ:
+			if(event->npc_quest && npcmob)
+				sv_setnv(sv, event->z);
+			break;
+		case perlVarHeading:
+			if(event->npc_quest && npcmob)
+				sv_setnv(sv, event->heading);
+			break;
+		case perlVarTargetID:
+			if(event->has_target)
+				sv_setiv(sv, event->target_id);
+			break;
+		case perlVarTargetName:
+			if(event->has_target)
+				sv_setpv(sv, event->target_name.c_str());
+			break;
+		case perlVarFaction:
+			if(event->faction)
+				sv_setpv(sv, itoa(event->faction));
+			break;
+		case perlVarZoneID:
+			if(zone)
+				sv_setiv(sv, zone->GetZoneID());
+			break;
+		case perlVarZoneLongName:
+			if(zone)
+				sv_setpv(sv, zone->GetLongName());
+			break;
+		case perlVarZoneShortName:
+			if(zone)
+				sv_setpv(sv, zone->GetShortName());
+			break;
+		case perlVarInstanceID:
+			if(zone)
+				sv_setiv(sv, zone->GetInstanceID());
+			break;
+		case perlVarInstanceVersion:
+			if(zone)
+				sv_setiv(sv, zone->GetInstanceVersion());
+			break;
+		case perlVarZoneHour:
+		case perlVarZoneMinute:
+		case perlVarZoneTime:
+			if(zone) {
+				TimeOfDay_Struct eqTime;
+				zone->zone_time.getEQTimeOfDay(time(0), &eqTime);
+				if(var == perlVarZoneHour)
+					sv_setiv(sv, eqTime.hour - 1);
+				else if(var == perlVarZoneMinute)
+					sv_setiv(sv, eqTime.minute);
+				else
+					sv_setiv(sv, (eqTime.hour - 1) * 100 + eqTime.minute);
+			}
+			break;
+		case perlVarZoneWeather:
+			if(zone)
+				sv_setiv(sv, zone->zone_weather);
+			break;
+		default:
+			break;
 	}
 }
 
@@ -1077,37 +1289,43 @@ void PerlembParser::ExportZoneVariables(std::string &package_name) {
 #define HASITEM_LAST 29 // this includes worn plus 8 base slots
 #define HASITEM_ISNULLITEM(item) ((item==-1) || (item==0))
 
-void PerlembParser::ExportItemVariables(std::string &package_name, Mob *mob) {
+//push (@{$hash{itemid}}, slot);
+static void PushItemSlot(HV *hash, int itemid, int slot) {
+	char key[16];
+	int keylen = snprintf(key, sizeof(key), "%d", itemid);
+	SV **entry = hv_fetch(hash, key, keylen, true);
+	if(!entry)
+		return;
+
+	if(!SvROK(*entry) || SvTYPE(SvRV(*entry)) != SVt_PVAV) {
+		SV *ref = newRV_noinc((SV *)newAV());
+		sv_setsv(*entry, ref);
+		SvREFCNT_dec(ref);
+	}
+	av_push((AV *)SvRV(*entry), newSViv(slot));
+}
+
+void PerlembParser::ExportItemVariables(uint32 package, Mob *mob) {
 	if(mob && mob->IsClient())
 	{
-		std::string hashname = package_name + std::string("::hasitem");
+		Client *client = mob->CastToClient();
 
 		//start with an empty hash
-		perl->eval(std::string("%").append(hashname).append(" = ();").c_str());
+		HV *hasitem = package_vars_[package].hasitem;
+		hv_clear(hasitem);
 
 		for(int slot = HASITEM_FIRST; slot <= HASITEM_LAST; slot++)
 		{
-			char *hi_decl=nullptr;
-			int itemid = mob->CastToClient()->GetItemIDAt(slot);
+			int itemid = client->GetItemIDAt(slot);
 			if(!HASITEM_ISNULLITEM(itemid))
-			{
-				MakeAnyLenString(&hi_decl, "push (@{$%s{%d}},%d);", hashname.c_str(), itemid, slot);
-				perl->eval(hi_decl);
-				safe_delete_array(hi_decl);
-			}
+				PushItemSlot(hasitem, itemid, slot);
 		}
-	}
 
-	if(mob && mob->IsClient()) {
-		std::string hashname = package_name + std::string("::oncursor");
-		perl->eval(std::string("%").append(hashname).append(" = ();").c_str());
-		char *hi_decl = nullptr;
-		int itemid = mob->CastToClient()->GetItemIDAt(30);
-		if(!HASITEM_ISNULLITEM(itemid)) {
-			MakeAnyLenString(&hi_decl, "push (@{$%s{%d}},%d);",hashname.c_str(), itemid, 30);
-			perl->eval(hi_decl);
-			safe_delete_array(hi_decl);
-		}
+		HV *oncursor = package_vars_[package].oncursor;
+		hv_clear(oncursor);
+		int itemid = client->GetItemIDAt(30);
+		if(!HASITEM_ISNULLITEM(itemid))
+			PushItemSlot(oncursor, itemid, 30);
 	}
 }
 
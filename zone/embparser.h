@@ -25,6 +25,8 @@
 #include <string>
 #include <queue>
 #include <map>
+#include <bitset>
+#include <vector>
 #include "embperl.h"
 
 class ItemInst;
@@ -39,6 +41,64 @@ typedef enum
 	questFailedToLoad
 } PerlQuestStatus;
 
+//package variables filled in from the running event when a script first reads them
+typedef enum
+{
+	perlVarCharID,
+	perlVarGuildID,
+	perlVarGuildRank,
+	perlVarStatus,
+	perlVarName,
+	perlVarRace,
+	perlVarClass,
+	perlVarLevel,
+	perlVarUserID,
+	perlVarMobName,
+	perlVarMobID,
+	perlVarMobLevel,
+	perlVarHPRatio,
+	perlVarX,
+	perlVarY,
+	perlVarZ,
+	perlVarHeading,
+	perlVarTargetID,
+	perlVarTargetName,
+	perlVarFaction,
+	perlVarZoneID,
+	perlVarZoneLongName,
+	perlVarZoneShortName,
+	perlVarInstanceID,
+	perlVarInstanceVersion,
+	perlVarZoneHour,
+	perlVarZoneMinute,
+	perlVarZoneTime,
+	perlVarZoneWeather,
+	_PerlLazyVarCount
+} PerlLazyVar;
+
+struct PerlEventVars {
+	NPC *npcmob;
+	Mob *mob;
+	bool npc_quest;
+	std::bitset<_PerlLazyVarCount> filled;	//read or assigned during this event
+
+	//npc state that can change while the event runs, taken when it starts so late reads see the same values
+	float hp_ratio;
+	float x, y, z, heading;
+	bool has_target;
+	uint16 target_id;
+	std::string target_name;
+	uint8 faction;
+};
+
+//handles for the variables exported into one package, resolved on its first event
+struct PerlPackageVars {
+	SV *vars[_PerlLazyVarCount];
+	HV *hasitem;
+	HV *oncursor;
+	PerlEventVars *event;	//innermost event running in the package, nullptr between events
+};
+
 class PerlembParser : public QuestInterface {
 public:
 	PerlembParser();
@@ -87,6 +147,13 @@ private:
 
 	int EventCommon(QuestEventID event, uint32 objid, const char * data, NPC* npcmob, ItemInst* iteminst, Mob* mob, 
 		uint32 extradata, bool global, std::vector<EQEmu::Any> *extra_pointers);
+	uint32 GetPackageVars(const std::string &package_name);
+	void SnapshotEventVars(PerlEventVars &event_vars);
+	void FillLazyVar(uint32 package, int var, SV *sv);
+	void MarkLazyVar(uint32 package, int var);
+	static I32 GetLazyVar(pTHX_ IV index, SV *sv);
+	static I32 SetLazyVar(pTHX_ IV index, SV *sv);
+
 	int SendCommands(const char *pkgprefix, const char *event, uint32 npcid, Mob* other, Mob* mob, ItemInst *iteminst);
 	void MapFunctions();
 
@@ -95,13 +162,10 @@ private:
 	void GetQuestPackageName(bool &isPlayerQuest, bool &isGlobalPlayerQuest, bool &isGlobalNPC, bool &isItemQuest, 
 		bool &isSpellQuest, std::string &package_name, QuestEventID event, uint32 objid, const char * data, 
 		NPC* npcmob, ItemInst* iteminst, bool global);
-	void ExportCharID(const std::string &package_name, int &char_id, NPC *npcmob, Mob *mob);
+	int GetCharID(NPC *npcmob, Mob *mob);
 	void ExportQGlobals(bool isPlayerQuest, bool isGlobalPlayerQuest, bool isGlobalNPC, bool isItemQuest, 
 		bool isSpellQuest, std::string &package_name, NPC *npcmob, Mob *mob, int char_id);
-	void ExportMobVariables(bool isPlayerQuest, bool isGlobalPlayerQuest, bool isGlobalNPC, bool isItemQuest, 
-		bool isSpellQuest, std::string &package_name, Mob *mob, NPC *npcmob);
-	void ExportZoneVariables(std::string &package_name);
-	void ExportItemVariables(std::string &package_name, Mob *mob);
+	void ExportItemVariables(uint32 package, Mob *mob);
 	void ExportEventVariables(std::string &package_name, QuestEventID event, uint32 objid, const char * data, 
 		NPC* npcmob, ItemInst* iteminst, Mob* mob, uint32 extradata, std::vector<EQEmu::Any> *extra_pointers);
 	
@@ -115,6 +179,8 @@ private:
 	std::map<std::string, std::string> vars_;
 	SV *_empty_sv;
 	std::map<std::string, int> clear_vars_;
+	std::map<std::string, uint32> package_index_;
+	std::vector<PerlPackageVars> package_vars_;
 };
 
 #endif
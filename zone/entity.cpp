@@ -30,6 +30,7 @@
 #endif
 
 #include "../common/features.h"
+#include "../common/eq_broadcast_packet.h"
 #include "../common/guilds.h"
 
 #include "guild_mgr.h"
@@ -41,6 +42,7 @@
 #include "worldserver.h"
 #include "remote_call_subscribe.h"
 #include "remote_call_subscribe.h"
+#include "zone_profiler.h"
 
 #ifdef _WINDOWS
 	#define snprintf	_snprintf
@@ -249,6 +251,8 @@ const Encounter* Entity::CastToEncounter() const
 }
 EntityList::EntityList()
 {
+	aggro_grid_time = 0xFFFFFFFF;
+
 	// set up ids between 1 and 1500
 	// neither client or server performs well if you have
 	// enough entities to exhaust this list
@@ -461,6 +465,10 @@ void EntityList::CorpseProcess()
 
 void EntityList::MobProcess()
 {
+	PROFILE_PHASE(MobProcess);
+
+	ThinkAggroScans();
+
 	bool mob_dead;
 	auto it = mob_list.begin();
 	while (it != mob_list.end()) {
@@ -548,6 +556,8 @@ void EntityList::MobProcess()
 			entity_list.RemoveMob(id);
 		}
 	}
+
+	ai_aggro_scans.clear();
 }
 
 void EntityList::BeaconProcess()
@@ -1454,6 +1464,7 @@ void EntityList::RemoveFromTargets(Mob *mob)
 void EntityList::QueueClientsByTarget(Mob *sender, const EQApplicationPacket *app,
 		bool iSendToSender, Mob *SkipThisMob, bool ackreq, bool HoTT, uint32 ClientVersionBits)
 {
+	EQBroadcastPacket bp(app);
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *c = it->second;
@@ -1487,7 +1498,7 @@ void EntityList::QueueClientsByTarget(Mob *sender, const EQApplicationPacket *ap
 		}
 
 		if (Send && (c->GetClientVersionBit() & ClientVersionBits))
-			c->QueuePacket(app, ackreq);
+			c->QueuePacket(&bp, ackreq);
 	}
 }
 
@@ -1503,6 +1514,7 @@ void EntityList::QueueCloseClients(Mob *sender, const EQApplicationPacket *app,
 		dist = 600;
 	float dist2 = dist * dist; //pow(dist, 2);
 
+	EQBroadcastPacket bp(app);
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *ent = it->second;
@@ -1516,7 +1528,7 @@ void EntityList::QueueCloseClients(Mob *sender, const EQApplicationPacket *app,
 					(ent->GetGroup() && ent->GetGroup()->IsGroupMember(sender))))
 				|| (filter2 == FilterShowSelfOnly && ent == sender))
 			&& (DistanceSquared(ent->GetPosition(), sender->GetPosition()) <= dist2)) {
-				ent->QueuePacket(app, ackreq, Client::CLIENT_CONNECTED);
+				ent->QueuePacket(&bp, ackreq, Client::CLIENT_CONNECTED);
 			}
 		}
 		++it;
@@ -1531,13 +1543,14 @@ void EntityList::QueueCloseClientsPrecalc(Mob *sender, const EQApplicationPacket
 		return;
 	}
 
+	EQBroadcastPacket bp(app);
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *ent = it->second;
 
 		if ((!ignore_sender || ent != sender) && (ent != SkipThisMob)) {
 			if (ent->GetInside(sender->GetID()) || sender->IsCorpse() || (special && (ent->GetGM()))) {
-				ent->QueuePacket(app, ackreq, Client::CLIENT_CONNECTED);
+				ent->QueuePacket(&bp, ackreq, Client::CLIENT_CONNECTED);
 				ent->SetLastPosition(sender->GetID(), sender->GetPosition());
 			}
 		}
@@ -1549,12 +1562,13 @@ void EntityList::QueueCloseClientsPrecalc(Mob *sender, const EQApplicationPacket
 void EntityList::QueueClients(Mob *sender, const EQApplicationPacket *app,
 		bool ignore_sender, bool ackreq)
 {
+	EQBroadcastPacket bp(app);
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *ent = it->second;
 
 		if ((!ignore_sender || ent != sender))
-			ent->QueuePacket(app, ackreq, Client::CLIENT_CONNECTED);
+			ent->QueuePacket(&bp, ackreq, Client::CLIENT_CONNECTED);
 
 		++it;
 	}
@@ -1563,12 +1577,13 @@ void EntityList::QueueClients(Mob *sender, const EQApplicationPacket *app,
 void EntityList::QueueManaged(Mob *sender, const EQApplicationPacket *app,
 		bool ignore_sender, bool ackreq)
 {
+	EQBroadcastPacket bp(app);
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *ent = it->second;
 
 		if ((!ignore_sender || ent != sender))
-			ent->QueuePacket(app, ackreq, Client::CLIENT_CONNECTED);
+			ent->QueuePacket(&bp, ackreq, Client::CLIENT_CONNECTED);
 
 		++it;
 	}
@@ -1578,11 +1593,12 @@ void EntityList::QueueManaged(Mob *sender, const EQApplicationPacket *app,
 void EntityList::QueueClientsStatus(Mob *sender, const EQApplicationPacket *app,
 		bool ignore_sender, uint8 minstatus, uint8 maxstatus)
 {
+	EQBroadcastPacket bp(app);
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		if ((!ignore_sender || it->second != sender) &&
 				(it->second->Admin() >= minstatus && it->second->Admin() <= maxstatus))
-			it->second->QueuePacket(app);
+			it->second->QueuePacket(&bp);
 
 		++it;
 	}
@@ -1954,11 +1970,12 @@ void EntityList::Message(uint32 to_guilddbid, uint32 type, const char *message,
 void EntityList::QueueClientsGuild(Mob *sender, const EQApplicationPacket *app,
 		bool ignore_sender, uint32 guild_id)
 {
+	EQBroadcastPacket bp(app);
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *client = it->second;
 		if (client->IsInGuild(guild_id))
-			client->QueuePacket(app);
+			client->QueuePacket(&bp);
 		++it;
 	}
 }
@@ -2473,15 +2490,16 @@ void EntityList::SendTraders(Client *client)
 
 void EntityList::RemoveFromHateLists(Mob *mob, bool settoone)
 {
-	auto it = npc_list.begin();
-	while (it != npc_list.end()) {
-		if (it->second->CheckAggro(mob)) {
-			if (!settoone)
-				it->second->RemoveFromHateList(mob);
-			else
-				it->second->SetHate(mob, 1);
-		}
-		++it;
+	// a copy, removing changes the list
+	std::vector<Mob *> haters(mob->GetHatedBy());
+	for (auto it = haters.begin(); it != haters.end(); ++it) {
+		// an earlier hater's event may have changed this one's list
+		if (!(*it)->IsNPC() || !(*it)->CheckAggro(mob))
+			continue;
+		if (!settoone)
+			(*it)->RemoveFromHateList(mob);
+		else
+			(*it)->SetHate(mob, 1);
 	}
 }
 
@@ -2500,6 +2518,8 @@ void EntityList::RemoveDebuffs(Mob *caster)
 void EntityList::SendPositionUpdates(Client *client, uint32 cLastUpdate,
 		Entity *alwayssend, Entity *alwayssend2, bool iSendEvenIfNotChanged)
 {
+	PROFILE_PHASE(PositionUpdates);
+
 	float range = zone->update_range;
 
 	EQApplicationPacket *outapp = 0;
@@ -2847,32 +2867,29 @@ void BulkZoneSpawnPacket::SendBuffer()
 
 void EntityList::DoubleAggro(Mob *who)
 {
-	auto it = npc_list.begin();
-	while (it != npc_list.end()) {
-		if (it->second->CheckAggro(who))
-			it->second->SetHate(who, it->second->CastToNPC()->GetHateAmount(who),
-					it->second->CastToNPC()->GetHateAmount(who) * 2);
-		++it;
+	std::vector<Mob *> haters(who->GetHatedBy());
+	for (auto it = haters.begin(); it != haters.end(); ++it) {
+		if ((*it)->IsNPC() && (*it)->CheckAggro(who))
+			(*it)->SetHate(who, (*it)->CastToNPC()->GetHateAmount(who),
+					(*it)->CastToNPC()->GetHateAmount(who) * 2);
 	}
 }
 
 void EntityList::HalveAggro(Mob *who)
 {
-	auto it = npc_list.begin();
-	while (it != npc_list.end()) {
-		if (it->second->CastToNPC()->CheckAggro(who))
-			it->second->CastToNPC()->SetHate(who, it->second->CastToNPC()->GetHateAmount(who) / 2);
-		++it;
+	std::vector<Mob *> haters(who->GetHatedBy());
+	for (auto it = haters.begin(); it != haters.end(); ++it) {
+		if ((*it)->IsNPC() && (*it)->CheckAggro(who))
+			(*it)->CastToNPC()->SetHate(who, (*it)->CastToNPC()->GetHateAmount(who) / 2);
 	}
 }
 
 void EntityList::ReduceAggro(Mob *who)
 {
-	auto it = npc_list.begin();
-	while (it != npc_list.end()) {
-		if (it->second->CastToNPC()->CheckAggro(who))
-			it->second->CastToNPC()->SetHate(who, 1);
-		++it;
+	std::vector<Mob *> haters(who->GetHatedBy());
+	for (auto it = haters.begin(); it != haters.end(); ++it) {
+		if ((*it)->IsNPC() && (*it)->CheckAggro(who))
+			(*it)->CastToNPC()->SetHate(who, 1);
 	}
 }
 
@@ -2880,67 +2897,63 @@ void EntityList::Evade(Mob *who)
 {
 	uint32 flatval = who->GetLevel() * 13;
 	int amt = 0;
-	auto it = npc_list.begin();
-	while (it != npc_list.end()) {
-		if (it->second->CastToNPC()->CheckAggro(who)) {
-			amt = it->second->CastToNPC()->GetHateAmount(who);
+	std::vector<Mob *> haters(who->GetHatedBy());
+	for (auto it = haters.begin(); it != haters.end(); ++it) {
+		if ((*it)->IsNPC() && (*it)->CheckAggro(who)) {
+			amt = (*it)->CastToNPC()->GetHateAmount(who);
 			amt -= flatval;
 			if (amt > 0)
-				it->second->CastToNPC()->SetHate(who, amt);
+				(*it)->CastToNPC()->SetHate(who, amt);
 			else
-				it->second->CastToNPC()->SetHate(who, 0);
+				(*it)->CastToNPC()->SetHate(who, 0);
 		}
-		++it;
 	}
 }
 
 //removes "targ" from all hate lists, including feigned, in the zone
 void EntityList::ClearAggro(Mob* targ)
 {
-	auto it = npc_list.begin();
-	while (it != npc_list.end()) {
-		if (it->second->CheckAggro(targ))
-			it->second->RemoveFromHateList(targ);
-		it->second->RemoveFromFeignMemory(targ->CastToClient()); //just in case we feigned
-		++it;
+	std::vector<Mob *> haters(targ->GetHatedBy());
+	for (auto it = haters.begin(); it != haters.end(); ++it) {
+		if ((*it)->IsNPC() && (*it)->CheckAggro(targ))
+			(*it)->RemoveFromHateList(targ);
 	}
+	if (targ->IsClient())
+		ClearZoneFeignAggro(targ->CastToClient()); //just in case we feigned
 }
 
 void EntityList::ClearFeignAggro(Mob *targ)
 {
-	auto it = npc_list.begin();
-	while (it != npc_list.end()) {
-		if (it->second->CheckAggro(targ)) {
-			if (it->second->GetSpecialAbility(IMMUNE_FEIGN_DEATH)) {
-				++it;
-				continue;
-			}
+	std::vector<Mob *> haters(targ->GetHatedBy());
+	for (auto it = haters.begin(); it != haters.end(); ++it) {
+		Mob *hater = *it;
+		if (!hater->IsNPC())
+			continue;
 
-			if (targ->IsClient()) {
-				std::vector<EQEmu::Any> args;
-				args.push_back(it->second);
-				int i = parse->EventPlayer(EVENT_FEIGN_DEATH, targ->CastToClient(), "", 0, &args);
-				if (i != 0) {
-					++it;
-					continue;
-				}
+		// the feign death events below can drop targ from later haters' lists
+		if (!hater->CheckAggro(targ))
+			continue;
 
-				if (it->second->IsNPC()) {
-					int i = parse->EventNPC(EVENT_FEIGN_DEATH, it->second->CastToNPC(), targ, "", 0);
-					if (i != 0) {
-						++it;
-						continue;
-					}
-				}
-			}
+		if (hater->GetSpecialAbility(IMMUNE_FEIGN_DEATH))
+			continue;
 
-			it->second->RemoveFromHateList(targ);
-			if (targ->IsClient()) {
-				if (it->second->GetLevel() >= 35 && zone->random.Roll(65))
-					it->second->AddFeignMemory(targ->CastToClient());
-			}
+		if (targ->IsClient()) {
+			std::vector<EQEmu::Any> args;
+			args.push_back(hater->CastToNPC());
+			int i = parse->EventPlayer(EVENT_FEIGN_DEATH, targ->CastToClient(), "", 0, &args);
+			if (i != 0)
+				continue;
+
+			int j = parse->EventNPC(EVENT_FEIGN_DEATH, hater->CastToNPC(), targ, "", 0);
+			if (j != 0)
+				continue;
+		}
+
+		hater->RemoveFromHateList(targ);
+		if (targ->IsClient()) {
+			if (hater->GetLevel() >= 35 && zone->random.Roll(65))
+				hater->AddFeignMemory(targ->CastToClient());
 		}
-		++it;
 	}
 }
 
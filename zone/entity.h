@@ -356,6 +356,7 @@ public:
 
 	void	CheckClientAggro(Client *around);
 	Mob*	AICheckCloseAggro(Mob* sender, float iAggroRange, float iAssistRange);
+	void	ThinkAggroScans();
 	int	GetHatedCount(Mob *attacker, Mob *exclude);
 	int	GetHatedCountByFaction(Mob *attacker, Mob *exclude);
 	void	AIYellForHelp(Mob* sender, Mob* attacker);
@@ -385,6 +386,9 @@ public:
 	void	HideCorpses(Client *c, uint8 CurrentMode, uint8 NewMode);
 
 	uint16 GetClientCount();
+	uint32 GetMobCount() const		{ return mob_list.size(); }
+	uint32 GetNPCCount() const		{ return npc_list.size(); }
+	uint32 GetCorpseCount() const	{ return corpse_list.size(); }
 	void GetMobList(std::list<Mob*> &m_list);
 	void GetNPCList(std::list<NPC*> &n_list);
 	void GetClientList(std::list<Client*> &c_list);
@@ -417,6 +421,7 @@ protected:
 private:
 	void	AddToSpawnQueue(uint16 entityid, NewSpawn_Struct** app);
 	void	CheckSpawnQueue();
+	void	BuildAggroGrid();
 
 	//used for limiting spawns
 	class SpawnLimitRecord { public: uint32 spawngroup_id; uint32 npc_type; };
@@ -441,6 +446,15 @@ private:
 	std::list<Area> area_list;
 	std::queue<uint16> free_ids;
 
+	//npc id -> ids of the npcs in its aggro range when the mob pass began, in npc_list order. see ThinkAggroScans()
+	std::unordered_map<uint16, std::vector<uint16>> ai_aggro_scans;
+
+	//aggro boxes of the mobs that can aggro clients, by grid cell. see BuildAggroGrid()
+	struct AggroGridEntry { uint32 order; uint16 id; };	//order is the position in mob_list
+	std::unordered_map<uint32, std::vector<AggroGridEntry>> aggro_grid;
+	std::vector<AggroGridEntry> aggro_grid_wide;	//boxes too big for the grid, checked for every client
+	uint32	aggro_grid_time;	//Timer::GetCurrentTime() of the last build
+
 	// Please Do Not Declare Any EntityList Class Members After This Comment
 };
 
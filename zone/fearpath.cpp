@@ -168,7 +168,7 @@ void Mob::CalculateNewFearpoint()
 		Log.Out(Logs::Detail, Logs::Pathing, "No path found to selected node. Falling through to old fear point selection.");
 	}
 
-	bool inliquid = (zone->HasWaterMap() && zone->watermap->InLiquid(glm::vec3(GetPosition())));
+	bool inliquid = IsInLiquid();
 	bool stay_inliquid = (inliquid && IsNPC() && CastToNPC()->IsUnderwaterOnly());
 
 	int loop = 0;
@@ -21,6 +21,7 @@
 #include "npc_ai.h"
 #include "../common/packet_functions.h"
 #include "../common/packet_dump.h"
+#include "../common/eq_broadcast_packet.h"
 #include "../common/string_util.h"
 #include "worldserver.h"
 
@@ -306,12 +307,13 @@ void Group::AddMember(const char *NewMemberName)
 
 void Group::QueuePacket(const EQApplicationPacket *app, bool ack_req)
 {
+	EQBroadcastPacket bp(app);
 	uint32 i;
 	for(i = 0; i < MAX_GROUP_MEMBERS; i++)
 	{
 		if(members[i] && members[i]->IsClient())
 		{
-			members[i]->CastToClient()->QueuePacket(app, ack_req);
+			members[i]->CastToClient()->QueuePacket(&bp, ack_req);
 		}
 	}
 }
@@ -30,7 +30,6 @@
 #include "water_map.h"
 
 #include <stdlib.h>
-#include <list>
 
 extern Zone *zone;
 
@@ -43,15 +42,24 @@ HateList::HateList()
 	lowHealthBonus = 0;
 	rememberDistantMobs = false;
 	nobodyInMeleeRange = false;
+	topCache = nullptr;
+	topCacheTime = 0;
+	topCacheValid = false;
 }
 
 HateList::~HateList()
 {
+	for (auto iterator = list.begin(); iterator != list.end(); ++iterator)
+	{
+		(*iterator)->ent->RemoveHatedBy(owner);
+		delete (*iterator);
+	}
 }
 
 void HateList::SetOwner(Mob *newOwner)
 {
 	owner = newOwner;
+	topCacheValid = false;
 
 	// see http://www.eqemulator.org/forums/showthread.php?t=39819
 	// for the data this came from.  This is accurate to EQ Live as of 2015
@@ -118,19 +126,20 @@ void HateList::CheckFrenzyHate()
 	auto iterator = list.begin();
 	while(iterator != list.end())
 	{
-		if ((*iterator)->ent->GetHPRatio() >= 20)
+		if ((*iterator)->bFrenzy && (*iterator)->ent->GetHPRatio() >= 20)
+		{
 			(*iterator)->bFrenzy = false;
+			topCacheValid = false;
+		}
 		++iterator;
 	}
 }
 
 void HateList::Wipe()
 {
-	auto iterator = list.begin();
-
-	while(iterator != list.end())
+	while(!list.empty())
 	{
-		Mob* m = (*iterator)->ent;
+		Mob* m = list.front()->ent;
 		if(m)
 		{
 			parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), m, "0", 0);
@@ -138,9 +147,11 @@ void HateList::Wipe()
 			if(m->IsClient())
 				m->CastToClient()->DecrementAggroCount();
 		}
-		delete (*iterator);
-		iterator = list.erase(iterator);
 
+		// the event can change the list, so find the entry again
+		auto slot = slots.find(m);
+		if (slot != slots.end())
+			Erase(slot->second);
 	}
 }
 
@@ -153,14 +164,24 @@ bool HateList::IsOnHateList(Mob *mob)
 
 tHateEntry *HateList::Find(Mob *ent)
 {
-	auto iterator = list.begin();
-	while(iterator != list.end())
-	{
-		if((*iterator)->ent == ent)
-			return (*iterator);
-		++iterator;
-	}
-	return nullptr;
+	auto slot = slots.find(ent);
+	if (slot == slots.end())
+		return nullptr;
+	return list[slot->second];
+}
+
+// removes the entry in slot, keeping the rest in the order they were added
+void HateList::Erase(uint32 slot)
+{
+	tHateEntry *p = list[slot];
+	p->ent->RemoveHatedBy(owner);
+	slots.erase(p->ent);
+	list.erase(list.begin() + slot);
+	for (uint32 i = slot; i < list.size(); ++i)
+		slots[list[i]->ent] = i;
+
+	delete p;
+	topCacheValid = false;
 }
 
 void HateList::Set(Mob* other, uint32 in_hate, uint32 in_dam)
@@ -173,6 +194,8 @@ void HateList::Set(Mob* other, uint32 in_hate, uint32 in_dam)
 
 		if(in_hate > 0)
 			p->hate = in_hate;
+
+		topCacheValid = false;
 	}
 	else
 	{
@@ -286,7 +309,9 @@ void HateList::Add(Mob *ent, int32 in_hate, int32 in_dam, bool bFrenzy, bool iAd
 		p->damage = (in_dam>=0)?in_dam:0;
 		p->hate = in_hate;
 		p->bFrenzy = bFrenzy;
+		slots[ent] = list.size();
 		list.push_back(p);
+		ent->AddHatedBy(owner);
 		parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), ent, "1", 0);
 
 		if (ent->IsClient()) {
@@ -300,6 +325,7 @@ void HateList::Add(Mob *ent, int32 in_hate, int32 in_dam, bool bFrenzy, bool iAd
 	if (p)
 	{
 		p->timer.Start(600000);
+		topCacheValid = false;
 	}
 }
 
@@ -308,29 +334,20 @@ bool HateList::RemoveEnt(Mob *ent)
 	if (!ent)
 		return false;
 
-	bool found = false;
-	auto iterator = list.begin();
-
-	while(iterator != list.end())
-	{
-		if((*iterator)->ent == ent)
-		{
-			if(ent)
-			parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), ent, "0", 0);
-			found = true;
+	if(!Find(ent))
+		return false;
 
+	parse->EventNPC(EVENT_HATE_LIST, owner->CastToNPC(), ent, "0", 0);
 
-			if(ent && ent->IsClient())
-				ent->CastToClient()->DecrementAggroCount();
+	if(ent->IsClient())
+		ent->CastToClient()->DecrementAggroCount();
 
-			delete (*iterator);
-			iterator = list.erase(iterator);
+	// the event can change the list, so find the entry again
+	auto slot = slots.find(ent);
+	if (slot != slots.end())
+		Erase(slot->second);
 
-		}
-		else
-			++iterator;
-	}
-	return found;
+	return true;
 }
 
 void HateList::DoFactionHits(int32 nfl_id) {
@@ -441,8 +458,25 @@ int32 HateList::GetHateBonus(tHateEntry *entry, bool combatRange, bool firstInRa
 	return bonus;
 }
 
+// the bonuses follow positions and health, so the top is worked out again
+// each loop pass and whenever the list changes
 Mob *HateList::GetTop()
 {
+	if (topCacheValid && topCacheTime == Timer::GetCurrentTime())
+		return topCache;
+
+	bool fromTarget;
+	topCache = FindTop(fromTarget);
+	topCacheTime = Timer::GetCurrentTime();
+	// a fallback to the owner's target can change within the pass
+	topCacheValid = !fromTarget;
+	return topCache;
+}
+
+// fromTarget is set when nothing on the list qualified and the owner's target was used instead
+Mob *HateList::FindTop(bool &fromTarget)
+{
+	fromTarget = false;
 	Mob* topMob = nullptr;
 	int32 topHate = -1;
 	bool somebodyInMeleeRange = false;
@@ -599,6 +633,7 @@ Mob *HateList::GetTop()
 		{
 			if (topMob == nullptr && skipped_count > 0)
 			{
+				fromTarget = true;
 				return owner->GetTarget() ? owner->GetTarget() : nullptr;
 			}
 			return topMob ? topMob : nullptr;
@@ -613,7 +648,7 @@ Mob *HateList::GetTop()
 			tHateEntry *cur = (*iterator);
  			if(owner->IsNPC() && owner->CastToNPC()->IsUnderwaterOnly() && zone->HasWaterMap())
 			{
-				if(!zone->watermap->InLiquid(glm::vec3(cur->ent->GetPosition())))
+				if(!cur->ent->IsInLiquid())
 				{
 					skipped_count++;
 					++iterator;
@@ -630,6 +665,7 @@ Mob *HateList::GetTop()
 		}
 		if (topMob == nullptr && skipped_count > 0)
 		{
+			fromTarget = true;
 			return owner->GetTarget() ? owner->GetTarget() : nullptr;
 		}
 		return topMob ? topMob : nullptr;
@@ -686,12 +722,8 @@ Mob *HateList::GetRandom()
 		return nullptr;
 	}
 
-	auto iterator = list.begin();
 	int random = zone->random.Int(0, count - 1);
-	for (int i = 0; i < random; i++)
-		++iterator;
-
-	return (*iterator)->ent;
+	return list[random]->ent;
 }
 
 int32 HateList::GetEntHate(Mob *ent, bool damage, bool includeBonus)
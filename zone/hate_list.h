@@ -19,6 +19,9 @@
 #ifndef HATELIST_H
 #define HATELIST_H
 
+#include <unordered_map>
+#include <vector>
+
 class Client;
 class Group;
 class Mob;
@@ -68,7 +71,7 @@ public:
 	// Count 'Summoned' pets on hatelist
 	int SummonedPetCount(Mob *hater);
 	// setting this true will allow the NPC to persue targets outside the 600 distance limit
-	void SetRememberDistantMobs(bool state) { rememberDistantMobs = state; }
+	void SetRememberDistantMobs(bool state) { rememberDistantMobs = state; topCacheValid = false; }
 
 	int AreaRampage(Mob *caster, Mob *target, int count, ExtraAttackOptions *opts);
 
@@ -78,17 +81,25 @@ public:
 	void PrintToClient(Client *c);
 
 	//For accessing the hate list via perl; don't use for anything else
-	std::list<tHateEntry*>& GetHateList() { return list; }
+	std::vector<tHateEntry*>& GetHateList() { return list; }
 
 	//setting owner
 	void SetOwner(Mob *newOwner);
 
 protected:
 	tHateEntry* Find(Mob *ent);
+	Mob *FindTop(bool &fromTarget);
+	void Erase(uint32 slot);
 	int32 GetHateBonus(tHateEntry *entry, bool combatRange, bool firstInRange = false, float distSquared = -1.0f);
 private:
-	std::list<tHateEntry*> list;
+	// entries in the order they were added. each is allocated on its own because perl and lua keep pointers to them
+	std::vector<tHateEntry*> list;
+	std::unordered_map<const Mob*, uint32> slots;	// mob -> index in list
 	Mob *owner;
+	// GetTop() result for the loop pass at topCacheTime, dropped whenever the list changes
+	Mob *topCache;
+	uint32 topCacheTime;
+	bool topCacheValid;
 	int32 combatRangeBonus;
 	int32 sitInsideBonus;
 	int32 sitOutsideBonus;
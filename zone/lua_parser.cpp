@@ -12,6 +12,8 @@
 
 #include "masterentity.h"
 #include "../common/spdat.h"
+#include "../common/rdtsc.h"
+#include "../common/rulesys.h"
 #include "lua_bit.h"
 #include "lua_entity.h"
 #include "lua_item.h"
@@ -36,6 +38,9 @@
 #include "lua_parser.h"
 #include "lua_encounter.h"
 
+//fields preallocated in each event table, enough for self and the arguments of most events
+#define LUA_EVENT_TABLE_FIELDS 8
+
 const char *LuaEvents[_LargestEventID] = {
 	"event_say",
 	"event_trade",
@@ -205,6 +210,8 @@ LuaParser::LuaParser() {
 	EncounterArgumentDispatch[EVENT_ENCOUNTER_UNLOAD] = handle_encounter_unload;
 
 	L = nullptr;
+	gc_step_size_ = 0;
+	event_depth_ = 0;
 }
 
 LuaParser::~LuaParser() {
@@ -266,7 +273,7 @@ int LuaParser::_EventNPC(std::string package_name, QuestEventID evt, NPC* npc, M
 			npop = 2;
 		}
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, LUA_EVENT_TABLE_FIELDS);
 		//always push self
 		Lua_NPC l_npc(npc);
 		luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
@@ -278,7 +285,7 @@ int LuaParser::_EventNPC(std::string package_name, QuestEventID evt, NPC* npc, M
 		Client *c = (init && init->IsClient()) ? init->CastToClient() : nullptr;
 
 		quest_manager.StartQuest(npc, c, nullptr);
-		if(lua_pcall(L, 1, 1, 0)) {
+		if(CallEvent(1, 1)) {
 			std::string error = lua_tostring(L, -1);
 			AddError(error);
 			quest_manager.EndQuest();
@@ -360,7 +367,7 @@ int LuaParser::_EventPlayer(std::string package_name, QuestEventID evt, Client *
 			npop = 2;
 		}
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, LUA_EVENT_TABLE_FIELDS);
 		//push self
 		Lua_Client l_client(client);
 		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
@@ -371,7 +378,7 @@ int LuaParser::_EventPlayer(std::string package_name, QuestEventID evt, Client *
 		arg_function(this, L, client, data, extra_data, extra_pointers);
 
 		quest_manager.StartQuest(client, client, nullptr);
-		if(lua_pcall(L, 1, 1, 0)) {
+		if(CallEvent(1, 1)) {
 			std::string error = lua_tostring(L, -1);
 			AddError(error);
 			quest_manager.EndQuest();
@@ -437,7 +444,7 @@ int LuaParser::_EventItem(std::string package_name, QuestEventID evt, Client *cl
 			lua_getfield(L, -1, sub_name);
 		}
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, LUA_EVENT_TABLE_FIELDS);
 		//always push self
 		Lua_ItemInst l_item(item);
 		luabind::adl::object l_item_o = luabind::adl::object(L, l_item);
@@ -454,7 +461,7 @@ int LuaParser::_EventItem(std::string package_name, QuestEventID evt, Client *cl
 		arg_function(this, L, client, item, mob, data, extra_data, extra_pointers);
 
 		quest_manager.StartQuest(client, client, item);
-		if(lua_pcall(L, 1, 1, 0)) {
+		if(CallEvent(1, 1)) {
 			std::string error = lua_tostring(L, -1);
 			AddError(error);
 			quest_manager.EndQuest();
@@ -517,7 +524,7 @@ int LuaParser::_EventSpell(std::string package_name, QuestEventID evt, NPC* npc,
 			npop = 2;
 		}
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, LUA_EVENT_TABLE_FIELDS);
 
 		//always push self even if invalid
 		if(IsValidSpell(spell_id)) {
@@ -535,7 +542,7 @@ int LuaParser::_EventSpell(std::string package_name, QuestEventID evt, NPC* npc,
 		arg_function(this, L, npc, client, spell_id, extra_data, extra_pointers);
 
 		quest_manager.StartQuest(npc, client, nullptr);
-		if(lua_pcall(L, 1, 1, 0)) {
+		if(CallEvent(1, 1)) {
 			std::string error = lua_tostring(L, -1);
 			AddError(error);
 			quest_manager.EndQuest();
@@ -591,7 +598,7 @@ int LuaParser::_EventEncounter(std::string package_name, QuestEventID evt, std::
 		lua_getfield(L, LUA_REGISTRYINDEX, package_name.c_str());
 		lua_getfield(L, -1, sub_name);
 
-		lua_createtable(L, 0, 0);
+		lua_createtable(L, 0, LUA_EVENT_TABLE_FIELDS);
 		lua_pushstring(L, encounter_name.c_str());
 		lua_setfield(L, -2, "name");
 
@@ -601,7 +608,7 @@ int LuaParser::_EventEncounter(std::string package_name, QuestEventID evt, std::
 		arg_function(this, L, enc, data, extra_data, extra_pointers);
 
 		quest_manager.StartQuest(enc, nullptr, nullptr, encounter_name);
-		if(lua_pcall(L, 1, 1, 0)) {
+		if(CallEvent(1, 1)) {
 			std::string error = lua_tostring(L, -1);
 			AddError(error);
 			quest_manager.EndQuest();
@@ -714,6 +721,10 @@ bool LuaParser::EncounterHasQuestSub(std::string encounter_name, QuestEventID ev
 	return HasFunction(subname, package_name);
 }
 
+bool LuaParser::HasEncounterEvents() {
+	return !lua_encounter_events_registered.empty();
+}
+
 void LuaParser::LoadNPCScript(std::string filename, int npc_id) {
 	std::string package_name = "npc_" + std::to_string(npc_id);
 
@@ -786,6 +797,8 @@ void LuaParser::ReloadQuests() {
 	}
 
 	L = luaL_newstate();
+	gc_step_size_ = 0;
+	event_depth_ = 0;
 	luaL_openlibs(L);
 
 	if(luaopen_bit(L) != 1) {
@@ -889,6 +902,61 @@ void LuaParser::ReloadQuests() {
 	}
 }
 
+//count hook set around events, the count is only reached by a script that runs past its budget
+static void LuaEventWatchdog(lua_State *L, lua_Debug *ar) {
+	luaL_error(L, "event aborted after %d instructions", RuleI(Lua, EventInstructionLimit));
+}
+
+//lua_pcall of an event function with the watchdog armed; nested events run under the outer event's budget
+int LuaParser::CallEvent(int nargs, int nresults) {
+	int limit = RuleI(Lua, EventInstructionLimit);
+	bool watch = limit > 0 && event_depth_ == 0;
+	if(watch) {
+		lua_sethook(L, LuaEventWatchdog, LUA_MASKCOUNT, limit);
+	}
+
+	++event_depth_;
+	int ret = lua_pcall(L, nargs, nresults, 0);
+	--event_depth_;
+
+	if(watch) {
+		lua_sethook(L, nullptr, 0, 0);
+	}
+
+	return ret;
+}
+
+void LuaParser::CollectGarbage() {
+	if(!L) {
+		return;
+	}
+
+	int step_size = RuleI(Lua, GCStepSize);
+	if(step_size != gc_step_size_) {
+		//while we step it the collector is stopped, so it can't start a cycle in the middle of an event
+		lua_gc(L, step_size > 0 ? LUA_GCSTOP : LUA_GCRESTART, 0);
+		gc_step_size_ = step_size;
+	}
+
+	if(step_size <= 0) {
+		return;
+	}
+
+	double budget = RuleI(Lua, GCStepBudgetMS);
+	RDTSC_Timer timer(true);
+	while(true) {
+		//returns 1 when the step finished a cycle, the next one can wait for the next pass
+		if(lua_gc(L, LUA_GCSTEP, step_size)) {
+			break;
+		}
+
+		timer.stop();
+		if(timer.getDuration() >= budget) {
+			break;
+		}
+	}
+}
+
 void LuaParser::LoadScript(std::string filename, std::string package_name) {
 	auto iter = loaded_.find(package_name);
 	if(iter != loaded_.end()) {
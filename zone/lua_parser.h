@@ -49,6 +49,7 @@ public:
 	virtual bool SpellHasQuestSub(uint32 spell_id, QuestEventID evt);
 	virtual bool ItemHasQuestSub(ItemInst *itm, QuestEventID evt);
 	virtual bool EncounterHasQuestSub(std::string encounter_name, QuestEventID evt);
+	virtual bool HasEncounterEvents();
 
 	virtual void LoadNPCScript(std::string filename, int npc_id);
 	virtual void LoadGlobalNPCScript(std::string filename);
@@ -62,6 +63,7 @@ public:
 	virtual std::string GetVar(std::string name);
 	virtual void Init();
 	virtual void ReloadQuests();
+	virtual void CollectGarbage();
     virtual uint32 GetIdentifier() { return 0xb0712acc; }
 
 	virtual int DispatchEventNPC(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
@@ -85,6 +87,7 @@ private:
 	int _EventEncounter(std::string package_name, QuestEventID evt, std::string encounter_name, std::string data, uint32 extra_data,
 		std::vector<EQEmu::Any> *extra_pointers);
 
+	int CallEvent(int nargs, int nresults);
 	void LoadScript(std::string filename, std::string package_name);
 	bool HasFunction(std::string function, std::string package_name);
 	void ClearStates();
@@ -94,6 +97,8 @@ private:
 	std::map<std::string, std::string> vars_;
 	std::map<std::string, bool> loaded_;
 	lua_State *L;
+	int gc_step_size_;	//RuleI(Lua, GCStepSize) the collector was last set up for
+	int event_depth_;
 
 	NPCArgumentHandler NPCArgumentDispatch[_LargestEventID];
 	PlayerArgumentHandler PlayerArgumentDispatch[_LargestEventID];
@@ -25,6 +25,7 @@
 #include "worldserver.h"
 #include "remote_call_subscribe.h"
 
+#include <algorithm>
 #include <limits.h>
 #include <math.h>
 #include <sstream>
@@ -106,6 +107,8 @@ Mob::Mob(const char* in_name,
 {
 	targeted = 0;
 	tar_ndx=0;
+	m_RegionType = RegionTypeNormal;
+	m_RegionCached = false;
 	tar_vector=0;
 	curfp = false;
 
@@ -442,6 +445,11 @@ Mob::~Mob()
 
 	entity_list.RemoveFromTargets(this);
 
+	// haters that are not in the mob list still hold a pointer to us
+	std::vector<Mob*> haters(hated_by);
+	for (auto iter = haters.begin(); iter != haters.end(); ++iter)
+		(*iter)->RemoveFromHateList(this);
+
 	if(trade) {
 		Mob *with = trade->With();
 		if(with && with->IsClient()) {
@@ -2263,6 +2271,13 @@ bool Mob::RemoveFromHateList(Mob* mob)
 	return bFound;
 }
 
+void Mob::RemoveHatedBy(Mob* hater)
+{
+	auto iter = std::find(hated_by.begin(), hated_by.end(), hater);
+	if (iter != hated_by.end())
+		hated_by.erase(iter);
+}
+
 void Mob::WipeHateList()
 {
 	if(IsEngaged())
@@ -4312,6 +4327,9 @@ void Mob::AddFactionBonus(uint32 pFactionID,int32 bonus) {
 			faction_bonuses.insert(NewFactionBonus(pFactionID,bonus));
 		}
 	}
+
+	if (IsClient())
+		CastToClient()->InvalidateFactionCon();
 }
 
 // Faction Mods from items
@@ -4332,6 +4350,9 @@ void Mob::AddItemFactionBonus(uint32 pFactionID,int32 bonus) {
 			item_faction_bonuses.insert(NewFactionBonus(pFactionID,bonus));
 		}
 	}
+
+	if (IsClient())
+		CastToClient()->InvalidateFactionCon();
 }
 
 int32 Mob::GetFactionBonus(uint32 pFactionID) {
@@ -4356,6 +4377,8 @@ int32 Mob::GetItemFactionBonus(uint32 pFactionID) {
 
 void Mob::ClearItemFactionBonuses() {
 	item_faction_bonuses.clear();
+	if (IsClient())
+		CastToClient()->InvalidateFactionCon();
 }
 
 FACTION_VALUE Mob::GetSpecialFactionCon(Mob* iOther) {
@@ -5138,6 +5161,26 @@ float Mob::GetHeadingRadians()
 	return headingRadians * 3.141592f / 180.0f;
 }
 
+WaterRegionType Mob::GetRegionType()
+{
+	if (!zone->HasWaterMap())
+		return RegionTypeNormal;
+
+	glm::vec3 position(m_Position);
+	if (!m_RegionCached || position != m_RegionPosition) {
+		m_RegionType = zone->watermap->ReturnRegionType(position);
+		m_RegionPosition = position;
+		m_RegionCached = true;
+	}
+	return m_RegionType;
+}
+
+bool Mob::IsInLiquid()
+{
+	WaterRegionType type = GetRegionType();
+	return type == RegionTypeWater || type == RegionTypeLava;
+}
+
 bool Mob::IsFacingTarget()
 {
 	if (!target)
@@ -23,6 +23,7 @@
 #include "hate_list.h"
 #include "pathing.h"
 #include "position.h"
+#include "water_map.h"
 #include <set>
 #include <vector>
 #include <memory>
@@ -396,6 +397,8 @@ public:
 	inline const float GetZ() const { return m_Position.z; }
 	inline const float GetHeading() const { return m_Position.w; }
 	float GetHeadingRadians();
+	WaterRegionType GetRegionType();	//watermap region at our position, looked up again only once we move
+	bool IsInLiquid();
 	inline const float GetEQX() const { return m_EQPosition.x; }
 	inline const float GetEQY() const { return m_EQPosition.y; }
 	inline const float GetEQZ() const { return m_EQPosition.z; }
@@ -488,7 +491,11 @@ public:
 	void RemoveFromFeignMemory(Client* attacker);
 	void ClearFeignMemory();
 	void PrintHateListToClient(Client *who) { hate_list.PrintToClient(who); }
-	std::list<tHateEntry*>& GetHateList() { return hate_list.GetHateList(); }
+	std::vector<tHateEntry*>& GetHateList() { return hate_list.GetHateList(); }
+	// mobs with this one on their hate list, kept up to date by HateList
+	const std::vector<Mob*>& GetHatedBy() const { return hated_by; }
+	void AddHatedBy(Mob* hater) { hated_by.push_back(hater); }
+	void RemoveHatedBy(Mob* hater);
 	bool CheckLosFN(Mob* other);
 	bool CheckLosFN(float posX, float posY, float posZ, float mobSize);
 	bool CheckRegion(Mob* other, bool skipwater = true);
@@ -760,6 +767,7 @@ public:
 
 	FACTION_VALUE GetSpecialFactionCon(Mob* iOther);
 	inline const bool IsAIControlled() const { return pAIControlled; }
+	inline bool AIScanAreaDue() { return AIscanarea_timer && AIscanarea_timer->Enabled() && AIscanarea_timer->Check(false); }
 	inline const float GetAggroRange() const { return (spellbonuses.AggroRange == -1) ? pAggroRange : spellbonuses.AggroRange; }
 	inline const float GetAssistRange() const { return (spellbonuses.AssistRange == -1) ? pAssistRange : spellbonuses.AssistRange; }
 
@@ -1050,6 +1058,9 @@ protected:
 	uint8 orig_level;
 	uint32 npctype_id;
 	glm::vec4 m_Position;
+	glm::vec3 m_RegionPosition;	//where m_RegionType was looked up
+	WaterRegionType m_RegionType;
+	bool m_RegionCached;
 	glm::vec4 m_EQPosition; // This acts as a home/backup set of coords. It is currently used to set a home point for Eye of Zomm.
 	uint16 animation;
 	float base_size;
@@ -1203,6 +1214,7 @@ protected:
 	std::unique_ptr<Timer> AIhail_timer;
 	uint32 pLastFightingDelayMoving;
 	HateList hate_list;
+	std::vector<Mob*> hated_by;
 	std::set<uint32> feign_memory_list;
 	// This is to keep track of mobs we cast faction mod spells on
 	std::map<uint32,int32> faction_bonuses; // Primary FactionID, Bonus
@@ -31,6 +31,7 @@
 #include "water_map.h"
 #include "remote_call.h"
 #include "remote_call_subscribe.h"
+#include "zone_profiler.h"
 
 #include <algorithm>
 #include <iostream>
@@ -58,6 +59,15 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 	if(AI_HasSpells() == false)
 		return false;
 
+	const AISpellsList_Struct* list = AIspells;
+	if (!list)
+		return false;
+
+	// nothing of the wanted types, skip the roll and the range math
+	uint16 matched_types = list->types & iSpellTypes;
+	if (matched_types == 0)
+		return false;
+
 	if (iChance < 100) {
 		if (zone->random.Int(0, 100) >= iChance)
 			return false;
@@ -76,46 +86,57 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 	if (zone->SkipLoS())
 		checkedTargetLoS = true;		// ignore LoS checks in zones with LoS disabled
 
-	for (int i = static_cast<int>(AIspells.size()) - 1; i >= 0; i--) {
-		if (AIspells[i].spellid <= 0 || AIspells[i].spellid >= SPDAT_RECORDS) {
+	// a single type walks its own bucket, anything wider walks the whole list
+	const std::vector<uint8>* bucket = nullptr;
+	if ((matched_types & (matched_types - 1)) == 0) {
+		int bit = 0;
+		while (!(matched_types & (1 << bit)))
+			bit++;
+		bucket = &list->by_type[bit];
+	}
+
+	int count = bucket ? static_cast<int>(bucket->size()) : static_cast<int>(list->spells.size());
+	for (int n = count - 1; n >= 0; n--) {
+		int i = bucket ? (*bucket)[n] : n;
+		if (list->spells[i].spellid <= 0 || list->spells[i].spellid >= SPDAT_RECORDS) {
 			// this is both to quit early to save cpu and to avoid casting bad spells
 			// Bad info from database can trigger this incorrectly, but that should be fixed in DB, not here
 			//return false;
 			continue;
 		}
-		if (iSpellTypes & AIspells[i].type) {
+		if (iSpellTypes & list->spells[i].type) {
 			// manacost has special values, -1 is no mana cost, -2 is instant cast (no mana)
 			// recastdelay of 0 is recast time + variance. -1 recast time only. -2 is no recast time or variance (chain casting)
 			// All else is specified recast_delay + variance if the rule is enabled.
-			int32 mana_cost = AIspells[i].manacost;
+			int32 mana_cost = list->spells[i].manacost;
 			if (mana_cost == -1)
-				mana_cost = spells[AIspells[i].spellid].mana;
+				mana_cost = spells[list->spells[i].spellid].mana;
 			else if (mana_cost == -2)
 				mana_cost = 0;
 			if (
 				((
-					(spells[AIspells[i].spellid].targettype==ST_AECaster || spells[AIspells[i].spellid].targettype==ST_AEBard)
-					&& dist2 <= spells[AIspells[i].spellid].aoerange*spells[AIspells[i].spellid].aoerange
-				) || dist2 <= spells[AIspells[i].spellid].range*spells[AIspells[i].spellid].range)
-				&& (!zeroPriorityOnly || AIspells[i].priority == 0)
+					(spells[list->spells[i].spellid].targettype==ST_AECaster || spells[list->spells[i].spellid].targettype==ST_AEBard)
+					&& dist2 <= spells[list->spells[i].spellid].aoerange*spells[list->spells[i].spellid].aoerange
+				) || dist2 <= spells[list->spells[i].spellid].range*spells[list->spells[i].spellid].range)
+				&& (!zeroPriorityOnly || list->spells[i].priority == 0)
 				&& (mana_cost <= GetMana() || GetMana() == GetMaxMana())
-				&& (AIspells[i].time_cancast) <= Timer::GetCurrentTime()
+				&& (AIspells_cancast[i]) <= Timer::GetCurrentTime()
 				) {
 
 #if MobAI_DEBUG_Spells >= 21
-				std::cout << "Mob::AICastSpell: Casting: spellid=" << AIspells[i].spellid
+				std::cout << "Mob::AICastSpell: Casting: spellid=" << list->spells[i].spellid
 					<< ", tar=" << tar->GetName()
-					<< ", dist2[" << dist2 << "]<=" << spells[AIspells[i].spellid].range *spells[AIspells[i].spellid].range
+					<< ", dist2[" << dist2 << "]<=" << spells[list->spells[i].spellid].range *spells[list->spells[i].spellid].range
 					<< ", mana_cost[" << mana_cost << "]<=" << GetMana()
-					<< ", cancast[" << AIspells[i].time_cancast << "]<=" << Timer::GetCurrentTime()
-					<< ", type=" << AIspells[i].type << std::endl;
+					<< ", cancast[" << AIspells_cancast[i] << "]<=" << Timer::GetCurrentTime()
+					<< ", type=" << list->spells[i].type << std::endl;
 #endif
-				switch (AIspells[i].type)
+				switch (list->spells[i].type)
 				{
 					case SpellType_Heal:
 					{
 						if (
-							(spells[AIspells[i].spellid].targettype == ST_Target || tar == this)
+							(spells[list->spells[i].spellid].targettype == ST_Target || tar == this)
 							&& tar->DontHealMeBefore() < Timer::GetCurrentTime()
 							&& !(tar->IsPet() && tar->GetOwner()->IsClient())	//no buffing PC's pets
 						)
@@ -134,10 +155,10 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 					case SpellType_Root:
 					{
 						Mob *rootee = GetHateRandom();
-						if (rootee && !rootee->IsRooted() && (zone->random.Roll(50) || AIspells[i].priority == 0)
+						if (rootee && !rootee->IsRooted() && (zone->random.Roll(50) || list->spells[i].priority == 0)
 							&& rootee->DontRootMeBefore() < Timer::GetCurrentTime()
-							&& DistanceSquared(m_Position, rootee->GetPosition()) < spells[AIspells[i].spellid].range*spells[AIspells[i].spellid].range
-							&& rootee->CanBuffStack(AIspells[i].spellid, GetLevel(), true) >= 0
+							&& DistanceSquared(m_Position, rootee->GetPosition()) < spells[list->spells[i].spellid].range*spells[list->spells[i].spellid].range
+							&& rootee->CanBuffStack(list->spells[i].spellid, GetLevel(), true) >= 0
 							) {
 							if(!CheckLosFN(rootee))
 								return(false);	//cannot see target... we assume that no spell is going to work since we will only be casting detrimental spells in this call
@@ -150,10 +171,10 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 					}
 					case SpellType_Buff: {
 						if (
-							(spells[AIspells[i].spellid].targettype == ST_Target || tar == this)
+							(spells[list->spells[i].spellid].targettype == ST_Target || tar == this)
 							&& tar->DontBuffMeBefore() < Timer::GetCurrentTime()
-							&& !tar->IsImmuneToSpell(AIspells[i].spellid, this)
-							&& tar->CanBuffStack(AIspells[i].spellid, GetLevel(), true) >= 0
+							&& !tar->IsImmuneToSpell(list->spells[i].spellid, this)
+							&& tar->CanBuffStack(list->spells[i].spellid, GetLevel(), true) >= 0
 							&& !(tar->IsPet() && tar->GetOwner()->IsClient() && this != tar)	//no buffing PC's pets, but they can buff themself
 							)
 						{
@@ -166,7 +187,7 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 					}
 
 					case SpellType_InCombatBuff: {
-						if (zone->random.Roll(50) || AIspells[i].priority == 0)
+						if (zone->random.Roll(50) || list->spells[i].priority == 0)
 						{
 							AIDoSpellCast(i, tar, mana_cost);
 							return true;
@@ -188,11 +209,11 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 					case SpellType_Slow:
 					{
 						Mob * debuffee = GetHateRandom();
-						if (debuffee && (zone->random.Roll(70) || AIspells[i].priority == 0) && debuffee->IsWarriorClass()
-							&& DistanceSquared(m_Position, debuffee->GetPosition()) < spells[AIspells[i].spellid].range*spells[AIspells[i].spellid].range
-							&& debuffee->CanBuffStack(AIspells[i].spellid, GetLevel(), true) >= 0)
+						if (debuffee && (zone->random.Roll(70) || list->spells[i].priority == 0) && debuffee->IsWarriorClass()
+							&& DistanceSquared(m_Position, debuffee->GetPosition()) < spells[list->spells[i].spellid].range*spells[list->spells[i].spellid].range
+							&& debuffee->CanBuffStack(list->spells[i].spellid, GetLevel(), true) >= 0)
 						{
-							if (spells[AIspells[i].spellid].targettype == ST_AECaster || spells[AIspells[i].spellid].npc_no_los || CheckLosFN(debuffee))
+							if (spells[list->spells[i].spellid].targettype == ST_AECaster || spells[list->spells[i].spellid].npc_no_los || CheckLosFN(debuffee))
 							{
 								AIDoSpellCast(i, debuffee, mana_cost);
 								return true;
@@ -203,11 +224,11 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 					case SpellType_Debuff:
 					{
 						Mob * debuffee = GetHateRandom();
-						if (debuffee && (zone->random.Roll(50) || AIspells[i].priority == 0)
-							&& DistanceSquared(m_Position, debuffee->GetPosition()) < spells[AIspells[i].spellid].range*spells[AIspells[i].spellid].range
-							&& debuffee->CanBuffStack(AIspells[i].spellid, GetLevel(), true) >= 0)
+						if (debuffee && (zone->random.Roll(50) || list->spells[i].priority == 0)
+							&& DistanceSquared(m_Position, debuffee->GetPosition()) < spells[list->spells[i].spellid].range*spells[list->spells[i].spellid].range
+							&& debuffee->CanBuffStack(list->spells[i].spellid, GetLevel(), true) >= 0)
 						{
-							if (spells[AIspells[i].spellid].targettype == ST_AECaster || spells[AIspells[i].spellid].npc_no_los || CheckLosFN(debuffee))
+							if (spells[list->spells[i].spellid].targettype == ST_AECaster || spells[list->spells[i].spellid].npc_no_los || CheckLosFN(debuffee))
 							{
 								AIDoSpellCast(i, debuffee, mana_cost);
 								return true;
@@ -217,7 +238,7 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 					}
 					case SpellType_Nuke:
 					{
-						if (AIspells[i].spellid == SPELL_CAZIC_TOUCH)
+						if (list->spells[i].spellid == SPELL_CAZIC_TOUCH)
 						{
 							if (tar->IsPet() && tar->GetOwner())
 							{
@@ -230,11 +251,11 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 							return true;
 						}
 
-						if ((AIspells[i].priority == 0 || zone->random.Roll(40))
-							&& (mana_cost == 0 || spells[AIspells[i].spellid].buffduration == 0)
-							|| tar->CanBuffStack(AIspells[i].spellid, GetLevel(), true) >= 0)
+						if ((list->spells[i].priority == 0 || zone->random.Roll(40))
+							&& (mana_cost == 0 || spells[list->spells[i].spellid].buffduration == 0)
+							|| tar->CanBuffStack(list->spells[i].spellid, GetLevel(), true) >= 0)
 						{
-							if (spells[AIspells[i].spellid].targettype != ST_AECaster && !spells[AIspells[i].spellid].npc_no_los)
+							if (spells[list->spells[i].spellid].targettype != ST_AECaster && !spells[list->spells[i].spellid].npc_no_los)
 							{
 								if (!checkedTargetLoS)
 								{
@@ -252,9 +273,9 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 					}
 					case SpellType_Dispel:
 					{
-						if (zone->random.Roll(10) || AIspells[i].priority == 0)
+						if (zone->random.Roll(10) || list->spells[i].priority == 0)
 						{
-							if (spells[AIspells[i].spellid].targettype != ST_AECaster && !spells[AIspells[i].spellid].npc_no_los)
+							if (spells[list->spells[i].spellid].targettype != ST_AECaster && !spells[list->spells[i].spellid].npc_no_los)
 							{
 								if (!checkedTargetLoS)
 								{
@@ -275,12 +296,12 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 					}
 					case SpellType_Mez:
 					{
-						if (zone->random.Roll(20) || AIspells[i].priority == 0)
+						if (zone->random.Roll(20) || list->spells[i].priority == 0)
 						{
 							Mob * mezTar = nullptr;
 							mezTar = entity_list.GetTargetForMez(this);
 
-							if(mezTar && mezTar->CanBuffStack(AIspells[i].spellid, GetLevel(), true) >= 0)
+							if(mezTar && mezTar->CanBuffStack(list->spells[i].spellid, GetLevel(), true) >= 0)
 							{
 								AIDoSpellCast(i, mezTar, mana_cost);
 								return true;
@@ -291,12 +312,12 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 
 					case SpellType_Charm:
 					{
-						if(!IsPet() && (zone->random.Roll(20) || AIspells[i].priority == 0))
+						if(!IsPet() && (zone->random.Roll(20) || list->spells[i].priority == 0))
 						{
 							Mob * chrmTar = GetHateRandom();
-							if (chrmTar && DistanceSquared(m_Position, chrmTar->GetPosition()) < spells[AIspells[i].spellid].range*spells[AIspells[i].spellid].range)
+							if (chrmTar && DistanceSquared(m_Position, chrmTar->GetPosition()) < spells[list->spells[i].spellid].range*spells[list->spells[i].spellid].range)
 							{
-								if (spells[AIspells[i].spellid].targettype == ST_AECaster || spells[AIspells[i].spellid].npc_no_los || CheckLosFN(chrmTar))
+								if (spells[list->spells[i].spellid].targettype == ST_AECaster || spells[list->spells[i].spellid].npc_no_los || CheckLosFN(chrmTar))
 								{
 									AIDoSpellCast(i, chrmTar, mana_cost);
 									return true;
@@ -317,11 +338,11 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 					case SpellType_Lifetap:
 					{
 						if (GetHPRatio() <= 95
-							&& (zone->random.Roll(50) || AIspells[i].priority == 0)
-							&& tar->CanBuffStack(AIspells[i].spellid, GetLevel(), true) >= 0
+							&& (zone->random.Roll(50) || list->spells[i].priority == 0)
+							&& tar->CanBuffStack(list->spells[i].spellid, GetLevel(), true) >= 0
 						)
 						{
-							if (spells[AIspells[i].spellid].targettype != ST_AECaster && !spells[AIspells[i].spellid].npc_no_los)
+							if (spells[list->spells[i].spellid].targettype != ST_AECaster && !spells[list->spells[i].spellid].npc_no_los)
 							{
 								if (!checkedTargetLoS)
 								{
@@ -341,12 +362,12 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 					{
 						if (
 							!tar->IsRooted()
-							&& (zone->random.Roll(50) || AIspells[i].priority == 0)
+							&& (zone->random.Roll(50) || list->spells[i].priority == 0)
 							&& tar->DontSnareMeBefore() < Timer::GetCurrentTime()
-							&& tar->CanBuffStack(AIspells[i].spellid, GetLevel(), true) >= 0
+							&& tar->CanBuffStack(list->spells[i].spellid, GetLevel(), true) >= 0
 						)
 						{
-							if (spells[AIspells[i].spellid].targettype != ST_AECaster && !spells[AIspells[i].spellid].npc_no_los)
+							if (spells[list->spells[i].spellid].targettype != ST_AECaster && !spells[list->spells[i].spellid].npc_no_los)
 							{
 								if (!checkedTargetLoS)
 								{
@@ -367,12 +388,12 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 					case SpellType_DOT:
 					{
 						if (
-							(zone->random.Roll(60) || AIspells[i].priority == 0)
+							(zone->random.Roll(60) || list->spells[i].priority == 0)
 							&& tar->DontDotMeBefore() < Timer::GetCurrentTime()
-							&& tar->CanBuffStack(AIspells[i].spellid, GetLevel(), true) >= 0
+							&& tar->CanBuffStack(list->spells[i].spellid, GetLevel(), true) >= 0
 						)
 						{
-							if (spells[AIspells[i].spellid].targettype != ST_AECaster && !spells[AIspells[i].spellid].npc_no_los)
+							if (spells[list->spells[i].spellid].targettype != ST_AECaster && !spells[list->spells[i].spellid].npc_no_los)
 							{
 								if (!checkedTargetLoS)
 								{
@@ -391,14 +412,14 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 						break;
 					}
 					default: {
-						std::cout << "Error: Unknown spell type in AICastSpell. caster:" << this->GetName() << " type:" << AIspells[i].type << " slot:" << i << std::endl;
+						std::cout << "Error: Unknown spell type in AICastSpell. caster:" << this->GetName() << " type:" << list->spells[i].type << " slot:" << i << std::endl;
 						break;
 					}
 				}
 			}
 #if MobAI_DEBUG_Spells >= 21
 			else {
-				std::cout << "Mob::AICastSpell: NotCasting: spellid=" << AIspells[i].spellid << ", tar=" << tar->GetName() << ", dist2[" << dist2 << "]<=" << spells[AIspells[i].spellid].range*spells[AIspells[i].spellid].range << ", mana_cost[" << mana_cost << "]<=" << GetMana() << ", cancast[" << AIspells[i].time_cancast << "]<=" << Timer::GetCurrentTime() << std::endl;
+				std::cout << "Mob::AICastSpell: NotCasting: spellid=" << list->spells[i].spellid << ", tar=" << tar->GetName() << ", dist2[" << dist2 << "]<=" << spells[list->spells[i].spellid].range*spells[list->spells[i].spellid].range << ", mana_cost[" << mana_cost << "]<=" << GetMana() << ", cancast[" << AIspells_cancast[i] << "]<=" << Timer::GetCurrentTime() << std::endl;
 			}
 #endif
 		}
@@ -408,17 +429,20 @@ bool NPC::AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPrio
 
 bool NPC::AIDoSpellCast(uint8 i, Mob* tar, int32 mana_cost, uint32* oDontDoAgainBefore) {
 #if MobAI_DEBUG_Spells >= 1
-	std::cout << "Mob::AIDoSpellCast: spellid=" << AIspells[i].spellid << ", tar=" << tar->GetName() << ", mana=" << mana_cost << ", Name: " << spells[AIspells[i].spellid].name << std::endl;
+	std::cout << "Mob::AIDoSpellCast: spellid=" << AIspells->spells[i].spellid << ", tar=" << tar->GetName() << ", mana=" << mana_cost << ", Name: " << spells[AIspells->spells[i].spellid].name << std::endl;
 #endif
 	casting_spell_AIindex = i;
 
+	const AISpells_Struct& spell = AIspells->spells[i];
+
 	//stop moving if were casting a spell and were not a bard...
-	if(!IsBardSong(AIspells[i].spellid)) {
+	if(!IsBardSong(spell.spellid)) {
 		SetRunAnimSpeed(0);
 		SendPosition();
 		SetMoving(false);
 	}
-	return CastSpell(AIspells[i].spellid, tar->GetID(), 1, spells[AIspells[i].spellid].cast_time, mana_cost, oDontDoAgainBefore, -1, -1, 0, 0, &(AIspells[i].resist_adjust));
+	int16 resist_adjust = spell.resist_adjust;
+	return CastSpell(spell.spellid, tar->GetID(), 1, spells[spell.spellid].cast_time, mana_cost, oDontDoAgainBefore, -1, -1, 0, 0, &resist_adjust);
 }
 
 bool EntityList::AICheckCloseBeneficialSpells(NPC* caster, uint8 iChance, float iRange, uint16 iSpellTypes) {
@@ -438,6 +462,9 @@ bool EntityList::AICheckCloseBeneficialSpells(NPC* caster, uint8 iChance, float
 	if(caster->AI_HasSpells() == false)
 		return false;
 
+	if(!caster->AI_HasSpellTypes(iSpellTypes))
+		return false;
+
 	if(caster->GetSpecialAbility(NPC_NO_BUFFHEAL_FRIENDS))
 		return false;
 
@@ -516,7 +543,7 @@ void Mob::AI_Init() {
 void NPC::AI_Init()
 {
 	AIautocastspell_timer.reset(nullptr);
-	casting_spell_AIindex = static_cast<uint8>(AIspells.size());
+	casting_spell_AIindex = static_cast<uint8>(AISpellCount());
 
 	roambox_max_x = 0;
 	roambox_max_y = 0;
@@ -591,7 +618,7 @@ void NPC::AI_Start(uint32 iMoveDelay) {
 	if (!pAIControlled)
 		return;
 
-	if (AIspells.size() == 0) {
+	if (AISpellCount() == 0) {
 		AIautocastspell_timer = std::unique_ptr<Timer>(new Timer(1000));
 		AIautocastspell_timer->Disable();
 	} else {
@@ -808,6 +835,8 @@ void Client::AI_SpellCast()
 
 void Client::AI_Process()
 {
+	PROFILE_PHASE(AIProcess);
+
 	if (!IsAIControlled())
 		return;
 
@@ -1266,6 +1295,7 @@ void Mob::DoOffHandRound(Mob* victim, ExtraAttackOptions *opts)
 }
 
 void Mob::AI_Process() {
+	PROFILE_PHASE(AIProcess);
 	
 	if (!IsAIControlled())
 		return;
@@ -2274,9 +2304,11 @@ void NPC::AI_Event_SpellCastFinished(bool iCastSucceeded, uint16 slot)
 		uint32 recovery_time = 0;
 		if (iCastSucceeded)
 		{
-			if (casting_spell_AIindex < AIspells.size())
+			if (casting_spell_AIindex < AISpellCount())
 			{
-				int32 recast_delay = AIspells[casting_spell_AIindex].recast_delay;
+				const AISpells_Struct& spell = AIspells->spells[casting_spell_AIindex];
+				uint32& time_cancast = AIspells_cancast[casting_spell_AIindex];
+				int32 recast_delay = spell.recast_delay;
 				int32 cast_variance = 0;
 
 				if (RuleB(Spells, NPCUseRecastVariance) || recast_delay == 0)
@@ -2285,23 +2317,23 @@ void NPC::AI_Event_SpellCastFinished(bool iCastSucceeded, uint16 slot)
 						cast_variance = zone->random.Int(0, 4) * 1000;
 				}
 
-				recovery_time += spells[AIspells[casting_spell_AIindex].spellid].recovery_time;
+				recovery_time += spells[spell.spellid].recovery_time;
 
 				if (recast_delay > 0)
 				{
 					if (recast_delay < 10000)
-						AIspells[casting_spell_AIindex].time_cancast = Timer::GetCurrentTime() + (recast_delay * 1000) + cast_variance;
+						time_cancast = Timer::GetCurrentTime() + (recast_delay * 1000) + cast_variance;
 				}
 				else if (recast_delay == -1)
 					// editor default; add variance
-					AIspells[casting_spell_AIindex].time_cancast = Timer::GetCurrentTime() + spells[AIspells[casting_spell_AIindex].spellid].recast_time + cast_variance;
+					time_cancast = Timer::GetCurrentTime() + spells[spell.spellid].recast_time + cast_variance;
 
 				else if (recast_delay == -2)
-					AIspells[casting_spell_AIindex].time_cancast = Timer::GetCurrentTime();
+					time_cancast = Timer::GetCurrentTime();
 
 				else
 					// 0; no variance
-					AIspells[casting_spell_AIindex].time_cancast = Timer::GetCurrentTime() + spells[AIspells[casting_spell_AIindex].spellid].recast_time;
+					time_cancast = Timer::GetCurrentTime() + spells[spell.spellid].recast_time;
 			}
 			if (recovery_time < AIautocastspell_timer->GetSetAtTrigger())
 				recovery_time = AIautocastspell_timer->GetSetAtTrigger();
@@ -2311,7 +2343,7 @@ void NPC::AI_Event_SpellCastFinished(bool iCastSucceeded, uint16 slot)
 		{
 			AIautocastspell_timer->Start(AISpellVar.fail_recast, false);
 		}
-		casting_spell_AIindex = AIspells.size();
+		casting_spell_AIindex = AISpellCount();
 	}
 }
 
@@ -2807,7 +2839,9 @@ bool IsSpellEffectInList(DBnpcspellseffects_Struct* spelleffect_list, uint16 iSp
 bool NPC::AI_AddNPCSpells(uint32 iDBSpellsID) {
 	// ok, this function should load the list, and the parent list then shove them into the struct and sort
 	npc_spells_id = iDBSpellsID;
-	AIspells.clear();
+	AIspells = nullptr;
+	safe_delete(AIspells_ours);
+	AIspells_cancast.clear();
 	if (iDBSpellsID == 0) {
 		AIautocastspell_timer->Disable();
 		return false;
@@ -2818,7 +2852,6 @@ bool NPC::AI_AddNPCSpells(uint32 iDBSpellsID) {
 		return false;
 	}
 	DBnpcspells_Struct* parentlist = database.GetNPCSpells(spell_list->parent_list);
-	uint32 i;
 #if MobAI_DEBUG_Spells >= 10
 	std::cout << "Loading NPCSpells onto " << this->GetName() << ": dbspellsid=" << iDBSpellsID;
 	if (spell_list) {
@@ -2873,17 +2906,6 @@ bool NPC::AI_AddNPCSpells(uint32 iDBSpellsID) {
 		_idle_no_sp_recast_min = parentlist->idle_no_sp_recast_min;
 		_idle_no_sp_recast_max = parentlist->idle_no_sp_recast_max;
 		_idle_beneficial_chance = parentlist->idle_beneficial_chance;
-		for (i=0; i<parentlist->numentries; i++) {
-			if (GetLevel() >= parentlist->entries[i].minlevel && GetLevel() <= parentlist->entries[i].maxlevel && parentlist->entries[i].spellid > 0) {
-				if (!IsSpellInList(spell_list, parentlist->entries[i].spellid))
-				{
-					AddSpellToNPCList(parentlist->entries[i].priority,
-						parentlist->entries[i].spellid, parentlist->entries[i].type,
-						parentlist->entries[i].manacost, parentlist->entries[i].recast_delay,
-						parentlist->entries[i].resist_adjust);
-				}
-			}
-		}
 	}
 	if (spell_list->attack_proc >= 0) {
 		attack_proc_spell = spell_list->attack_proc;
@@ -2915,17 +2937,14 @@ bool NPC::AI_AddNPCSpells(uint32 iDBSpellsID) {
 		_idle_beneficial_chance = spell_list->idle_beneficial_chance;
 	}
 
-	for (i=0; i<spell_list->numentries; i++) {
-		if (GetLevel() >= spell_list->entries[i].minlevel && GetLevel() <= spell_list->entries[i].maxlevel && spell_list->entries[i].spellid > 0) {
-			AddSpellToNPCList(spell_list->entries[i].priority,
-				spell_list->entries[i].spellid, spell_list->entries[i].type,
-				spell_list->entries[i].manacost, spell_list->entries[i].recast_delay,
-				spell_list->entries[i].resist_adjust);
-		}
+	AIspells = database.GetNPCSpellsList(iDBSpellsID, GetLevel());
+	if (AIspells) {
+		AIspells_cancast.assign(AIspells->spells.size(), 0);
+		if (!AIspells->spells.empty())
+			HasAISpell = true;
+		if (AIspells->has_zero_priority)
+			hasZeroPrioritySpells = true;
 	}
-	std::sort(AIspells.begin(), AIspells.end(), [](const AISpells_Struct& a, const AISpells_Struct& b) {
-		return a.priority > b.priority;
-	});
 
 	if (IsValidSpell(attack_proc_spell))
 		AddProcToWeapon(attack_proc_spell, true, proc_chance);
@@ -2945,7 +2964,7 @@ bool NPC::AI_AddNPCSpells(uint32 iDBSpellsID) {
 	AISpellVar.idle_no_sp_recast_max = (_idle_no_sp_recast_max) ? _idle_no_sp_recast_max : RuleI(Spells, AI_IdleNoSpellMaxRecast);
 	AISpellVar.idle_beneficial_chance = (_idle_beneficial_chance) ? _idle_beneficial_chance : RuleI(Spells, AI_IdleBeneficialChance);
 
-	if (AIspells.size() == 0)
+	if (AISpellCount() == 0)
 		AIautocastspell_timer->Disable();
 	else
 		AIautocastspell_timer->Start(RandomTimer(2000, 15000), false);
@@ -3059,15 +3078,12 @@ bool IsSpellInList(DBnpcspells_Struct* spell_list, int16 iSpellID) {
 	return false;
 }
 
-// adds a spell to the list, taking into account priority and resorting list as needed.
-void NPC::AddSpellToNPCList(int16 iPriority, int16 iSpellID, uint16 iType,
+static void AddSpellToList(AISpellsList_Struct* list, int16 iPriority, int16 iSpellID, uint16 iType,
 							int16 iManaCost, int32 iRecastDelay, int16 iResistAdjust)
 {
-
 	if(!IsValidSpell(iSpellID))
 		return;
 
-	HasAISpell = true;
 	AISpells_Struct t;
 
 	t.priority = iPriority;
@@ -3075,41 +3091,140 @@ void NPC::AddSpellToNPCList(int16 iPriority, int16 iSpellID, uint16 iType,
 	t.type = iType;
 	t.manacost = iManaCost;
 	t.recast_delay = iRecastDelay;
-	t.time_cancast = 0;
 	t.resist_adjust = iResistAdjust;
 
-	AIspells.push_back(t);
+	list->spells.push_back(t);
+}
+
+// rebuilds the type buckets after the spells changed
+static void IndexSpellsList(AISpellsList_Struct* list)
+{
+	list->types = 0;
+	list->has_zero_priority = false;
+	for (int bit = 0; bit < 16; bit++)
+		list->by_type[bit].clear();
+
+	// casting_spell_AIindex is a uint8, nothing past that can be cast anyway
+	for (uint32 i = 0; i < list->spells.size() && i < 0xFF; i++) {
+		const AISpells_Struct& spell = list->spells[i];
+		list->types |= spell.type;
+		for (int bit = 0; bit < 16; bit++) {
+			if (spell.type & (1 << bit))
+				list->by_type[bit].push_back(static_cast<uint8>(i));
+		}
+		if (spell.priority == 0 && spell.type & (SpellType_Nuke | SpellType_Lifetap | SpellType_DOT | SpellType_Dispel | SpellType_Mez | SpellType_Slow | SpellType_Debuff | SpellType_Charm | SpellType_Root))
+			list->has_zero_priority = true;
+	}
+}
+
+// the shared list is never written, quests editing an NPC's spells get it a copy of its own
+AISpellsList_Struct* NPC::AISpellsForWrite()
+{
+	if (!AIspells_ours) {
+		AIspells_ours = new AISpellsList_Struct;
+		if (AIspells)
+			*AIspells_ours = *AIspells;
+		else
+			IndexSpellsList(AIspells_ours);
+		AIspells = AIspells_ours;
+	}
+	return AIspells_ours;
+}
 
-	if (iPriority == 0 && iType & (SpellType_Nuke | SpellType_Lifetap | SpellType_DOT | SpellType_Dispel | SpellType_Mez | SpellType_Slow | SpellType_Debuff | SpellType_Charm | SpellType_Root))
+// adds a spell to the end of the list, the list is not resorted.
+void NPC::AddSpellToNPCList(int16 iPriority, int16 iSpellID, uint16 iType,
+							int16 iManaCost, int32 iRecastDelay, int16 iResistAdjust)
+{
+
+	if(!IsValidSpell(iSpellID))
+		return;
+
+	HasAISpell = true;
+	AISpellsList_Struct* list = AISpellsForWrite();
+	AddSpellToList(list, iPriority, iSpellID, iType, iManaCost, iRecastDelay, iResistAdjust);
+	AIspells_cancast.push_back(0);
+	IndexSpellsList(list);
+
+	if (list->has_zero_priority)
 		hasZeroPrioritySpells = true;
 }
 
 void NPC::RemoveSpellFromNPCList(int16 spell_id)
 {
-	std::vector<AISpells_Struct>::iterator iter = AIspells.begin();
-	while(iter != AIspells.end())
+	if (!AIspells)
+		return;
+
+	AISpellsList_Struct* list = AISpellsForWrite();
+	uint32 kept = 0;
+	for (uint32 i = 0; i < list->spells.size(); i++)
 	{
-		if((*iter).spellid == spell_id)
-		{
-			iter = AIspells.erase(iter);
+		if (list->spells[i].spellid == spell_id)
 			continue;
-		}
-		++iter;
+		list->spells[kept] = list->spells[i];
+		AIspells_cancast[kept] = AIspells_cancast[i];
+		kept++;
 	}
+	list->spells.resize(kept);
+	AIspells_cancast.resize(kept);
+	IndexSpellsList(list);
 }
 
 void NPC::AISpellsList(Client *c)
 {
-	if (!c)
+	if (!c || !AIspells)
 		return;
 
-	for (std::vector<AISpells_Struct>::iterator it = AIspells.begin(); it != AIspells.end(); ++it)
+	for (std::vector<AISpells_Struct>::const_iterator it = AIspells->spells.begin(); it != AIspells->spells.end(); ++it)
 		c->Message(CC_Default, "%s (%d): Type %d, Priority %d",
 				spells[it->spellid].name, it->spellid, it->type, it->priority);
 
 	return;
 }
 
+const AISpellsList_Struct* ZoneDatabase::GetNPCSpellsList(uint32 iDBSpellsID, uint8 level) {
+	DBnpcspells_Struct* spell_list = GetNPCSpells(iDBSpellsID);
+	if (!spell_list)
+		return nullptr;
+
+	uint64 key = (static_cast<uint64>(iDBSpellsID) << 8) | level;
+	auto it = npc_spells_lists.find(key);
+	if (it != npc_spells_lists.end())
+		return it->second;
+
+	AISpellsList_Struct* list = new AISpellsList_Struct;
+	DBnpcspells_Struct* parentlist = GetNPCSpells(spell_list->parent_list);
+	uint32 i;
+	if (parentlist) {
+		for (i=0; i<parentlist->numentries; i++) {
+			if (level >= parentlist->entries[i].minlevel && level <= parentlist->entries[i].maxlevel && parentlist->entries[i].spellid > 0) {
+				if (!IsSpellInList(spell_list, parentlist->entries[i].spellid))
+				{
+					AddSpellToList(list, parentlist->entries[i].priority,
+						parentlist->entries[i].spellid, parentlist->entries[i].type,
+						parentlist->entries[i].manacost, parentlist->entries[i].recast_delay,
+						parentlist->entries[i].resist_adjust);
+				}
+			}
+		}
+	}
+
+	for (i=0; i<spell_list->numentries; i++) {
+		if (level >= spell_list->entries[i].minlevel && level <= spell_list->entries[i].maxlevel && spell_list->entries[i].spellid > 0) {
+			AddSpellToList(list, spell_list->entries[i].priority,
+				spell_list->entries[i].spellid, spell_list->entries[i].type,
+				spell_list->entries[i].manacost, spell_list->entries[i].recast_delay,
+				spell_list->entries[i].resist_adjust);
+		}
+	}
+	std::sort(list->spells.begin(), list->spells.end(), [](const AISpells_Struct& a, const AISpells_Struct& b) {
+		return a.priority > b.priority;
+	});
+	IndexSpellsList(list);
+
+	npc_spells_lists[key] = list;
+	return list;
+}
+
 DBnpcspells_Struct* ZoneDatabase::GetNPCSpells(uint32 iDBSpellsID) {
 	if (iDBSpellsID == 0)
 		return nullptr;
@@ -43,6 +43,7 @@
 #include "../common/eqemu_exception.h"
 #include "../common/spdat.h"
 #include "../common/eqemu_logsys.h"
+#include "../common/event_signal.h"
 
 
 #include "zone_config.h"
@@ -59,6 +60,8 @@
 #include "embparser.h"
 #include "lua_parser.h"
 #include "questmgr.h"
+#include "opcode_metrics.h"
+#include "zone_profiler.h"
 //#include "remote_call_subscribe.h"
 //#include "remote_call_subscribe.h"
 
@@ -70,6 +73,7 @@
 #include <signal.h>
 #include <time.h>
 #include <ctime>
+#include <algorithm>
 
 #ifdef _CRTDBG_MAP_ALLOC
 	#undef new
@@ -95,6 +99,7 @@ uint32 numclients = 0;
 char errorname[32];
 extern Zone* zone;
 EQStreamFactory eqsf(ZoneStream);
+EventSignal loop_signal;	//wakes the main loop when a client connects or a world packet arrives
 npcDecayTimes_Struct npcCorpseDecayTimes[100];
 TitleManager title_manager;
 QueryServ *QServ = 0;
@@ -107,6 +112,7 @@ int32 SPDAT_RECORDS = -1;
 void Shutdown();
 extern void MapOpcodes();
 
+#ifndef ZONE_BENCH
 int main(int argc, char** argv) {
 	RegisterExecutablePlatform(ExePlatformZone); 
 	Log.LoadLogSettingsDefaults();
@@ -191,6 +197,8 @@ int main(int argc, char** argv) {
 	}
 
 	worldserver.SetPassword(Config->SharedKey.c_str());
+	worldserver.SetWakeSignal(&loop_signal);
+	eqsf.SetWakeSignal(&loop_signal);
 
 	Log.Out(Logs::General, Logs::Zone_Server, "Connecting to MySQL...");
 	if (!database.Connect(
@@ -262,6 +270,11 @@ int main(int argc, char** argv) {
 		Log.Out(Logs::General, Logs::Error, "Loading npcs faction lists FAILED!");
 		return 1;
 	}
+	Log.Out(Logs::General, Logs::Zone_Server, "Loading npc types");
+	if(!database.LoadNPCTypes(hotfix_name)) {
+		Log.Out(Logs::General, Logs::Error, "Loading npc types FAILED!");
+		Log.Out(Logs::General, Logs::Error, "Failed. But ignoring error and going on, npc types will come from the database...");
+	}
 	Log.Out(Logs::General, Logs::Zone_Server, "Loading loot tables");
 	if(!database.LoadLoot(hotfix_name)) {
 		Log.Out(Logs::General, Logs::Error, "Loading loot FAILED!");
@@ -376,57 +389,74 @@ int main(int argc, char** argv) {
 	uint8 ZONEUPDATE = 10;
 	Timer zoneupdate_timer(ZONEUPDATE);
 	zoneupdate_timer.Start();
+	Timer profile_report_timer(RuleI(Zone, ProfileReportInterval));
+	if (RuleI(Zone, ProfileReportInterval) <= 0)
+		profile_report_timer.Disable();
+	Timer opcode_stats_timer(RuleI(Zone, OpcodeStatsLogInterval));
+	if (RuleI(Zone, OpcodeStatsLogInterval) <= 0)
+		opcode_stats_timer.Disable();
+	Timer metrics_report_timer(RuleI(Zone, MetricsReportInterval));
+	if (RuleI(Zone, MetricsReportInterval) <= 0)
+		metrics_report_timer.Disable();
 	while(RunLoops) {
+		bool zone_ticked = false;
 		{	//profiler block to omit the sleep from times
+		PROFILE_PHASE(Tick);
 
 		//Advance the timer to our current point in time
 		Timer::SetCurrentTime();
 
-		worldserver.Process();
+		{
+			PROFILE_PHASE(WorldServer);
+			worldserver.Process();
+		}
 
-		if (!eqsf.IsOpen() && Config->ZonePort!=0) {
-			Log.Out(Logs::General, Logs::Zone_Server, "Starting EQ Network server on port %d",Config->ZonePort);
-			if (!eqsf.Open(Config->ZonePort)) {
-				Log.Out(Logs::General, Logs::Error, "Failed to open port %d",Config->ZonePort);
-				ZoneConfig::SetZonePort(0);
-				worldserver.Disconnect();
-				worldwasconnected = false;
+		{
+			PROFILE_PHASE(Network);
+			if (!eqsf.IsOpen() && Config->ZonePort!=0) {
+				Log.Out(Logs::General, Logs::Zone_Server, "Starting EQ Network server on port %d",Config->ZonePort);
+				if (!eqsf.Open(Config->ZonePort)) {
+					Log.Out(Logs::General, Logs::Error, "Failed to open port %d",Config->ZonePort);
+					ZoneConfig::SetZonePort(0);
+					worldserver.Disconnect();
+					worldwasconnected = false;
+				}
 			}
-		}
 
-		//check the factory for any new incoming streams.
-		while ((eqss = eqsf.Pop())) {
-			//pull the stream out of the factory and give it to the stream identifier
-			//which will figure out what patch they are running, and set up the dynamic
-			//structures and opcodes for that patch.
-			struct in_addr	in;
-			in.s_addr = eqss->GetRemoteIP();
-			Log.Out(Logs::Detail, Logs::World_Server, "New connection from %s:%d", inet_ntoa(in),ntohs(eqss->GetRemotePort()));
-			stream_identifier.AddStream(eqss);	//takes the stream
-		}
+			//check the factory for any new incoming streams.
+			while ((eqss = eqsf.Pop())) {
+				//pull the stream out of the factory and give it to the stream identifier
+				//which will figure out what patch they are running, and set up the dynamic
+				//structures and opcodes for that patch.
+				struct in_addr	in;
+				in.s_addr = eqss->GetRemoteIP();
+				Log.Out(Logs::Detail, Logs::World_Server, "New connection from %s:%d", inet_ntoa(in),ntohs(eqss->GetRemotePort()));
+				stream_identifier.AddStream(eqss);	//takes the stream
+			}
 
-		//check the factory for any new incoming streams.
-		while ((eqoss = eqsf.PopOld())) {
-			//pull the stream out of the factory and give it to the stream identifier
-			//which will figure out what patch they are running, and set up the dynamic
-			//structures and opcodes for that patch.
-			struct in_addr	in;
-			in.s_addr = eqoss->GetRemoteIP();
-			Log.Out(Logs::Detail, Logs::World_Server, "New connection from %s:%d", inet_ntoa(in), ntohs(eqoss->GetRemotePort()));
-			stream_identifier.AddOldStream(eqoss);	//takes the stream
-		}
+			//check the factory for any new incoming streams.
+			while ((eqoss = eqsf.PopOld())) {
+				//pull the stream out of the factory and give it to the stream identifier
+				//which will figure out what patch they are running, and set up the dynamic
+				//structures and opcodes for that patch.
+				struct in_addr	in;
+				in.s_addr = eqoss->GetRemoteIP();
+				Log.Out(Logs::Detail, Logs::World_Server, "New connection from %s:%d", inet_ntoa(in), ntohs(eqoss->GetRemotePort()));
+				stream_identifier.AddOldStream(eqoss);	//takes the stream
+			}
 
-		//give the stream identifier a chance to do its work....
-		stream_identifier.Process();
-
-		//check the stream identifier for any now-identified streams
-		while((eqsi = stream_identifier.PopIdentified())) {
-			//now that we know what patch they are running, start up their client object
-			struct in_addr	in;
-			in.s_addr = eqsi->GetRemoteIP();
-			Log.Out(Logs::Detail, Logs::World_Server, "New client from %s:%d", inet_ntoa(in), ntohs(eqsi->GetRemotePort()));
-			Client* client = new Client(eqsi);
-			entity_list.AddClient(client);
+			//give the stream identifier a chance to do its work....
+			stream_identifier.Process();
+
+			//check the stream identifier for any now-identified streams
+			while((eqsi = stream_identifier.PopIdentified())) {
+				//now that we know what patch they are running, start up their client object
+				struct in_addr	in;
+				in.s_addr = eqsi->GetRemoteIP();
+				Log.Out(Logs::Detail, Logs::World_Server, "New client from %s:%d", inet_ntoa(in), ntohs(eqsi->GetRemotePort()));
+				Client* client = new Client(eqsi);
+				entity_list.AddClient(client);
+			}
 		}
 
 		if ( numclients < 1 && zoneupdate_timer.GetDuration() != IDLEZONEUPDATE )
@@ -469,12 +499,16 @@ int main(int argc, char** argv) {
 				if(net.raid_timer.Enabled() && net.raid_timer.Check())
 					entity_list.RaidProcess();
 
-				entity_list.Process(); 
+				{
+					PROFILE_PHASE(EntityProcess);
+					entity_list.Process();
+				}
 				entity_list.MobProcess(); 
 				entity_list.BeaconProcess();
 				entity_list.EncounterProcess();
 
 				if (zone) {
+					PROFILE_PHASE(ZoneProcess);
 					if(!zone->Process()) {
 						Zone::Shutdown();
 					}
@@ -483,6 +517,8 @@ int main(int argc, char** argv) {
 				if(quest_timers.Check())
 					quest_manager.Process();
 
+				zone_ticked = true;
+
 			/*	if(RemoteCallProcessTimer.Check()) {
 					RemoteCallSubscriptionHandler::Instance()->Process();
 				}*/
@@ -505,7 +541,39 @@ int main(int argc, char** argv) {
 #endif
 #endif
 		}	//end extra profiler block 
-		Sleep(ZoneTimerResolution);
+		if (zone_ticked) {
+			ZoneProfiler::EndTick();
+			ZoneProfiler::CheckOverrun(zoneupdate_timer.GetDuration());
+		}
+		if (profile_report_timer.Check())
+			ZoneProfiler::SendToWorld();
+		if (opcode_stats_timer.Check())
+			OpcodeMetrics::LogStats(10);
+		if (metrics_report_timer.Check())
+			ZoneProfiler::SendMetrics();
+		parse->CollectGarbage();
+
+		int max_wait = RuleI(Zone, MaxLoopWaitMS);
+		if (max_wait <= 0) {
+			Sleep(ZoneTimerResolution);
+			continue;
+		}
+
+		//wait for the first timer checked on every pass to come due, or for a new client stream or a world packet.
+		//client packets aren't a wake, they are only handled by entity_list.Process() on the zone update anyway
+		//everything else hangs off the zone update, quest_timers and the entity timers included
+		Timer::SetCurrentTime();
+		uint32 wait = max_wait;
+		if (ZoneLoaded)
+			wait = std::min(wait, zoneupdate_timer.GetRemainingTime());
+		wait = std::min(wait, InterserverTimer.GetRemainingTime());
+		wait = std::min(wait, profile_report_timer.GetRemainingTime());
+		wait = std::min(wait, opcode_stats_timer.GetRemainingTime());
+		wait = std::min(wait, metrics_report_timer.GetRemainingTime());
+
+		ZoneProfiler::loop_stats.waits++;
+		if (loop_signal.Wait(wait))
+			ZoneProfiler::loop_stats.wakes++;
 	}
 
 	entity_list.Clear();
@@ -533,6 +601,7 @@ int main(int argc, char** argv) {
 	Log.CloseFileLogs();
 	return 0;
 }
+#endif
 
 void CatchSignal(int sig_num) {
 #ifdef _WINDOWS
@@ -132,6 +132,11 @@ NPC::NPC(const NPCType* d, Spawn2* in_respawn, const glm::vec4& position, int if
 
 	NPCTypedata = d;
 	NPCTypedata_ours = nullptr;
+	//the shared segment is unmapped on #hotfix, so keep our own copy of a shared type
+	if (database.IsSharedNPCType(d)) {
+		NPCTypedata_ours = new NPCType(*d);
+		NPCTypedata = NPCTypedata_ours;
+	}
 	respawn2 = in_respawn;
 	swarm_timer.Disable();
 
@@ -233,6 +238,8 @@ NPC::NPC(const NPCType* d, Spawn2* in_respawn, const glm::vec4& position, int if
 	SetPreCharmNPCFactionID(d->npc_faction_id);
 
 	npc_spells_id = 0;
+	AIspells = nullptr;
+	AIspells_ours = nullptr;
 	HasAISpell = false;
 	HasAISpellEffects = false;
 	innateProcSpellId = 0;
@@ -318,6 +325,7 @@ NPC::~NPC()
 	}
 
 	safe_delete(NPCTypedata_ours);
+	safe_delete(AIspells_ours);
 
 	{
 	ItemList::iterator cur,end;
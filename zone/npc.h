@@ -53,16 +53,6 @@ typedef struct {
 	bool say;
 } NPCProximity;
 
-struct AISpells_Struct {
-	uint16	type;			// 0 = never, must be one (and only one) of the defined values
-	uint16	spellid;		// <= 0 = no spell
-	int16	manacost;		// -1 = use spdat, -2 = no cast time
-	uint32	time_cancast;	// when we can cast this spell next
-	int32	recast_delay;
-	int16	priority;
-	int16	resist_adjust;
-};
-
 struct AISpellsEffects_Struct {
 	uint16	spelleffectid;
 	int32	base;
@@ -124,6 +114,7 @@ public:
 	bool			AI_AddNPCSpellsEffects(uint32 iDBSpellsEffectsID);
 	virtual bool	AI_EngagedCastCheck();
 	bool			AI_HasSpells() { return HasAISpell; }
+	bool			AI_HasSpellTypes(uint16 types) const { return AIspells && (AIspells->types & types); }
 	bool			AI_HasSpellsEffects() { return HasAISpellEffects; }
 	void			ApplyAISpellEffects(StatBonuses* newbon);
 
@@ -442,8 +433,12 @@ protected:
 	uint8	casting_spell_AIindex;
 	std::unique_ptr<Timer> AIautocastspell_timer;
 	uint32*	pDontCastBefore_casting_spell;
-	std::vector<AISpells_Struct> AIspells;
+	const AISpellsList_Struct* AIspells;	// shared list, see ZoneDatabase::GetNPCSpellsList()
+	AISpellsList_Struct* AIspells_ours;		// private copy once a quest adds or removes a spell
+	std::vector<uint32> AIspells_cancast;	// when we can cast each AIspells->spells entry next
 	bool HasAISpell;
+	inline uint32 AISpellCount() const { return AIspells ? AIspells->spells.size() : 0; }
+	AISpellsList_Struct* AISpellsForWrite();
 	virtual bool AICastSpell(Mob* tar, uint8 iChance, uint16 iSpellTypes, bool zeroPriorityOnly = false);
 	virtual bool AIDoSpellCast(uint8 i, Mob* tar, int32 mana_cost, uint32* oDontDoAgainBefore = 0);
 	AISpellsVar_Struct AISpellVar;
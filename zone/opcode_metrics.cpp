@@ -0,0 +1,107 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "../common/global_define.h"
+#include "../common/eqemu_logsys.h"
+#include "../common/string_util.h"
+
+#include "client.h"
+#include "opcode_metrics.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace OpcodeMetrics {
+
+	Counter inbound[_maxEmuOpcode];
+	Counter outbound[_maxEmuOpcode];
+	Totals totals;
+
+	struct SortByTicks {
+		bool operator()(int a, int b) const { return inbound[a].ticks > inbound[b].ticks; }
+	};
+
+	struct SortByBytes {
+		bool operator()(int a, int b) const { return outbound[a].bytes > outbound[b].bytes; }
+	};
+
+	//opcodes seen, most expensive first: handler time inbound, bytes outbound
+	static void GetSorted(bool show_outbound, std::vector<int> &out) {
+		const Counter *list = show_outbound ? outbound : inbound;
+		for (int i = 0; i < _maxEmuOpcode; ++i) {
+			if (list[i].count)
+				out.push_back(i);
+		}
+		if (show_outbound)
+			std::sort(out.begin(), out.end(), SortByBytes());
+		else
+			std::sort(out.begin(), out.end(), SortByTicks());
+	}
+
+	static double TicksToMS(uint64 ticks) {
+		return static_cast<double>(ticks) / static_cast<double>(RDTSC_Timer::ticksPerMS());
+	}
+
+	static std::string FormatLine(bool show_outbound, int op) {
+		if (show_outbound) {
+			const Counter &c = outbound[op];
+			return StringFormat("%-28s count: %llu bytes: %llu", OpcodeNames[op],
+				(unsigned long long)c.count, (unsigned long long)c.bytes);
+		}
+
+		const Counter &c = inbound[op];
+		return StringFormat("%-28s count: %llu bytes: %llu total: %.2fms avg: %.3fms max: %.3fms", OpcodeNames[op],
+			(unsigned long long)c.count, (unsigned long long)c.bytes, TicksToMS(c.ticks),
+			TicksToMS(c.ticks) / c.count, TicksToMS(c.max_ticks));
+	}
+
+	void SendStats(Client *to, bool show_outbound, uint32 count) {
+		std::vector<int> sorted;
+		GetSorted(show_outbound, sorted);
+		if (count == 0 || count > sorted.size())
+			count = sorted.size();
+
+		to->Message(CC_Yellow, "%s opcodes, top %u of %u by %s:", show_outbound ? "Outbound" : "Inbound",
+			count, (uint32)sorted.size(), show_outbound ? "bytes" : "handler time");
+		for (uint32 i = 0; i < count; ++i)
+			to->Message(CC_Default, "%s", FormatLine(show_outbound, sorted[i]).c_str());
+	}
+
+	void LogStats(uint32 count) {
+		for (int pass = 0; pass < 2; ++pass) {
+			bool show_outbound = pass == 1;
+			std::vector<int> sorted;
+			GetSorted(show_outbound, sorted);
+			if (sorted.empty())
+				continue;
+			uint32 shown = count;
+			if (shown == 0 || shown > sorted.size())
+				shown = sorted.size();
+
+			Log.Out(Logs::General, Logs::Zone_Server, "Opcode stats, %s top %u of %u:", show_outbound ? "outbound" : "inbound",
+				shown, (uint32)sorted.size());
+			for (uint32 i = 0; i < shown; ++i)
+				Log.Out(Logs::General, Logs::Zone_Server, "  %s", FormatLine(show_outbound, sorted[i]).c_str());
+		}
+	}
+
+	void Reset() {
+		memset(inbound, 0, sizeof(inbound));
+		memset(outbound, 0, sizeof(outbound));
+	}
+}
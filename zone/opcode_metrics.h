@@ -0,0 +1,94 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef OPCODE_METRICS_H
+#define OPCODE_METRICS_H
+
+/*
+	Per opcode volume and handler time for client traffic in this zone.
+
+	Inbound packets are counted in Client::HandlePacket with the time spent
+	in the handler, outbound packets are counted when they are handed to the
+	stream by Client::QueuePacket/FastQueuePacket. Counters are flat arrays
+	indexed by EmuOpcode, so the cost per packet is a few adds.
+*/
+
+#include "../common/emu_opcodes.h"
+#include "../common/rdtsc.h"
+#include "../common/types.h"
+
+class Client;
+
+namespace OpcodeMetrics {
+
+	struct Counter {
+		uint64 count;
+		uint64 bytes;
+		uint64 ticks;		//rdtsc ticks spent in the handler, inbound only
+		uint64 max_ticks;
+	};
+
+	//running totals since startup for the metrics report, not cleared by Reset()
+	struct Totals {
+		uint64 packets_in;
+		uint64 bytes_in;
+		uint64 packets_out;
+		uint64 bytes_out;
+	};
+
+	extern Counter inbound[_maxEmuOpcode];
+	extern Counter outbound[_maxEmuOpcode];
+	extern Totals totals;
+
+	inline void AddOutbound(EmuOpcode op, uint32 size) {
+		totals.packets_out++;
+		totals.bytes_out += size;
+		if (op >= _maxEmuOpcode)
+			return;
+		outbound[op].count++;
+		outbound[op].bytes += size;
+	}
+
+	void SendStats(Client *to, bool show_outbound, uint32 count);
+	void LogStats(uint32 count);
+	void Reset();
+
+	class ScopedInbound {
+	public:
+		inline ScopedInbound(EmuOpcode op, uint32 size) : m_op(op), m_size(size), m_timer(true) { }
+		inline ~ScopedInbound() {
+			totals.packets_in++;
+			totals.bytes_in += m_size;
+			if (m_op >= _maxEmuOpcode)
+				return;
+			m_timer.stop();
+			uint64 ticks = m_timer.getTicks();
+			Counter &c = inbound[m_op];
+			c.count++;
+			c.bytes += m_size;
+			c.ticks += ticks;
+			if (ticks > c.max_ticks)
+				c.max_ticks = ticks;
+		}
+	private:
+		EmuOpcode m_op;
+		uint32 m_size;
+		RDTSC_Timer m_timer;
+	};
+}
+
+#endif
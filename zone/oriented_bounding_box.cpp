@@ -1,6 +1,7 @@
 #include "oriented_bounding_box.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/transform.hpp>
+#include <algorithm>
 
 glm::mat4 CreateRotateMatrix(float rx, float ry, float rz) {
 	glm::mat4 rot_x(1.0f);
@@ -93,3 +94,22 @@ bool OrientedBoundingBox::ContainsPoint(glm::vec3 p) const {
 	
 	return false;
 }
+
+//axis aligned bounds of the box, in the same space ContainsPoint takes
+void OrientedBoundingBox::GetBounds(glm::vec3 &min, glm::vec3 &max) const {
+	for (int i = 0; i < 8; ++i) {
+		glm::vec4 corner((i & 1) ? max_x : min_x, (i & 2) ? max_y : min_y, (i & 4) ? max_z : min_z, 1);
+		glm::vec4 p = transformation * corner;
+		if (i == 0) {
+			min = glm::vec3(p.x, p.y, p.z);
+			max = min;
+			continue;
+		}
+		min.x = std::min(min.x, p.x);
+		min.y = std::min(min.y, p.y);
+		min.z = std::min(min.z, p.z);
+		max.x = std::max(max.x, p.x);
+		max.y = std::max(max.y, p.y);
+		max.z = std::max(max.z, p.z);
+	}
+}
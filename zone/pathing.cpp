@@ -5,6 +5,7 @@
 #include "pathing.h"
 #include "water_map.h"
 #include "zone.h"
+#include "zone_profiler.h"
 
 #include <fstream>
 #include <list>
@@ -737,6 +738,8 @@ void PathManager::SimpleMeshTest(Client* c, int origin)
 
 glm::vec3 Mob::UpdatePath(float ToX, float ToY, float ToZ, float Speed, bool &WaypointChanged, bool &NodeReached)
 {
+	PROFILE_PHASE(Pathing);
+
 	WaypointChanged = false;
 
 	NodeReached = false;
@@ -52,6 +52,9 @@ public:
 	virtual bool ItemHasQuestSub(ItemInst *itm, QuestEventID evt) { return false; }
 	virtual bool EncounterHasQuestSub(std::string encounter_name, QuestEventID evt) { return false; }
 
+	//true while any encounter has registered events, so Dispatch* has something to do
+	virtual bool HasEncounterEvents() { return false; }
+
 	virtual void LoadNPCScript(std::string filename, int npc_id) { }
 	virtual void LoadGlobalNPCScript(std::string filename) { }
 	virtual void LoadPlayerScript(std::string filename) { }
@@ -73,6 +76,7 @@ public:
 	virtual std::string GetVar(std::string name) { return std::string(); }
 	virtual void Init() { }
 	virtual void ReloadQuests() { }
+	virtual void CollectGarbage() { }
 	virtual uint32 GetIdentifier() = 0;
 	
 	//TODO: Set maximum quest errors instead of hard coding it
@@ -24,9 +24,20 @@
 #include "quest_interface.h"
 #include "zone.h"
 #include "questmgr.h"
+#include "zone_profiler.h"
 
 #include <stdio.h>
 
+#ifdef _WINDOWS
+	#include <io.h>
+#else
+	#include <dirent.h>
+	#include <unistd.h>
+#endif
+#ifdef __linux__
+	#include <sys/inotify.h>
+#endif
+
 extern Zone* zone;
 extern void MapOpcodes();
 
@@ -34,9 +45,11 @@ QuestParserCollection::QuestParserCollection() {
 	_player_quest_status = QuestUnloaded;
 	_global_player_quest_status = QuestUnloaded;
 	_global_npc_quest_status = QuestUnloaded;
+	_quest_watch_fd = -1;
 }
 
 QuestParserCollection::~QuestParserCollection() {
+	CloseQuestFileWatch();
 }
 
 void QuestParserCollection::RegisterQuestInterface(QuestInterface *qi, std::string ext) {
@@ -60,6 +73,7 @@ void QuestParserCollection::AddVar(std::string name, std::string val) {
 }
 
 void QuestParserCollection::Init() {
+	_quest_files_zone.clear();
 	std::list<QuestInterface*>::iterator iter = _load_precedence.begin();
 	while(iter != _load_precedence.end()) {
 		(*iter)->Init();
@@ -67,6 +81,15 @@ void QuestParserCollection::Init() {
 	}
 }
 
+//idle time at the end of the zone loop
+void QuestParserCollection::CollectGarbage() {
+	std::list<QuestInterface*>::iterator iter = _load_precedence.begin();
+	while(iter != _load_precedence.end()) {
+		(*iter)->CollectGarbage();
+		++iter;
+	}
+}
+
 void QuestParserCollection::ReloadQuests(bool reset_timers) {
 	if(reset_timers) {
 		quest_manager.ClearAllTimers();
@@ -80,6 +103,12 @@ void QuestParserCollection::ReloadQuests(bool reset_timers) {
 	_spell_quest_status.clear();
 	_item_quest_status.clear();
 	_encounter_quest_status.clear();
+	_npc_quest_events.clear();
+	_global_npc_quest_events.reset();
+	_player_quest_events.reset();
+	_global_player_quest_events.reset();
+	//rescanned on the next lookup
+	_quest_files_zone.clear();
 	std::list<QuestInterface*>::iterator iter = _load_precedence.begin();
 	while(iter != _load_precedence.end()) {
 		(*iter)->ReloadQuests();
@@ -87,94 +116,134 @@ void QuestParserCollection::ReloadQuests(bool reset_timers) {
 	}
 }
 
-bool QuestParserCollection::HasQuestSub(uint32 npcid, QuestEventID evt) {
-	return HasQuestSubLocal(npcid, evt) || HasQuestSubGlobal(evt);
+//ask the interface which subs the script it just loaded has, once per event id
+void QuestParserCollection::GetQuestEvents(QuestInterface *qi, QuestEventMask &events, uint32 npcid, int type) {
+	events.reset();
+	for(int i = 0; i < _LargestEventID; ++i) {
+		QuestEventID evt = static_cast<QuestEventID>(i);
+		bool has_sub = false;
+		switch(type) {
+		case 0: has_sub = qi->HasQuestSub(npcid, evt); break;
+		case 1: has_sub = qi->HasGlobalQuestSub(evt); break;
+		case 2: has_sub = qi->PlayerHasQuestSub(evt); break;
+		case 3: has_sub = qi->GlobalPlayerHasQuestSub(evt); break;
+		}
+		if(has_sub)
+			events.set(i);
+	}
 }
 
-bool QuestParserCollection::HasQuestSubLocal(uint32 npcid, QuestEventID evt) {
-	std::map<uint32, uint32>::iterator iter = _npc_quest_status.find(npcid);
-	
-	if(iter != _npc_quest_status.end()) {
-		//loaded or failed to load
-		if(iter->second != QuestFailedToLoad) {
-			std::map<uint32, QuestInterface*>::iterator qiter = _interfaces.find(iter->second);
-			if(qiter->second->HasQuestSub(npcid, evt)) {
-				return true;
-			}
-		}
+const QuestEventMask &QuestParserCollection::GetNPCQuestEvents(uint32 npcid) {
+	auto iter = _npc_quest_events.find(npcid);
+	if(iter != _npc_quest_events.end())
+		return iter->second;
+
+	QuestEventMask &events = _npc_quest_events[npcid];
+	std::string filename;
+	QuestInterface *qi = GetQIByNPCQuest(npcid, filename);
+	if(qi) {
+		_npc_quest_status[npcid] = qi->GetIdentifier();
+		qi->LoadNPCScript(filename, npcid);
+		GetQuestEvents(qi, events, npcid, 0);
 	} else {
-		std::string filename;
-		QuestInterface *qi = GetQIByNPCQuest(npcid, filename);
-		if(qi) {
-			_npc_quest_status[npcid] = qi->GetIdentifier();
+		_npc_quest_status[npcid] = QuestFailedToLoad;
+	}
+	return events;
+}
 
-			qi->LoadNPCScript(filename, npcid);
-			if(qi->HasQuestSub(npcid, evt)) {
-				return true;
-			}
-		} else {
-			_npc_quest_status[npcid] = QuestFailedToLoad;
-		}
+void QuestParserCollection::LoadGlobalNPCQuest() {
+	if(_global_npc_quest_status != QuestUnloaded)
+		return;
+
+	std::string filename;
+	QuestInterface *qi = GetQIByGlobalNPCQuest(filename);
+	if(qi) {
+		_global_npc_quest_status = qi->GetIdentifier();
+		qi->LoadGlobalNPCScript(filename);
+		GetQuestEvents(qi, _global_npc_quest_events, 0, 1);
+	} else {
+		_global_npc_quest_status = QuestFailedToLoad;
 	}
-	return false;
 }
 
-bool QuestParserCollection::HasQuestSubGlobal(QuestEventID evt) {
-	if(_global_npc_quest_status == QuestUnloaded) {
-		std::string filename;
-		QuestInterface *qi = GetQIByGlobalNPCQuest(filename);
-		if(qi) {
-			qi->LoadGlobalNPCScript(filename);
-			_global_npc_quest_status = qi->GetIdentifier();
-			if(qi->HasGlobalQuestSub(evt)) {
-				return true;
-			}
-		}
+void QuestParserCollection::LoadPlayerQuest() {
+	if(_player_quest_status != QuestUnloaded)
+		return;
+
+	std::string filename;
+	QuestInterface *qi = GetQIByPlayerQuest(filename);
+	if(qi) {
+		_player_quest_status = qi->GetIdentifier();
+		qi->LoadPlayerScript(filename);
+		GetQuestEvents(qi, _player_quest_events, 0, 2);
+	} else if(zone && zone->IsLoaded()) {
+		//the zone's player script can't be looked up until the zone is loaded, try again then
+		_player_quest_status = QuestFailedToLoad;
+	}
+}
+
+void QuestParserCollection::LoadGlobalPlayerQuest() {
+	if(_global_player_quest_status != QuestUnloaded)
+		return;
+
+	std::string filename;
+	QuestInterface *qi = GetQIByGlobalPlayerQuest(filename);
+	if(qi) {
+		_global_player_quest_status = qi->GetIdentifier();
+		qi->LoadGlobalPlayerScript(filename);
+		GetQuestEvents(qi, _global_player_quest_events, 0, 3);
 	} else {
-		if(_global_npc_quest_status != QuestFailedToLoad) {
-			std::map<uint32, QuestInterface*>::iterator qiter = _interfaces.find(_global_npc_quest_status);
-			if(qiter->second->HasGlobalQuestSub(evt)) {
-				return true;
-			}
-		}
+		_global_player_quest_status = QuestFailedToLoad;
+	}
+}
+
+bool QuestParserCollection::HasEncounterEvents() {
+	auto iter = _load_precedence.begin();
+	while(iter != _load_precedence.end()) {
+		if((*iter)->HasEncounterEvents())
+			return true;
+		++iter;
 	}
 	return false;
 }
 
+bool QuestParserCollection::HasQuestSub(uint32 npcid, QuestEventID evt) {
+	return HasQuestSubLocal(npcid, evt) || HasQuestSubGlobal(evt);
+}
+
+bool QuestParserCollection::HasQuestSubLocal(uint32 npcid, QuestEventID evt) {
+	if(evt >= _LargestEventID)
+		return false;
+
+	return GetNPCQuestEvents(npcid).test(evt);
+}
+
+bool QuestParserCollection::HasQuestSubGlobal(QuestEventID evt) {
+	if(evt >= _LargestEventID)
+		return false;
+
+	LoadGlobalNPCQuest();
+	return _global_npc_quest_events.test(evt);
+}
+
 bool QuestParserCollection::PlayerHasQuestSub(QuestEventID evt) {
 	return PlayerHasQuestSubLocal(evt) || PlayerHasQuestSubGlobal(evt);
 }
 
 bool QuestParserCollection::PlayerHasQuestSubLocal(QuestEventID evt) {
-	if(_player_quest_status == QuestUnloaded) {
-		std::string filename;	
-		QuestInterface *qi = GetQIByPlayerQuest(filename);
-		if(qi) {
-			_player_quest_status = qi->GetIdentifier();
-			qi->LoadPlayerScript(filename);
-			return qi->PlayerHasQuestSub(evt);
-		}
-	} else if(_player_quest_status != QuestFailedToLoad) {
-		std::map<uint32, QuestInterface*>::iterator iter = _interfaces.find(_player_quest_status);
-		return iter->second->PlayerHasQuestSub(evt);
-	}
-	return false;
+	if(evt >= _LargestEventID)
+		return false;
+
+	LoadPlayerQuest();
+	return _player_quest_events.test(evt);
 }
 
 bool QuestParserCollection::PlayerHasQuestSubGlobal(QuestEventID evt) {
-	if(_global_player_quest_status == QuestUnloaded) {
-		std::string filename;	
-		QuestInterface *qi = GetQIByGlobalPlayerQuest(filename);
-		if(qi) {
-			_global_player_quest_status = qi->GetIdentifier();
-			qi->LoadGlobalPlayerScript(filename);
-			return qi->GlobalPlayerHasQuestSub(evt);
-		}
-	} else if(_global_player_quest_status != QuestFailedToLoad) {
-		std::map<uint32, QuestInterface*>::iterator iter = _interfaces.find(_global_player_quest_status);
-		return iter->second->GlobalPlayerHasQuestSub(evt);
-	}
-	return false;
+	if(evt >= _LargestEventID)
+		return false;
+
+	LoadGlobalPlayerQuest();
+	return _global_player_quest_events.test(evt);
 }
 
 bool QuestParserCollection::SpellHasQuestSub(uint32 spell_id, QuestEventID evt) {
@@ -232,11 +301,19 @@ bool QuestParserCollection::ItemHasQuestSub(ItemInst *itm, QuestEventID evt) {
 	return false;
 }
 
-int QuestParserCollection::EventNPC(QuestEventID evt, NPC *npc, Mob *init, std::string data, uint32 extra_data,
+int QuestParserCollection::EventNPC(QuestEventID evt, NPC *npc, Mob *init, const std::string &data, uint32 extra_data,
 									std::vector<EQEmu::Any> *extra_pointers) {
-	int rd = DispatchEventNPC(evt, npc, init, data, extra_data, extra_pointers);
-	int rl = EventNPCLocal(evt, npc, init, data, extra_data, extra_pointers);
-	int rg = EventNPCGlobal(evt, npc, init, data, extra_data, extra_pointers);
+	//most events have no sub in either script, find that out before doing anything else
+	bool local = npc && HasQuestSubLocal(npc->GetNPCTypeID(), evt);
+	bool global = HasQuestSubGlobal(evt);
+	bool dispatch = HasEncounterEvents();
+	if(!local && !global && !dispatch)
+		return 0;
+
+	PROFILE_PHASE(QuestEvents);
+	int rd = dispatch ? DispatchEventNPC(evt, npc, init, data, extra_data, extra_pointers) : 0;
+	int rl = local ? EventNPCLocal(evt, npc, init, data, extra_data, extra_pointers) : 0;
+	int rg = global ? EventNPCGlobal(evt, npc, init, data, extra_data, extra_pointers) : 0;
 	
 	//Local quests returning non-default values have priority over global quests
     if(rl != 0) {
@@ -250,56 +327,38 @@ int QuestParserCollection::EventNPC(QuestEventID evt, NPC *npc, Mob *init, std::
 	return 0;
 }
 
-int QuestParserCollection::EventNPCLocal(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
+//only called once HasQuestSubLocal has loaded the script and found the sub
+int QuestParserCollection::EventNPCLocal(QuestEventID evt, NPC* npc, Mob *init, const std::string &data, uint32 extra_data,
 										 std::vector<EQEmu::Any> *extra_pointers) {
-	if(!npc)
+	std::map<uint32, uint32>::iterator iter = _npc_quest_status.find(npc->GetNPCTypeID());
+	if(iter == _npc_quest_status.end() || iter->second == QuestFailedToLoad)
 		return 0;
 
-	std::map<uint32, uint32>::iterator iter = _npc_quest_status.find(npc->GetNPCTypeID());
-	if(iter != _npc_quest_status.end()) {
-		//loaded or failed to load
-		if(iter->second != QuestFailedToLoad) {
-			std::map<uint32, QuestInterface*>::iterator qiter = _interfaces.find(iter->second);
-			return qiter->second->EventNPC(evt, npc, init, data, extra_data, extra_pointers);
-		}
-	} else {
-		std::string filename;
-		QuestInterface *qi = GetQIByNPCQuest(npc->GetNPCTypeID(), filename);
-		if(qi) {
-			_npc_quest_status[npc->GetNPCTypeID()] = qi->GetIdentifier();
-			qi->LoadNPCScript(filename, npc->GetNPCTypeID());
-			return qi->EventNPC(evt, npc, init, data, extra_data, extra_pointers);
-		} else {
-			_npc_quest_status[npc->GetNPCTypeID()] = QuestFailedToLoad;
-		}
-	}
-	return 0;
+	std::map<uint32, QuestInterface*>::iterator qiter = _interfaces.find(iter->second);
+	return qiter->second->EventNPC(evt, npc, init, data, extra_data, extra_pointers);
 }
 
-int QuestParserCollection::EventNPCGlobal(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
+int QuestParserCollection::EventNPCGlobal(QuestEventID evt, NPC* npc, Mob *init, const std::string &data, uint32 extra_data,
 										  std::vector<EQEmu::Any> *extra_pointers) {
-	if(_global_npc_quest_status != QuestUnloaded && _global_npc_quest_status != QuestFailedToLoad) {
-		std::map<uint32, QuestInterface*>::iterator qiter = _interfaces.find(_global_npc_quest_status);
-		return qiter->second->EventGlobalNPC(evt, npc, init, data, extra_data, extra_pointers);
-	} else {
-		std::string filename;
-		QuestInterface *qi = GetQIByGlobalNPCQuest(filename);
-		if(qi) {
-			_global_npc_quest_status = qi->GetIdentifier();
-			qi->LoadGlobalNPCScript(filename);
-			return qi->EventGlobalNPC(evt, npc, init, data, extra_data, extra_pointers);
-		} else {
-			_global_npc_quest_status = QuestFailedToLoad;
-		}
-	}
-	return 0;
+	if(_global_npc_quest_status == QuestUnloaded || _global_npc_quest_status == QuestFailedToLoad)
+		return 0;
+
+	std::map<uint32, QuestInterface*>::iterator qiter = _interfaces.find(_global_npc_quest_status);
+	return qiter->second->EventGlobalNPC(evt, npc, init, data, extra_data, extra_pointers);
 }
 
-int QuestParserCollection::EventPlayer(QuestEventID evt, Client *client, std::string data, uint32 extra_data,
+int QuestParserCollection::EventPlayer(QuestEventID evt, Client *client, const std::string &data, uint32 extra_data,
 									   std::vector<EQEmu::Any> *extra_pointers) {
-	int rd = DispatchEventPlayer(evt, client, data, extra_data, extra_pointers);
-	int rl = EventPlayerLocal(evt, client, data, extra_data, extra_pointers);
-	int rg = EventPlayerGlobal(evt, client, data, extra_data, extra_pointers);
+	bool local = PlayerHasQuestSubLocal(evt);
+	bool global = PlayerHasQuestSubGlobal(evt);
+	bool dispatch = HasEncounterEvents();
+	if(!local && !global && !dispatch)
+		return 0;
+
+	PROFILE_PHASE(QuestEvents);
+	int rd = dispatch ? DispatchEventPlayer(evt, client, data, extra_data, extra_pointers) : 0;
+	int rl = local ? EventPlayerLocal(evt, client, data, extra_data, extra_pointers) : 0;
+	int rg = global ? EventPlayerGlobal(evt, client, data, extra_data, extra_pointers) : 0;
 	
 	//Local quests returning non-default values have priority over global quests
 	if(rl != 0) {
@@ -313,46 +372,27 @@ int QuestParserCollection::EventPlayer(QuestEventID evt, Client *client, std::st
 	return 0;
 }
 
-int QuestParserCollection::EventPlayerLocal(QuestEventID evt, Client *client, std::string data, uint32 extra_data,
+int QuestParserCollection::EventPlayerLocal(QuestEventID evt, Client *client, const std::string &data, uint32 extra_data,
 											std::vector<EQEmu::Any> *extra_pointers) {
-	if(_player_quest_status == QuestUnloaded) {
-		std::string filename;
-		QuestInterface *qi = GetQIByPlayerQuest(filename);
-		if(qi) {
-			_player_quest_status = qi->GetIdentifier();
-			qi->LoadPlayerScript(filename);
-			return qi->EventPlayer(evt, client, data, extra_data, extra_pointers);
-		}
-	} else { 
-		if(_player_quest_status != QuestFailedToLoad) {
-			std::map<uint32, QuestInterface*>::iterator iter = _interfaces.find(_player_quest_status);
-			return iter->second->EventPlayer(evt, client, data, extra_data, extra_pointers);
-		}
-	}
-	return 0;
+	if(_player_quest_status == QuestUnloaded || _player_quest_status == QuestFailedToLoad)
+		return 0;
+
+	std::map<uint32, QuestInterface*>::iterator iter = _interfaces.find(_player_quest_status);
+	return iter->second->EventPlayer(evt, client, data, extra_data, extra_pointers);
 }
 
-int QuestParserCollection::EventPlayerGlobal(QuestEventID evt, Client *client, std::string data, uint32 extra_data,
+int QuestParserCollection::EventPlayerGlobal(QuestEventID evt, Client *client, const std::string &data, uint32 extra_data,
 											 std::vector<EQEmu::Any> *extra_pointers) {
-	if(_global_player_quest_status == QuestUnloaded) {
-		std::string filename;
-		QuestInterface *qi = GetQIByGlobalPlayerQuest(filename);
-		if(qi) {
-			_global_player_quest_status = qi->GetIdentifier();
-			qi->LoadGlobalPlayerScript(filename);
-			return qi->EventGlobalPlayer(evt, client, data, extra_data, extra_pointers);
-		}
-	} else { 
-		if(_global_player_quest_status != QuestFailedToLoad) {
-			std::map<uint32, QuestInterface*>::iterator iter = _interfaces.find(_global_player_quest_status);
-			return iter->second->EventGlobalPlayer(evt, client, data, extra_data, extra_pointers);
-		}
-	}
-	return 0;
+	if(_global_player_quest_status == QuestUnloaded || _global_player_quest_status == QuestFailedToLoad)
+		return 0;
+
+	std::map<uint32, QuestInterface*>::iterator iter = _interfaces.find(_global_player_quest_status);
+	return iter->second->EventGlobalPlayer(evt, client, data, extra_data, extra_pointers);
 }
 
 int QuestParserCollection::EventItem(QuestEventID evt, Client *client, ItemInst *item, Mob *mob, std::string data, uint32 extra_data,
 									 std::vector<EQEmu::Any> *extra_pointers) {
+	PROFILE_PHASE(QuestEvents);
 	// needs pointer validation check on 'item' argument
 	
 	std::string item_script;
@@ -398,6 +438,7 @@ int QuestParserCollection::EventItem(QuestEventID evt, Client *client, ItemInst
 
 int QuestParserCollection::EventSpell(QuestEventID evt, NPC* npc, Client *client, uint32 spell_id, uint32 extra_data,
 									  std::vector<EQEmu::Any> *extra_pointers) {
+	PROFILE_PHASE(QuestEvents);
 	std::map<uint32, uint32>::iterator iter = _spell_quest_status.find(spell_id);
 	if(iter != _spell_quest_status.end()) {
 		//loaded or failed to load
@@ -433,6 +474,7 @@ int QuestParserCollection::EventSpell(QuestEventID evt, NPC* npc, Client *client
 
 int QuestParserCollection::EventEncounter(QuestEventID evt, std::string encounter_name, std::string data, uint32 extra_data,
 										  std::vector<EQEmu::Any> *extra_pointers) {
+	PROFILE_PHASE(QuestEvents);
 	auto iter = _encounter_quest_status.find(encounter_name);
 	if(iter != _encounter_quest_status.end()) {
 		//loaded or failed to load
@@ -454,24 +496,125 @@ int QuestParserCollection::EventEncounter(QuestEventID evt, std::string encounte
 	return 0;
 }
 
-QuestInterface *QuestParserCollection::GetQIByNPCQuest(uint32 npcid, std::string &filename) {
-	//first look for /quests/zone/npcid.ext (precedence)
-	filename = "quests/";
-	filename += zone->GetShortName();
-	filename += "/";
-	filename += itoa(npcid);
-	std::string tmp;
-	FILE *f = nullptr;
+//scan the directories quest scripts are looked up in, each file is indexed by its full quest path
+void QuestParserCollection::BuildQuestFileIndex() {
+	CloseQuestFileWatch();
+	_quest_files.clear();
+	_quest_files_zone = zone->GetShortName();
+
+	std::string zone_dir = "quests/";
+	zone_dir += _quest_files_zone;
+	std::string global_dir = "quests/";
+	global_dir += QUEST_GLOBAL_DIRECTORY;
+
+	const char *subdirs[] = { "", "/spells", "/items", "/encounters" };
+	for(int i = 0; i < 4; ++i) {
+		IndexQuestDirectory(zone_dir + subdirs[i]);
+		IndexQuestDirectory(global_dir + subdirs[i]);
+	}
+
+	Log.Out(Logs::General, Logs::Quests, "Indexed %u quest files for %s.", (uint32)_quest_files.size(), _quest_files_zone.c_str());
+}
+
+void QuestParserCollection::IndexQuestDirectory(const std::string &dir) {
+#ifdef _WINDOWS
+	std::string pattern = dir + "/*";
+	struct _finddata_t entry;
+	intptr_t handle = _findfirst(pattern.c_str(), &entry);
+	if(handle == -1)
+		return;
+
+	do {
+		_quest_files.insert(dir + "/" + entry.name);
+	} while(_findnext(handle, &entry) == 0);
+	_findclose(handle);
+#else
+	DIR *d = opendir(dir.c_str());
+	if(!d)
+		return;
+
+	struct dirent *entry;
+	while((entry = readdir(d)) != nullptr) {
+		_quest_files.insert(dir + "/" + entry->d_name);
+	}
+	closedir(d);
+
+#ifdef __linux__
+	if(_quest_watch_fd == -1)
+		_quest_watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(_quest_watch_fd != -1) {
+		int wd = inotify_add_watch(_quest_watch_fd, dir.c_str(), IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO);
+		if(wd != -1)
+			_quest_watch_dirs[wd] = dir;
+	}
+#endif
+#endif
+}
+
+void QuestParserCollection::CloseQuestFileWatch() {
+#ifdef __linux__
+	if(_quest_watch_fd != -1)
+		close(_quest_watch_fd);
+	_quest_watch_fd = -1;
+	_quest_watch_dirs.clear();
+#endif
+}
+
+//apply whatever the watcher saw since the last lookup, or rebuild the index for a new zone
+void QuestParserCollection::UpdateQuestFileIndex() {
+	if(!zone)
+		return;
+
+	if(_quest_files_zone.compare(zone->GetShortName()) != 0) {
+		BuildQuestFileIndex();
+		return;
+	}
+
+#ifdef __linux__
+	if(_quest_watch_fd == -1)
+		return;
+
+	char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+	bool rebuild = false;
+	ssize_t len;
+	while((len = read(_quest_watch_fd, buffer, sizeof(buffer))) > 0) {
+		for(char *ptr = buffer; ptr < buffer + len; ptr += sizeof(struct inotify_event) + ((struct inotify_event*)ptr)->len) {
+			const struct inotify_event *event = (const struct inotify_event*)ptr;
+			if(event->mask & IN_Q_OVERFLOW) {
+				rebuild = true;
+				continue;
+			}
+
+			auto dir = _quest_watch_dirs.find(event->wd);
+			if(dir == _quest_watch_dirs.end() || event->len == 0)
+				continue;
+
+			std::string path = dir->second + "/" + event->name;
+			if(event->mask & (IN_CREATE | IN_MOVED_TO)) {
+				_quest_files.insert(path);
+				//a spells, items or encounters directory that did not exist yet is not watched
+				if(event->mask & IN_ISDIR)
+					rebuild = true;
+			} else {
+				_quest_files.erase(path);
+			}
+		}
+	}
 
+	if(rebuild)
+		BuildQuestFileIndex();
+#endif
+}
+
+//first registered interface with a script at base.ext, in load precedence
+QuestInterface *QuestParserCollection::GetQIByFile(const std::string &base, std::string &filename) {
 	std::list<QuestInterface*>::iterator iter = _load_precedence.begin();
 	while(iter != _load_precedence.end()) {
-		tmp = filename;
 		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
+		std::string tmp = base;
 		tmp += ".";
 		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
+		if(_quest_files.count(tmp)) {
 			filename = tmp;
 			return (*iter);
 		}
@@ -479,6 +622,24 @@ QuestInterface *QuestParserCollection::GetQIByNPCQuest(uint32 npcid, std::string
 		++iter;
 	}
 
+	return nullptr;
+}
+
+QuestInterface *QuestParserCollection::GetQIByNPCQuest(uint32 npcid, std::string &filename) {
+	UpdateQuestFileIndex();
+
+	std::string zone_dir = "quests/";
+	zone_dir += zone->GetShortName();
+	zone_dir += "/";
+	std::string global_dir = "quests/";
+	global_dir += QUEST_GLOBAL_DIRECTORY;
+	global_dir += "/";
+
+	//first look for /quests/zone/npcid.ext (precedence)
+	QuestInterface *qi = GetQIByFile(zone_dir + itoa(npcid), filename);
+	if(qi)
+		return qi;
+
 	//second look for /quests/zone/npcname.ext (precedence)
 	const NPCType *npc_type = database.GetNPCType(npcid);
 	if(!npc_type) {
@@ -492,477 +653,152 @@ QuestInterface *QuestParserCollection::GetQIByNPCQuest(uint32 npcid, std::string
 		}
 	}
 
-	filename = "quests/";
-	filename += zone->GetShortName();
-	filename += "/";
-	filename += npc_name;
-
-	iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
+	qi = GetQIByFile(zone_dir + npc_name, filename);
+	if(qi)
+		return qi;
 
 	//third look for /quests/global/npcid.ext (precedence)
-	filename = "quests/";
-	filename += QUEST_GLOBAL_DIRECTORY;
-	filename += "/";
-	filename += itoa(npcid);
-	iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
+	qi = GetQIByFile(global_dir + itoa(npcid), filename);
+	if(qi)
+		return qi;
 
 	//fourth look for /quests/global/npcname.ext (precedence)
-	filename = "quests/";
-	filename += QUEST_GLOBAL_DIRECTORY;
-	filename += "/";
-	filename += npc_name;
-	iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
+	qi = GetQIByFile(global_dir + npc_name, filename);
+	if(qi)
+		return qi;
 
 	//fifth look for /quests/zone/default.ext (precedence)
-	filename = "quests/";
-	filename += zone->GetShortName();
-	filename += "/";
-	filename += "default";
-	iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
+	qi = GetQIByFile(zone_dir + "default", filename);
+	if(qi)
+		return qi;
 
 	//last look for /quests/global/default.ext (precedence)
-	filename = "quests/";
-	filename += QUEST_GLOBAL_DIRECTORY;
-	filename += "/";
-	filename += "default";
-	iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
-
-	return nullptr;
+	return GetQIByFile(global_dir + "default", filename);
 }
 
 QuestInterface *QuestParserCollection::GetQIByPlayerQuest(std::string &filename) {
 	if(!zone || !zone->IsLoaded())
 		return nullptr;
 
-	//first look for /quests/zone/player_v[instance_version].ext (precedence)
-	filename = "quests/";
-	filename += zone->GetShortName();
-	filename += "/";
-	filename += "player_v";
-	filename += itoa(zone->GetInstanceVersion());
-	std::string tmp;
-	FILE *f = nullptr;
+	UpdateQuestFileIndex();
 
-	std::list<QuestInterface*>::iterator iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
+	std::string zone_dir = "quests/";
+	zone_dir += zone->GetShortName();
+	zone_dir += "/";
 
-		++iter;
-	}
+	//first look for /quests/zone/player_v[instance_version].ext (precedence)
+	QuestInterface *qi = GetQIByFile(zone_dir + "player_v" + itoa(zone->GetInstanceVersion()), filename);
+	if(qi)
+		return qi;
 
 	//second look for /quests/zone/player.ext (precedence)
-	filename = "quests/";
-	filename += zone->GetShortName();
-	filename += "/";
-	filename += "player";
-
-	iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
+	qi = GetQIByFile(zone_dir + "player", filename);
+	if(qi)
+		return qi;
 
 	//third look for /quests/global/player.ext (precedence)
-	filename = "quests/";
-	filename += QUEST_GLOBAL_DIRECTORY;
-	filename += "/";
-	filename += "player";
-	iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
-
-	return nullptr;
+	std::string global_dir = "quests/";
+	global_dir += QUEST_GLOBAL_DIRECTORY;
+	global_dir += "/";
+	return GetQIByFile(global_dir + "player", filename);
 }
 
 QuestInterface *QuestParserCollection::GetQIByGlobalNPCQuest(std::string &filename) {
-	// simply look for /quests/global/global_npc.ext
-	filename = "quests/";
-	filename += QUEST_GLOBAL_DIRECTORY;
-	filename += "/";
-	filename += "global_npc";
-	std::string tmp;
-	FILE *f = nullptr;
+	UpdateQuestFileIndex();
 
-	std::list<QuestInterface*>::iterator iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
-
-	return nullptr;
+	// simply look for /quests/global/global_npc.ext
+	std::string base = "quests/";
+	base += QUEST_GLOBAL_DIRECTORY;
+	base += "/global_npc";
+	return GetQIByFile(base, filename);
 }
 
 QuestInterface *QuestParserCollection::GetQIByGlobalPlayerQuest(std::string &filename) {
-	//first look for /quests/global/player.ext (precedence)
-	filename = "quests/";
-	filename += QUEST_GLOBAL_DIRECTORY;
-	filename += "/";
-	filename += "global_player";
-	std::string tmp;
-	FILE *f = nullptr;
+	UpdateQuestFileIndex();
 
-	std::list<QuestInterface*>::iterator iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
-
-	return nullptr;
+	//first look for /quests/global/player.ext (precedence)
+	std::string base = "quests/";
+	base += QUEST_GLOBAL_DIRECTORY;
+	base += "/global_player";
+	return GetQIByFile(base, filename);
 }
 
 QuestInterface *QuestParserCollection::GetQIBySpellQuest(uint32 spell_id, std::string &filename) {
-	//first look for /quests/zone/spells/spell_id.ext (precedence)
-	filename = "quests/";
-	filename += zone->GetShortName();
-	filename += "/spells/";
-	filename += itoa(spell_id);
-	std::string tmp;
-	FILE *f = nullptr;
+	UpdateQuestFileIndex();
 
-	std::list<QuestInterface*>::iterator iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
+	std::string zone_dir = "quests/";
+	zone_dir += zone->GetShortName();
+	zone_dir += "/spells/";
+	std::string global_dir = "quests/";
+	global_dir += QUEST_GLOBAL_DIRECTORY;
+	global_dir += "/spells/";
 
-		++iter;
-	}
+	//first look for /quests/zone/spells/spell_id.ext (precedence)
+	QuestInterface *qi = GetQIByFile(zone_dir + itoa(spell_id), filename);
+	if(qi)
+		return qi;
 
 	//second look for /quests/global/spells/spell_id.ext (precedence)
-	filename = "quests/";
-	filename += QUEST_GLOBAL_DIRECTORY;
-	filename += "/spells/";
-	filename += itoa(spell_id);
-
-	iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
+	qi = GetQIByFile(global_dir + itoa(spell_id), filename);
+	if(qi)
+		return qi;
 
 	//third look for /quests/zone/spells/default.ext (precedence)
-	filename = "quests/";
-	filename += zone->GetShortName();
-	filename += "/spells/default";
-
-	iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
+	qi = GetQIByFile(zone_dir + "default", filename);
+	if(qi)
+		return qi;
 
 	//last look for /quests/global/spells/default.ext (precedence)
-	filename = "quests/";
-	filename += QUEST_GLOBAL_DIRECTORY;
-	filename += "/spells/default";
-
-	iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
-
-	return nullptr;
+	return GetQIByFile(global_dir + "default", filename);
 }
 
 QuestInterface *QuestParserCollection::GetQIByItemQuest(std::string item_script, std::string &filename) {
-	//first look for /quests/zone/items/item_script.ext (precedence)
-	filename = "quests/";
-	filename += zone->GetShortName();
-	filename += "/items/";
-	filename += item_script;
-	std::string tmp;
-	FILE *f = nullptr;
-
-	std::list<QuestInterface*>::iterator iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
+	UpdateQuestFileIndex();
 
-		++iter;
-	}
-	
-	//second look for /quests/global/items/item_script.ext (precedence)
-	filename = "quests/";
-	filename += QUEST_GLOBAL_DIRECTORY;
-	filename += "/items/";
-	filename += item_script;
+	std::string zone_dir = "quests/";
+	zone_dir += zone->GetShortName();
+	zone_dir += "/items/";
+	std::string global_dir = "quests/";
+	global_dir += QUEST_GLOBAL_DIRECTORY;
+	global_dir += "/items/";
 
-	iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
+	//first look for /quests/zone/items/item_script.ext (precedence)
+	QuestInterface *qi = GetQIByFile(zone_dir + item_script, filename);
+	if(qi)
+		return qi;
 
-		++iter;
-	}
+	//second look for /quests/global/items/item_script.ext (precedence)
+	qi = GetQIByFile(global_dir + item_script, filename);
+	if(qi)
+		return qi;
 
 	//third look for /quests/zone/items/default.ext (precedence)
-	filename = "quests/";
-	filename += zone->GetShortName();
-	filename += "/items/default";
-
-	iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
+	qi = GetQIByFile(zone_dir + "default", filename);
+	if(qi)
+		return qi;
 
 	//last look for /quests/global/items/default.ext (precedence)
-	filename = "quests/";
-	filename += QUEST_GLOBAL_DIRECTORY;
-	filename += "/items/default";
-
-	iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		std::map<uint32, std::string>::iterator ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
-
-	return nullptr;
+	return GetQIByFile(global_dir + "default", filename);
 }
 
 QuestInterface *QuestParserCollection::GetQIByEncounterQuest(std::string encounter_name, std::string &filename) {
-	//first look for /quests/zone/encounters/encounter_name.ext (precedence)
-	filename = "quests/";
-	filename += zone->GetShortName();
-	filename += "/encounters/";
-	filename += encounter_name;
-	std::string tmp;
-	FILE *f = nullptr;
+	UpdateQuestFileIndex();
 
-	auto iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		auto ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
+	//first look for /quests/zone/encounters/encounter_name.ext (precedence)
+	std::string base = "quests/";
+	base += zone->GetShortName();
+	base += "/encounters/";
+	base += encounter_name;
+	QuestInterface *qi = GetQIByFile(base, filename);
+	if(qi)
+		return qi;
 
-		++iter;
-	}
-	
 	//second look for /quests/global/encounters/encounter_name.ext (precedence)
-	filename = "quests/";
-	filename += QUEST_GLOBAL_DIRECTORY;
-	filename += "/encounters/";
-	filename += encounter_name;
-
-	iter = _load_precedence.begin();
-	while(iter != _load_precedence.end()) {
-		tmp = filename;
-		auto ext = _extensions.find((*iter)->GetIdentifier());
-		tmp += ".";
-		tmp += ext->second;
-		f = fopen(tmp.c_str(), "r");
-		if(f) {
-			fclose(f);
-			filename = tmp;
-			return (*iter);
-		}
-
-		++iter;
-	}
-
-	return nullptr;
+	base = "quests/";
+	base += QUEST_GLOBAL_DIRECTORY;
+	base += "/encounters/";
+	base += encounter_name;
+	return GetQIByFile(base, filename);
 }
 
 void QuestParserCollection::GetErrors(std::list<std::string> &err) {
@@ -974,7 +810,7 @@ void QuestParserCollection::GetErrors(std::list<std::string> &err) {
 	}
 }
 
-int QuestParserCollection::DispatchEventNPC(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
+int QuestParserCollection::DispatchEventNPC(QuestEventID evt, NPC* npc, Mob *init, const std::string &data, uint32 extra_data,
 											 std::vector<EQEmu::Any> *extra_pointers) {
     int ret = 0;
 	auto iter = _load_precedence.begin();
@@ -988,7 +824,7 @@ int QuestParserCollection::DispatchEventNPC(QuestEventID evt, NPC* npc, Mob *ini
     return ret;
 }
 
-int QuestParserCollection::DispatchEventPlayer(QuestEventID evt, Client *client, std::string data, uint32 extra_data,
+int QuestParserCollection::DispatchEventPlayer(QuestEventID evt, Client *client, const std::string &data, uint32 extra_data,
 												std::vector<EQEmu::Any> *extra_pointers) {
     int ret = 0;
 	auto iter = _load_precedence.begin();
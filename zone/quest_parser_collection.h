@@ -34,8 +34,11 @@
 
 #include "quest_interface.h"
 
+#include <bitset>
 #include <list>
 #include <map>
+#include <set>
+#include <unordered_map>
 
 #define QuestFailedToLoad 0xFFFFFFFF
 #define QuestUnloaded 0x00
@@ -47,6 +50,8 @@ class NPC;
 class QuestInterface;
 namespace EQEmu { class Any; }
 
+typedef std::bitset<_LargestEventID> QuestEventMask;
+
 class QuestParserCollection {
 public:
 	QuestParserCollection();
@@ -58,15 +63,16 @@ public:
 	void AddVar(std::string name, std::string val);
 	void Init();
 	void ReloadQuests(bool reset_timers = true);
+	void CollectGarbage();
 
 	bool HasQuestSub(uint32 npcid, QuestEventID evt);
 	bool PlayerHasQuestSub(QuestEventID evt);
 	bool SpellHasQuestSub(uint32 spell_id, QuestEventID evt);
 	bool ItemHasQuestSub(ItemInst *itm, QuestEventID evt);
 
-	int EventNPC(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
+	int EventNPC(QuestEventID evt, NPC* npc, Mob *init, const std::string &data, uint32 extra_data,
 		std::vector<EQEmu::Any> *extra_pointers = nullptr);
-	int EventPlayer(QuestEventID evt, Client *client, std::string data, uint32 extra_data,
+	int EventPlayer(QuestEventID evt, Client *client, const std::string &data, uint32 extra_data,
 		std::vector<EQEmu::Any> *extra_pointers = nullptr);
 	int EventItem(QuestEventID evt, Client *client, ItemInst *item, Mob *mob, std::string data, uint32 extra_data,
 		std::vector<EQEmu::Any> *extra_pointers = nullptr);
@@ -83,10 +89,23 @@ private:
 	bool PlayerHasQuestSubLocal(QuestEventID evt);
 	bool PlayerHasQuestSubGlobal(QuestEventID evt);
 
-	int EventNPCLocal(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data, std::vector<EQEmu::Any> *extra_pointers);
-	int EventNPCGlobal(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data, std::vector<EQEmu::Any> *extra_pointers);
-	int EventPlayerLocal(QuestEventID evt, Client *client, std::string data, uint32 extra_data,	std::vector<EQEmu::Any> *extra_pointers);
-	int EventPlayerGlobal(QuestEventID evt, Client *client, std::string data, uint32 extra_data, std::vector<EQEmu::Any> *extra_pointers);
+	int EventNPCLocal(QuestEventID evt, NPC* npc, Mob *init, const std::string &data, uint32 extra_data, std::vector<EQEmu::Any> *extra_pointers);
+	int EventNPCGlobal(QuestEventID evt, NPC* npc, Mob *init, const std::string &data, uint32 extra_data, std::vector<EQEmu::Any> *extra_pointers);
+	int EventPlayerLocal(QuestEventID evt, Client *client, const std::string &data, uint32 extra_data,	std::vector<EQEmu::Any> *extra_pointers);
+	int EventPlayerGlobal(QuestEventID evt, Client *client, const std::string &data, uint32 extra_data, std::vector<EQEmu::Any> *extra_pointers);
+
+	const QuestEventMask &GetNPCQuestEvents(uint32 npcid);
+	void LoadGlobalNPCQuest();
+	void LoadPlayerQuest();
+	void LoadGlobalPlayerQuest();
+	static void GetQuestEvents(QuestInterface *qi, QuestEventMask &events, uint32 npcid, int type);
+	bool HasEncounterEvents();
+
+	void BuildQuestFileIndex();
+	void IndexQuestDirectory(const std::string &dir);
+	void UpdateQuestFileIndex();
+	void CloseQuestFileWatch();
+	QuestInterface *GetQIByFile(const std::string &base, std::string &filename);
 
 	QuestInterface *GetQIByNPCQuest(uint32 npcid, std::string &filename);
 	QuestInterface *GetQIByGlobalNPCQuest(std::string &filename);
@@ -96,9 +115,9 @@ private:
 	QuestInterface *GetQIByItemQuest(std::string item_script, std::string &filename);
 	QuestInterface *GetQIByEncounterQuest(std::string encounter_name, std::string &filename);
 	
-	int DispatchEventNPC(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
+	int DispatchEventNPC(QuestEventID evt, NPC* npc, Mob *init, const std::string &data, uint32 extra_data,
 		std::vector<EQEmu::Any> *extra_pointers);
-	int DispatchEventPlayer(QuestEventID evt, Client *client, std::string data, uint32 extra_data,
+	int DispatchEventPlayer(QuestEventID evt, Client *client, const std::string &data, uint32 extra_data,
 		std::vector<EQEmu::Any> *extra_pointers);
 	int DispatchEventItem(QuestEventID evt, Client *client, ItemInst *item, Mob *mob, std::string data, uint32 extra_data,
 		std::vector<EQEmu::Any> *extra_pointers);
@@ -118,6 +137,19 @@ private:
 	std::map<uint32, uint32> _spell_quest_status;
 	std::map<uint32, uint32> _item_quest_status;
 	std::map<std::string, uint32> _encounter_quest_status;
+
+	//events each loaded script has a sub for, filled in when the script loads
+	std::unordered_map<uint32, QuestEventMask> _npc_quest_events;
+	QuestEventMask _global_npc_quest_events;
+	QuestEventMask _player_quest_events;
+	QuestEventMask _global_player_quest_events;
+
+	//every file in the quest directories of _quest_files_zone, so lookups never probe the disk.
+	//kept current by inotify on linux, elsewhere by #reloadquest
+	std::set<std::string> _quest_files;
+	std::string _quest_files_zone;
+	int _quest_watch_fd;
+	std::map<int, std::string> _quest_watch_dirs;
 };
 
 extern QuestParserCollection *parse;
@@ -1983,8 +1983,8 @@ uint32 QuestManager::MerchantCountItem(uint32 NPCid, uint32 itemid) {
 		return 0;	// if it isn't a valid item, the merchant doesn't have any
 
 	// look for the item in the merchant's temporary list
-	std::list<TempMerchantList> MerchList = zone->tmpmerchanttable[NPCid];
-	std::list<TempMerchantList>::const_iterator itr;
+	const std::vector<TempMerchantList> &MerchList = zone->tmpmerchanttable[NPCid];
+	std::vector<TempMerchantList>::const_iterator itr;
 	uint32 Quant = 0;
 
 	for (itr = MerchList.begin(); itr != MerchList.end(); ++itr) {
@@ -16,6 +16,7 @@
 	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 */
 
+#include "../common/eq_broadcast_packet.h"
 #include "../common/string_util.h"
 
 #include "client.h"
@@ -52,10 +53,13 @@ Raid::Raid(Client* nLeader)
 
 Raid::~Raid()
 {
+	SaveMembers();
 }
 
 bool Raid::Process()
 {
+	SaveMembers();
+
 	if(forceDisband)
 		return false;
 	if(disbandCheck)
@@ -74,71 +78,232 @@ bool Raid::Process()
 	return true;
 }
 
-void Raid::AddMember(Client *c, uint32 group, bool rleader, bool groupleader, bool looter){
-	if(!c)
+/*
+	Membership changes made in this zone are applied to members[] right away
+	and the rows are marked dirty; SaveMembers() writes them all out together
+	from Process() on the raid timer (once a second), before the raid is read
+	back from the db and before a member zones out. Other zones get the changed
+	member in the ServerPacket and apply it the same way, so nobody reloads the
+	raid from the db on a change. A zone loading the raid for a member zoning in
+	can miss a change made elsewhere in the last second; the member's own zone
+	has already written its rows when they left.
+*/
+RaidMember *Raid::FindMember(const char *name)
+{
+	if(!name || !name[0])
+		return nullptr;
+
+	auto it = member_index.find(name);
+	if(it == member_index.end())
+		return nullptr;
+	return &members[it->second];
+}
+
+RaidMember *Raid::AddMemberSlot(const char *name)
+{
+	RaidMember *m = FindMember(name);
+	if(m)
+		return m;
+
+	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
+	{
+		if(members[x].membername[0] == 0)
+		{
+			memset(&members[x], 0, sizeof(RaidMember));
+			strn0cpy(members[x].membername, name, 64);
+			member_index[members[x].membername] = x;
+			return &members[x];
+		}
+	}
+	return nullptr;
+}
+
+//drops the member and closes the gap, the way a reload from the db would leave the list
+void Raid::RemoveMemberSlot(const char *name)
+{
+	RaidMember *m = FindMember(name);
+	if(!m)
 		return;
 
-	std::string query = StringFormat("INSERT INTO raid_members SET raidid = %lu, charid = %lu, "
-                                    "groupid = %lu, _class = %d, level = %d, name = '%s', "
-                                    "isgroupleader = %d, israidleader = %d, islooter = %d",
-                                    (unsigned long)GetID(), (unsigned long)c->CharacterID(),
-                                    (unsigned long)group, c->GetClass(), c->GetLevel(),
-                                    c->GetName(), groupleader, rleader, looter);
-    auto results = database.QueryDatabase(query);
+	int slot = m - members;
+	memmove(&members[slot], &members[slot + 1], sizeof(RaidMember) * (MAX_RAID_MEMBERS - slot - 1));
+	memset(&members[MAX_RAID_MEMBERS - 1], 0, sizeof(RaidMember));
+	IndexMembers();
+}
 
-	if(!results.Success()) {
-		Log.Out(Logs::General, Logs::Error, "Error inserting into raid members: %s", results.ErrorMessage().c_str());
+void Raid::IndexMembers()
+{
+	member_index.clear();
+	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
+	{
+		if(members[x].membername[0])
+			member_index[members[x].membername] = x;
 	}
+}
 
-	LearnMembers();
-	VerifyRaid();
-	if(group < 12)
-		GroupUpdate(group);
-	SendRaidAddAll(c->GetName());
+void Raid::SaveMembers()
+{
+	if(!removed_members.empty())
+	{
+		std::string query = "DELETE FROM raid_members WHERE charid IN (";
+		for(size_t i = 0; i < removed_members.size(); i++)
+			query += StringFormat(i ? ", %lu" : "%lu", (unsigned long)removed_members[i]);
+		query += ")";
+		auto results = database.QueryDatabase(query);
+		if(!results.Success())
+			Log.Out(Logs::General, Logs::Error, "Error removing raid members: %s", results.ErrorMessage().c_str());
+		removed_members.clear();
+	}
 
-	c->SetRaidGrouped(true);
+	std::string values;
+	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
+	{
+		if(!members[x].dirty)
+			continue;
+		members[x].dirty = false;
+		if(members[x].membername[0] == 0)
+			continue;
+
+		if(!values.empty())
+			values += ", ";
+		values += StringFormat("(%lu, %lu, %lu, %d, %d, '%s', %d, %d, %d)",
+			(unsigned long)GetID(), (unsigned long)members[x].charid, (unsigned long)members[x].GroupNumber,
+			members[x]._class, members[x].level, members[x].membername,
+			members[x].IsGroupLeader, members[x].IsRaidLeader, members[x].IsLooter);
+	}
 
-	ServerPacket *pack = new ServerPacket(ServerOP_RaidAdd, sizeof(ServerRaidGeneralAction_Struct));
+	if(values.empty())
+		return;
+
+	std::string query = "REPLACE INTO raid_members (raidid, charid, groupid, _class, level, name, "
+		"isgroupleader, israidleader, islooter) VALUES " + values;
+	auto results = database.QueryDatabase(query);
+	if(!results.Success())
+		Log.Out(Logs::General, Logs::Error, "Error saving raid members: %s", results.ErrorMessage().c_str());
+}
+
+void Raid::SendMemberAction(uint16 opcode, const char *name)
+{
+	ServerPacket *pack = new ServerPacket(opcode, sizeof(ServerRaidGeneralAction_Struct));
 	ServerRaidGeneralAction_Struct *rga = (ServerRaidGeneralAction_Struct*)pack->pBuffer;
 	rga->rid = GetID();
-	strn0cpy(rga->playername, c->GetName(), 64);
+	strn0cpy(rga->playername, name, 64);
 	rga->zoneid = zone->GetZoneID();
 	rga->instance_id = zone->GetInstanceID();
+
+	RaidMember *m = FindMember(name);
+	if(m)
+	{
+		rga->gid = m->GroupNumber;
+		rga->charid = m->charid;
+		rga->_class = m->_class;
+		rga->level = m->level;
+		rga->isgroupleader = m->IsGroupLeader;
+		rga->israidleader = m->IsRaidLeader;
+		rga->islooter = m->IsLooter;
+	}
 	worldserver.SendPacket(pack);
 	safe_delete(pack);
 }
 
+void Raid::ApplyMemberUpdate(const ServerRaidGeneralAction_Struct *rga)
+{
+	RaidMember *m = AddMemberSlot(rga->playername);
+	if(!m)
+		return;
+
+	m->charid = rga->charid;
+	m->GroupNumber = rga->gid > 11 ? 0xFFFFFFFF : rga->gid;
+	m->_class = rga->_class;
+	m->level = rga->level;
+	m->IsGroupLeader = rga->isgroupleader;
+	m->IsRaidLeader = rga->israidleader;
+	m->IsLooter = rga->islooter;
+}
+
+void Raid::ApplyMemberRemove(const char *name)
+{
+	disbandCheck = true;
+	RemoveMemberSlot(name);
+}
+
+void Raid::ApplyRaidLeader(const char *name)
+{
+	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
+		members[x].IsRaidLeader = false;
+
+	RaidMember *m = FindMember(name);
+	if(m)
+		m->IsRaidLeader = true;
+}
+
+void Raid::ApplyDisband()
+{
+	memset(members, 0, (sizeof(RaidMember)*MAX_RAID_MEMBERS));
+	member_index.clear();
+	disbandCheck = true;
+}
+
+void Raid::AddMember(Client *c, uint32 group, bool rleader, bool groupleader, bool looter){
+	if(!c)
+		return;
+
+	RaidMember *m = AddMemberSlot(c->GetName());
+	if(!m) {
+		Log.Out(Logs::General, Logs::Error, "Raid %lu is full, unable to add %s", (unsigned long)GetID(), c->GetName());
+		return;
+	}
+
+	m->charid = c->CharacterID();
+	m->GroupNumber = group > 11 ? 0xFFFFFFFF : group;
+	m->_class = c->GetClass();
+	m->level = c->GetLevel();
+	m->IsGroupLeader = groupleader;
+	m->IsRaidLeader = rleader;
+	m->IsLooter = looter;
+	m->dirty = true;
+
+	VerifyRaid();
+	if(group < 12)
+		GroupUpdate(group);
+	SendRaidAddAll(c->GetName());
+
+	c->SetRaidGrouped(true);
+
+	SendMemberAction(ServerOP_RaidAdd, c->GetName());
+}
+
 void Raid::RemoveMember(const char *characterName)
 {
-	std::string query = StringFormat("DELETE FROM raid_members where name='%s'", characterName);
-	auto results = database.QueryDatabase(query);
+	RaidMember *m = FindMember(characterName);
+	if(m) {
+		removed_members.push_back(m->charid);
+	}
+	else {
+		std::string query = StringFormat("DELETE FROM raid_members where name='%s'", characterName);
+		auto results = database.QueryDatabase(query);
+	}
 
 	Client *client = entity_list.GetClientByName(characterName);
 	disbandCheck = true;
 	SendRaidRemoveAll(characterName);
 	SendRaidDisband(client);
-	LearnMembers();
+	RemoveMemberSlot(characterName);
 	VerifyRaid();
 
 	if(client)
 		client->SetRaidGrouped(false);
 
-	ServerPacket *pack = new ServerPacket(ServerOP_RaidRemove, sizeof(ServerRaidGeneralAction_Struct));
-	ServerRaidGeneralAction_Struct *rga = (ServerRaidGeneralAction_Struct*)pack->pBuffer;
-	rga->rid = GetID();
-	rga->instance_id = zone->GetInstanceID();
-	strn0cpy(rga->playername, characterName, 64);
-	rga->zoneid = zone->GetZoneID();
-	worldserver.SendPacket(pack);
-	safe_delete(pack);
+	SendMemberAction(ServerOP_RaidRemove, characterName);
 }
 
 void Raid::DisbandRaid()
 {
 	std::string query = StringFormat("DELETE FROM raid_members WHERE raidid = %lu", (unsigned long)GetID());
 	auto results = database.QueryDatabase(query);
+	removed_members.clear();
 
-	LearnMembers();
+	ApplyDisband();
 	VerifyRaid();
 	SendRaidDisbandAll();
 
@@ -156,54 +321,43 @@ void Raid::DisbandRaid()
 
 void Raid::MoveMember(const char *name, uint32 newGroup)
 {
-	std::string query = StringFormat("UPDATE raid_members SET groupid = %lu WHERE name = '%s'",
-                                    (unsigned long)newGroup, name);
-    auto results = database.QueryDatabase(query);
+	RaidMember *m = FindMember(name);
+	if(m) {
+		m->GroupNumber = newGroup > 11 ? 0xFFFFFFFF : newGroup;
+		m->dirty = true;
+	}
 
-	LearnMembers();
 	VerifyRaid();
 	SendRaidMoveAll(name);
 
-	ServerPacket *pack = new ServerPacket(ServerOP_RaidChangeGroup, sizeof(ServerRaidGeneralAction_Struct));
-	ServerRaidGeneralAction_Struct *rga = (ServerRaidGeneralAction_Struct*)pack->pBuffer;
-	rga->rid = GetID();
-	strn0cpy(rga->playername, name, 64);
-	rga->zoneid = zone->GetZoneID();
-	rga->instance_id = zone->GetInstanceID();
-	worldserver.SendPacket(pack);
-	safe_delete(pack);
+	SendMemberAction(ServerOP_RaidChangeGroup, name);
 }
 
 void Raid::SetGroupLeader(const char *who, bool glFlag)
 {
-	std::string query = StringFormat("UPDATE raid_members SET isgroupleader = %lu WHERE name = '%s'",
-                                    (unsigned long)glFlag, who);
-    auto results = database.QueryDatabase(query);
+	RaidMember *m = FindMember(who);
+	if(m) {
+		m->IsGroupLeader = glFlag;
+		m->dirty = true;
+	}
 
-	LearnMembers();
 	VerifyRaid();
 
-	ServerPacket *pack = new ServerPacket(ServerOP_RaidGroupLeader, sizeof(ServerRaidGeneralAction_Struct));
-	ServerRaidGeneralAction_Struct *rga = (ServerRaidGeneralAction_Struct*)pack->pBuffer;
-	rga->rid = GetID();
-	strn0cpy(rga->playername, who, 64);
-	rga->zoneid = zone->GetZoneID();
-	rga->instance_id = zone->GetInstanceID();
-	worldserver.SendPacket(pack);
-	safe_delete(pack);
+	SendMemberAction(ServerOP_RaidGroupLeader, who);
 }
 
 void Raid::SetRaidLeader(const char *wasLead, const char *name)
 {
-	std::string query = StringFormat("UPDATE raid_members SET israidleader = 0 WHERE name = '%s'", wasLead);
-	auto results = database.QueryDatabase(query);
-	if (!results.Success())
-		Log.Out(Logs::General, Logs::Error, "Set Raid Leader error: %s\n", results.ErrorMessage().c_str());
-
-	query = StringFormat("UPDATE raid_members SET israidleader = 1 WHERE name = '%s'", name);
-	results = database.QueryDatabase(query);
-	if (!results.Success())
-		Log.Out(Logs::General, Logs::Error, "Set Raid Leader error: %s\n", results.ErrorMessage().c_str());
+	RaidMember *m = FindMember(wasLead);
+	if(m) {
+		m->IsRaidLeader = false;
+		m->dirty = true;
+	}
+	m = FindMember(name);
+	if(m) {
+		m->IsRaidLeader = true;
+		m->dirty = true;
+	}
 
 	strn0cpy(leadername, name, 64);
 
@@ -211,40 +365,33 @@ void Raid::SetRaidLeader(const char *wasLead, const char *name)
 	if(c)
 		SetLeader(c);
 
-	LearnMembers();
 	VerifyRaid();
 	SendMakeLeaderPacket(name);
 
-	ServerPacket *pack = new ServerPacket(ServerOP_RaidLeader, sizeof(ServerRaidGeneralAction_Struct));
-	ServerRaidGeneralAction_Struct *rga = (ServerRaidGeneralAction_Struct*)pack->pBuffer;
-	rga->rid = GetID();
-	strn0cpy(rga->playername, name, 64);
-	rga->zoneid = zone->GetZoneID();
-	rga->instance_id = zone->GetInstanceID();
-	worldserver.SendPacket(pack);
-	safe_delete(pack);
+	SendMemberAction(ServerOP_RaidLeader, name);
 }
 
 bool Raid::IsGroupLeader(const char *who)
 {
-	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
-	{
-		if(strcmp(who, members[x].membername) == 0){
-			return members[x].IsGroupLeader;
-		}
-	}
+	RaidMember *m = FindMember(who);
+	if(m)
+		return m->IsGroupLeader;
 
 	return false;
 }
 
 void Raid::UpdateLevel(const char *name, int newLevel)
 {
-	std::string query = StringFormat("UPDATE raid_members SET level = %lu WHERE name = '%s'",
-                                    (unsigned long)newLevel, name);
-    auto results = database.QueryDatabase(query);
+	RaidMember *m = FindMember(name);
+	if(m) {
+		m->level = newLevel;
+		m->dirty = true;
+	}
 
-	LearnMembers();
 	VerifyRaid();
+
+	//other zones write the whole row on their next change to this member
+	SendMemberAction(ServerOP_DetailsChange, name);
 }
 
 uint32 Raid::GetFreeGroup()
@@ -304,11 +451,9 @@ uint8 Raid::RaidCount()
 
 uint32 Raid::GetGroup(const char *name)
 {
-	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
-	{
-		if(strcmp(members[x].membername, name) == 0)
-			return members[x].GroupNumber;
-	}
+	RaidMember *m = FindMember(name);
+	if(m)
+		return m->GroupNumber;
 	return 0xFFFFFFFF;
 }
 
@@ -362,12 +507,9 @@ void Raid::RaidGroupSay(const char *msg, Client *c)
 }
 
 uint32 Raid::GetPlayerIndex(const char *name){
-	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
-	{
-		if(strcmp(name, members[x].membername) == 0){
-			return x;
-		}
-	}
+	RaidMember *m = FindMember(name);
+	if(m)
+		return m - members;
 	return 0; //should never get to here if we do everything else right, set it to 0 so we never crash things that rely on it.
 }
 
@@ -751,53 +893,28 @@ void Raid::ChangeLootType(uint32 type)
 
 void Raid::AddRaidLooter(const char* looter)
 {
-	std::string query = StringFormat("UPDATE raid_members SET islooter = 1 WHERE name = '%s'", looter);
-	auto results = database.QueryDatabase(query);
-
-	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
-	{
-		if(strcmp(looter, members[x].membername) == 0)
-		{
-			members[x].IsLooter = 1;
-			break;
-		}
+	RaidMember *m = FindMember(looter);
+	if(m) {
+		m->IsLooter = 1;
+		m->dirty = true;
 	}
-	ServerPacket *pack = new ServerPacket(ServerOP_DetailsChange, sizeof(ServerRaidGeneralAction_Struct));
-	ServerRaidGeneralAction_Struct *rga = (ServerRaidGeneralAction_Struct*)pack->pBuffer;
-	rga->rid = GetID();
-	rga->zoneid = zone->GetZoneID();
-	rga->instance_id = zone->GetInstanceID();
-	worldserver.SendPacket(pack);
-	safe_delete(pack);
+
+	SendMemberAction(ServerOP_DetailsChange, looter);
 }
 
 void Raid::RemoveRaidLooter(const char* looter)
 {
-	std::string query = StringFormat("UPDATE raid_members SET islooter = 0 WHERE name = '%s'", looter);
-	auto results = database.QueryDatabase(query);
-
-	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
-		if(strcmp(looter, members[x].membername) == 0) {
-			members[x].IsLooter = 0;
-			break;
-		}
+	RaidMember *m = FindMember(looter);
+	if(m) {
+		m->IsLooter = 0;
+		m->dirty = true;
+	}
 
-	ServerPacket *pack = new ServerPacket(ServerOP_DetailsChange, sizeof(ServerRaidGeneralAction_Struct));
-	ServerRaidGeneralAction_Struct *rga = (ServerRaidGeneralAction_Struct*)pack->pBuffer;
-	rga->rid = GetID();
-	rga->zoneid = zone->GetZoneID();
-	rga->instance_id = zone->GetInstanceID();
-	worldserver.SendPacket(pack);
-	safe_delete(pack);
+	SendMemberAction(ServerOP_DetailsChange, looter);
 }
 
 bool Raid::IsRaidMember(const char *name){
-	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
-	{
-		if(strcmp(name, members[x].membername) == 0)
-			return true;
-	}
-	return false;
+	return FindMember(name) != nullptr;
 }
 
 uint32 Raid::GetHighestLevel()
@@ -849,46 +966,40 @@ void Raid::SendRaidAdd(const char *who, Client *to)
 	if(!to)
 		return;
 
-	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
-	{
-		if(strcmp(members[x].membername, who) == 0)
-		{
-			EQApplicationPacket* outapp = new EQApplicationPacket(OP_RaidUpdate, sizeof(RaidAddMember_Struct));
-			RaidAddMember_Struct *ram = (RaidAddMember_Struct*)outapp->pBuffer;
-			ram->raidGen.action = raidAdd;
-			ram->raidGen.parameter = members[x].GroupNumber;
-			strn0cpy(ram->raidGen.leader_name, members[x].membername, 64);
-			strn0cpy(ram->raidGen.player_name, members[x].membername, 64);
-			ram->_class = members[x]._class;
-			ram->level = members[x].level;
-			ram->isGroupLeader = members[x].IsGroupLeader;
-			to->QueuePacket(outapp);
-			safe_delete(outapp);
-			return;
-		}
-	}
+	RaidMember *m = FindMember(who);
+	if(!m)
+		return;
+
+	EQApplicationPacket* outapp = new EQApplicationPacket(OP_RaidUpdate, sizeof(RaidAddMember_Struct));
+	RaidAddMember_Struct *ram = (RaidAddMember_Struct*)outapp->pBuffer;
+	ram->raidGen.action = raidAdd;
+	ram->raidGen.parameter = m->GroupNumber;
+	strn0cpy(ram->raidGen.leader_name, m->membername, 64);
+	strn0cpy(ram->raidGen.player_name, m->membername, 64);
+	ram->_class = m->_class;
+	ram->level = m->level;
+	ram->isGroupLeader = m->IsGroupLeader;
+	to->QueuePacket(outapp);
+	safe_delete(outapp);
 }
 
 void Raid::SendRaidAddAll(const char *who)
 {
-	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
-	{
-		if(strcmp(members[x].membername, who) == 0)
-		{
-			EQApplicationPacket* outapp = new EQApplicationPacket(OP_RaidUpdate, sizeof(RaidAddMember_Struct));
-			RaidAddMember_Struct *ram = (RaidAddMember_Struct*)outapp->pBuffer;
-			ram->raidGen.action = raidAdd;
-			ram->raidGen.parameter = members[x].GroupNumber;
-			strcpy(ram->raidGen.leader_name, members[x].membername);
-			strcpy(ram->raidGen.player_name, members[x].membername);
-			ram->_class = members[x]._class;
-			ram->level = members[x].level;
-			ram->isGroupLeader = members[x].IsGroupLeader;
-			this->QueuePacket(outapp);
-			safe_delete(outapp);
-			return;
-		}
-	}
+	RaidMember *m = FindMember(who);
+	if(!m)
+		return;
+
+	EQApplicationPacket* outapp = new EQApplicationPacket(OP_RaidUpdate, sizeof(RaidAddMember_Struct));
+	RaidAddMember_Struct *ram = (RaidAddMember_Struct*)outapp->pBuffer;
+	ram->raidGen.action = raidAdd;
+	ram->raidGen.parameter = m->GroupNumber;
+	strcpy(ram->raidGen.leader_name, m->membername);
+	strcpy(ram->raidGen.player_name, m->membername);
+	ram->_class = m->_class;
+	ram->level = m->level;
+	ram->isGroupLeader = m->IsGroupLeader;
+	this->QueuePacket(outapp);
+	safe_delete(outapp);
 }
 
 void Raid::SendRaidRemove(const char *who, Client *to)
@@ -896,40 +1007,32 @@ void Raid::SendRaidRemove(const char *who, Client *to)
 	if(!to)
 		return;
 
-	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
-	{
-		if(strcmp(members[x].membername, who) == 0)
-		{
-			EQApplicationPacket* outapp = new EQApplicationPacket(OP_RaidUpdate, sizeof(RaidGeneral_Struct));
-			RaidGeneral_Struct *rg = (RaidGeneral_Struct*)outapp->pBuffer;
-			rg->action = raidRemove2;
-			strn0cpy(rg->leader_name, who, 64);
-			strn0cpy(rg->player_name, who, 64);
-			rg->parameter = 0;
-			to->QueuePacket(outapp);
-			safe_delete(outapp);
-			return;
-		}
-	}
+	if(!FindMember(who))
+		return;
+
+	EQApplicationPacket* outapp = new EQApplicationPacket(OP_RaidUpdate, sizeof(RaidGeneral_Struct));
+	RaidGeneral_Struct *rg = (RaidGeneral_Struct*)outapp->pBuffer;
+	rg->action = raidRemove2;
+	strn0cpy(rg->leader_name, who, 64);
+	strn0cpy(rg->player_name, who, 64);
+	rg->parameter = 0;
+	to->QueuePacket(outapp);
+	safe_delete(outapp);
 }
 
 void Raid::SendRaidRemoveAll(const char *who)
 {
-	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
-	{
-		if(strcmp(members[x].membername, who) == 0)
-		{
-			EQApplicationPacket* outapp = new EQApplicationPacket(OP_RaidUpdate, sizeof(RaidGeneral_Struct));
-			RaidGeneral_Struct *rg = (RaidGeneral_Struct*)outapp->pBuffer;
-			rg->action = raidRemove2;
-			strn0cpy(rg->leader_name, who, 64);
-			strn0cpy(rg->player_name, who, 64);
-			rg->parameter = 0;
-			QueuePacket(outapp);
-			safe_delete(outapp);
-			return;
-		}
-	}
+	if(!FindMember(who))
+		return;
+
+	EQApplicationPacket* outapp = new EQApplicationPacket(OP_RaidUpdate, sizeof(RaidGeneral_Struct));
+	RaidGeneral_Struct *rg = (RaidGeneral_Struct*)outapp->pBuffer;
+	rg->action = raidRemove2;
+	strn0cpy(rg->leader_name, who, 64);
+	strn0cpy(rg->player_name, who, 64);
+	rg->parameter = 0;
+	QueuePacket(outapp);
+	safe_delete(outapp);
 }
 
 void Raid::SendRaidDisband(Client *to)
@@ -1009,11 +1112,12 @@ void Raid::SendBulkRaid(Client *to)
 
 void Raid::QueuePacket(const EQApplicationPacket *app, bool ack_req)
 {
+	EQBroadcastPacket bp(app);
 	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
 	{
 		if(members[x].member)
 		{
-			members[x].member->QueuePacket(app, ack_req);
+			members[x].member->QueuePacket(&bp, ack_req);
 		}
 	}
 }
@@ -1260,10 +1364,12 @@ void Raid::GetRaidDetails()
 
 bool Raid::LearnMembers()
 {
+	SaveMembers();
 	memset(members, 0, (sizeof(RaidMember)*MAX_RAID_MEMBERS));
+	member_index.clear();
 
 	std::string query = StringFormat("SELECT name, groupid, _class, level, "
-                                    "isgroupleader, israidleader, islooter "
+                                    "isgroupleader, israidleader, islooter, charid "
                                     "FROM raid_members WHERE raidid = %lu",
                                     (unsigned long)GetID());
     auto results = database.QueryDatabase(query);
@@ -1294,9 +1400,11 @@ bool Raid::LearnMembers()
         members[index].IsGroupLeader = atoi(row[4]);
         members[index].IsRaidLeader = atoi(row[5]);
         members[index].IsLooter = atoi(row[6]);
+        members[index].charid = atoi(row[7]);
         ++index;
     }
 
+	IndexMembers();
 	return true;
 }
 
@@ -1330,6 +1438,9 @@ void Raid::MemberZoned(Client *c)
 	if(!c)
 		return;
 
+	//the zone they are going to loads the raid from the db
+	SaveMembers();
+
 	for(int x = 0; x < MAX_RAID_MEMBERS; x++)
 	{
 		if(members[x].member == c)
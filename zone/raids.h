@@ -21,9 +21,14 @@
 #include "../common/types.h"
 #include "groups.h"
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 class Client;
 class EQApplicationPacket;
 class Mob;
+struct ServerRaidGeneralAction_Struct;
 
 enum {	//raid packet types:
 	raidAdd = 0,
@@ -80,12 +85,14 @@ enum { //raid command types
 struct RaidMember{
 	char membername[64];
 	Client *member;
+	uint32 charid;
 	uint32 GroupNumber;
 	uint8 _class;
 	uint8 level;
 	bool IsGroupLeader;
 	bool IsRaidLeader;
 	bool IsLooter;
+	bool dirty;		//changed here and not yet written to raid_members
 };
 
 class Raid : public GroupIDConsumer {
@@ -160,6 +167,7 @@ public:
 	void	SaveRaidMOTD();
 	bool	LearnMembers();
 	void	VerifyRaid();
+	void	SaveMembers();	//writes out every pending member change
 	void	MemberZoned(Client *c);
 	void	SendHPPacketsTo(Client *c);
 	void	SendHPPacketsFrom(Mob *m);
@@ -195,6 +203,14 @@ public:
 
 	void	QueuePacket(const EQApplicationPacket *app, bool ack_req = true);
 
+	//apply a change another zone made, as carried in its ServerPacket, without going to the db
+	void	ApplyMemberUpdate(const ServerRaidGeneralAction_Struct *rga);
+	void	ApplyMemberRemove(const char *name);
+	void	ApplyRaidLeader(const char *name);
+	void	ApplyDisband();
+	//tells the other zones about a member's current row, every field filled from members[]
+	void	SendMemberAction(uint16 opcode, const char *name);
+
 	RaidMember members[MAX_RAID_MEMBERS];
 	char leadername[64];
 protected:
@@ -204,6 +220,15 @@ protected:
 	uint32 LootType;
 	bool disbandCheck;
 	bool forceDisband;
+
+private:
+	RaidMember *FindMember(const char *name);
+	RaidMember *AddMemberSlot(const char *name);
+	void	RemoveMemberSlot(const char *name);
+	void	IndexMembers();
+
+	std::unordered_map<std::string, uint32> member_index;	//membername to members[] slot
+	std::vector<uint32> removed_members;	//charids to delete from raid_members on the next save
 };
 
 
@@ -28,6 +28,7 @@
 #include "quest_parser_collection.h"
 #include "string_ids.h"
 #include "worldserver.h"
+#include "zone_profiler.h"
 
 #include <math.h>
 
@@ -3024,6 +3025,8 @@ snare has both of them negative, yet their range should work the same:
 
 void Mob::BuffProcess()
 {
+	PROFILE_PHASE(SpellProcess);
+
 	int buff_count = GetMaxTotalSlots();
 
 	for (int buffs_i = 0; buffs_i < buff_count; ++buffs_i)
@@ -79,6 +79,7 @@ Copyright (C) 2001-2002 EQEMu Development Team (http://eqemu.org)
 #include "quest_parser_collection.h"
 #include "string_ids.h"
 #include "worldserver.h"
+#include "zone_profiler.h"
 
 #include <assert.h>
 #include <math.h>
@@ -101,6 +102,8 @@ extern WorldServer worldserver;
 // this is run constantly for every mob
 void Mob::SpellProcess()
 {
+	PROFILE_PHASE(SpellProcess);
+
 	// check the rapid recast prevention timer
 	if(delaytimer == true && spellend_timer.Check())
 	{
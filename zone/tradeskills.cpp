@@ -19,6 +19,7 @@
 #include "../common/global_define.h"
 
 #include <stdlib.h>
+#include <algorithm>
 #include <list>
 
 #ifndef WIN32
@@ -750,100 +751,147 @@ void Client::CheckIncreaseTradeskill(uint16 success_modifier, SkillUseTypes trad
 	Log.Out(Logs::Detail, Logs::Tradeskills, "...Stage2 chance was: %f percent. 0 percent means stage1 failed", chance_stage2);
 }
 
+// FNV-1a over the sorted component ids, the key of tradeskill_index
+static uint64 HashTradeskillComponents(const std::vector<uint32> &components)
+{
+	uint64 hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < components.size(); ++i) {
+		uint32 id = components[i];
+		for (int b = 0; b < 4; ++b) {
+			hash ^= (id >> (b * 8)) & 0xFF;
+			hash *= 1099511628211ULL;
+		}
+	}
+	return hash;
+}
+
+static bool HasRecipeEntry(const TradeskillRecipe_Struct &recipe, uint32 item_id)
+{
+	return std::binary_search(recipe.entries.begin(), recipe.entries.end(), item_id);
+}
+
+void ZoneDatabase::LoadTradeskillRecipes()
+{
+	ClearTradeskillRecipes();
+	tradeskill_recipes_loaded = true;
+
+	std::string query = "SELECT id, tradeskill, skillneeded, trivial, nofail, replace_container, "
+		"name, must_learn, quest FROM tradeskill_recipe WHERE enabled";
+	auto results = QueryDatabase(query);
+	if (!results.Success()) {
+		Log.Out(Logs::General, Logs::Error, "Error in LoadTradeskillRecipes, error: %s", results.ErrorMessage().c_str());
+		return;
+	}
+
+	for (auto row = results.begin(); row != results.end(); ++row) {
+		TradeskillRecipe_Struct &recipe = tradeskill_recipes[(uint32)atoul(row[0])];
+		DBTradeskillRecipe_Struct &spec = recipe.spec;
+		spec.recipe_id = (uint32)atoul(row[0]);
+		spec.tradeskill = (SkillUseTypes)atoi(row[1]);
+		spec.skill_needed = (int16)atoi(row[2]);
+		spec.trivial = (uint16)atoi(row[3]);
+		spec.nofail = atoi(row[4]) ? true : false;
+		spec.replace_container = atoi(row[5]) ? true : false;
+		spec.name = row[6];
+		spec.must_learn = (uint8)atoi(row[7]);
+		spec.quest = atoi(row[8]) ? true : false;
+		spec.has_learnt = false;
+		spec.madecount = 0;
+	}
+
+	query = "SELECT recipe_id, item_id, componentcount, successcount, failcount "
+		"FROM tradeskill_recipe_entries ORDER BY recipe_id";
+	results = QueryDatabase(query);
+	if (!results.Success()) {
+		Log.Out(Logs::General, Logs::Error, "Error in LoadTradeskillRecipes, error: %s", results.ErrorMessage().c_str());
+		ClearTradeskillRecipes();
+		return;
+	}
+
+	auto recipe = tradeskill_recipes.end();
+	for (auto row = results.begin(); row != results.end(); ++row) {
+		uint32 recipe_id = (uint32)atoul(row[0]);
+		if (recipe == tradeskill_recipes.end() || recipe->first != recipe_id) {
+			recipe = tradeskill_recipes.find(recipe_id);
+			if (recipe == tradeskill_recipes.end())
+				continue;	//disabled
+		}
+
+		uint32 item_id = (uint32)atoul(row[1]);
+		int component_count = atoi(row[2]);
+		uint8 success_count = (uint8)atoi(row[3]);
+		uint8 fail_count = (uint8)atoi(row[4]);
+
+		recipe->second.entries.push_back(item_id);
+		for (int i = 0; i < component_count; ++i)
+			recipe->second.components.push_back(item_id);
+		if (success_count > 0)
+			recipe->second.spec.onsuccess.push_back(std::pair<uint32,uint8>(item_id, success_count));
+		if (fail_count > 0)
+			recipe->second.spec.onfail.push_back(std::pair<uint32,uint8>(item_id, fail_count));
+		// salvagecount is left out on purpose, the old per combine salvage query never returned a row
+	}
+
+	for (recipe = tradeskill_recipes.begin(); recipe != tradeskill_recipes.end(); ++recipe) {
+		std::sort(recipe->second.entries.begin(), recipe->second.entries.end());
+		std::sort(recipe->second.components.begin(), recipe->second.components.end());
+		if (!recipe->second.components.empty())
+			tradeskill_index.insert(std::make_pair(HashTradeskillComponents(recipe->second.components), recipe->first));
+	}
+
+	Log.Out(Logs::General, Logs::Status, "Loaded %u tradeskill recipes.", (uint32)tradeskill_recipes.size());
+}
+
+void ZoneDatabase::ClearTradeskillRecipes()
+{
+	tradeskill_recipes.clear();
+	tradeskill_index.clear();
+	tradeskill_recipes_loaded = false;
+}
+
 bool ZoneDatabase::GetTradeRecipe(const ItemInst* container, uint8 c_type, uint32 some_id,
 	uint32 char_id, DBTradeskillRecipe_Struct *spec)
 {
 	if (container == nullptr)
 		return false;
 
-	std::string containers;// make where clause segment for container(s)
-	if (some_id == 0)
-		containers = StringFormat("= %u", c_type); // world combiner so no item number
-	else
-		containers = StringFormat("IN (%u,%u)", c_type, some_id); // container in inventory
-
-	//Could prolly watch for stacks in this loop and handle them properly...
-	//just increment sum and count accordingly
-	bool first = true;
-	std::string buf2;
-	uint32 count = 0;
-	uint32 sum = 0;
+	if (!tradeskill_recipes_loaded)
+		LoadTradeskillRecipes();
+
+	std::vector<uint32> components;
 	for (uint8 i = 0; i < 10; i++) { // <watch> TODO: need to determine if this is bound to world/item container size
 		const ItemInst* inst = container->GetItem(i);
 		if (!inst)
-            continue;
-
-        const Item_Struct* item = GetItem(inst->GetItem()->ID);
-        if (!item)
-            continue;
+			continue;
 
-        if(first) {
-            buf2 += StringFormat("%d", item->ID);
-            first = false;
-        } else
-            buf2 += StringFormat(",%d", item->ID);
+		const Item_Struct* item = GetItem(inst->GetItem()->ID);
+		if (!item)
+			continue;
 
-        sum += item->ID;
-        count++;
+		components.push_back(item->ID);
 	}
 
-	if(count == 0)
+	if(components.empty())
 		return false;	//no items == no recipe
 
-	std::string query = StringFormat("SELECT tre.recipe_id "
-                                    "FROM tradeskill_recipe_entries AS tre "
-                                    "INNER JOIN tradeskill_recipe AS tr ON (tre.recipe_id = tr.id) "
-                                    "WHERE tr.enabled AND (( tre.item_id IN(%s) AND tre.componentcount > 0) "
-                                    "OR ( tre.item_id %s AND tre.iscontainer=1 ))"
-                                    "GROUP BY tre.recipe_id HAVING sum(tre.componentcount) = %u "
-                                    "AND sum(tre.item_id * tre.componentcount) = %u",
-                                    buf2.c_str(), containers.c_str(), count, sum);
-    auto results = QueryDatabase(query);
-	if (!results.Success()) {
-		Log.Out(Logs::General, Logs::Error, "Error in GetTradeRecipe search, query: %s", query.c_str());
-		Log.Out(Logs::General, Logs::Error, "Error in GetTradeRecipe search, error: %s", results.ErrorMessage().c_str());
-		return false;
+	std::sort(components.begin(), components.end());
+
+	//recipes with exactly these components, more than one when they only differ by container
+	std::vector<uint32> matches;
+	auto range = tradeskill_index.equal_range(HashTradeskillComponents(components));
+	for (auto it = range.first; it != range.second; ++it) {
+		auto recipe = tradeskill_recipes.find(it->second);
+		if (recipe != tradeskill_recipes.end() && recipe->second.components == components)
+			matches.push_back(it->second);
 	}
 
-    if (results.RowCount() > 1) {
-        //multiple recipes, partial match... do an extra query to get it exact.
-        //this happens when combining components for a smaller recipe
-        //which is completely contained within another recipe
-        first = true;
-        uint32 index = 0;
-        buf2 = "";
-        for (auto row = results.begin(); row != results.end(); ++row, ++index) {
-            uint32 recipeid = (uint32)atoi(row[0]);
-            if(first) {
-                buf2 += StringFormat("%u", recipeid);
-                first = false;
-            } else
-                buf2 += StringFormat(",%u", recipeid);
-
-            //length limit on buf2
-            if(index == 214) { //Maximum number of recipe matches (19 * 215 = 4096)
-                Log.Out(Logs::General, Logs::Error, "GetTradeRecipe warning: Too many matches. Unable to search all recipe entries. Searched %u of %u possible entries.", index + 1, results.RowCount());
-                break;
-            }
-        }
-
-        query = StringFormat("SELECT tre.recipe_id "
-                            "FROM tradeskill_recipe_entries AS tre "
-                            "WHERE tre.recipe_id IN (%s) "
-                            "GROUP BY tre.recipe_id HAVING sum(tre.componentcount) = %u "
-                            "AND sum(tre.item_id * tre.componentcount) = %u", buf2.c_str(), count, sum);
-		results = QueryDatabase(query);
-        if (!results.Success()) {
-            Log.Out(Logs::General, Logs::Error, "Error in GetTradeRecipe, re-query: %s", query.c_str());
-            Log.Out(Logs::General, Logs::Error, "Error in GetTradeRecipe, error: %s", results.ErrorMessage().c_str());
-            return false;
-        }
-    }
-
-    if (results.RowCount() < 1)
-        return false;
-
-	if(results.RowCount() > 1) {
+	if (matches.empty())
+		return false;
+
+	std::sort(matches.begin(), matches.end());
+	uint32 recipe_id = matches[0];
+
+	if(matches.size() > 1) {
 		//The recipe is not unique, so we need to compare the container were using.
 		uint32 containerId = 0;
 
@@ -854,171 +902,66 @@ bool ZoneDatabase::GetTradeRecipe(const ItemInst* container, uint8 c_type, uint3
 		else //Invalid container
 			return false;
 
-		query = StringFormat("SELECT tre.recipe_id "
-                            "FROM tradeskill_recipe_entries AS tre "
-                            "WHERE tre.recipe_id IN (%s) "
-                            "AND tre.item_id = %u;", buf2.c_str(), containerId);
-        results = QueryDatabase(query);
-		if (!results.Success()) {
-			Log.Out(Logs::General, Logs::Error, "Error in GetTradeRecipe, re-query: %s", query.c_str());
-			Log.Out(Logs::General, Logs::Error, "Error in GetTradeRecipe, error: %s", results.ErrorMessage().c_str());
-			return false;
+		uint32 found = 0;
+		for (size_t i = 0; i < matches.size(); ++i) {
+			if (!HasRecipeEntry(tradeskill_recipes[matches[i]], containerId))
+				continue;
+			if (found++ == 0)
+				recipe_id = matches[i];
 		}
 
-		if(results.RowCount() == 0) { //Recipe contents matched more than 1 recipe, but not in this container
+		if(found == 0) { //Recipe contents matched more than 1 recipe, but not in this container
 			Log.Out(Logs::General, Logs::Error, "Combine error: Incorrect container is being used!");
 			return false;
 		}
 
-		if (results.RowCount() > 1) //Recipe contents matched more than 1 recipe in this container
-			Log.Out(Logs::General, Logs::Error, "Combine error: Recipe is not unique! %u matches found for container %u. Continuing with first recipe match.", results.RowCount(), containerId);
-
+		if (found > 1) //Recipe contents matched more than 1 recipe in this container
+			Log.Out(Logs::General, Logs::Error, "Combine error: Recipe is not unique! %u matches found for container %u. Continuing with first recipe match.", found, containerId);
 	}
 
-	auto row = results.begin();
-	uint32 recipe_id = (uint32)atoi(row[0]);
-
-	//Right here we verify that we actually have ALL of the tradeskill components..
-	//instead of part which is possible with experimentation.
-	//This is here because something's up with the query above.. it needs to be rethought out
-	bool has_components = true;
-	query = StringFormat("SELECT item_id, componentcount "
-                        "FROM tradeskill_recipe_entries "
-                        "WHERE recipe_id = %i AND componentcount > 0",
-                        recipe_id);
-	results = QueryDatabase(query);
-    if (!results.Success()) {
-        return GetTradeRecipe(recipe_id, c_type, some_id, char_id, spec);
-    }
-
-	if (results.RowCount() == 0)
-        return GetTradeRecipe(recipe_id, c_type, some_id, char_id, spec);
-
-	for (auto row = results.begin(); row != results.end(); ++row) {
-        int ccnt = 0;
-
-        for(int x = MAIN_BEGIN; x < EmuConstants::MAP_WORLD_SIZE; x++) {
-            const ItemInst* inst = container->GetItem(x);
-            if(!inst)
-                continue;
-
-            const Item_Struct* item = GetItem(inst->GetItem()->ID);
-            if (!item)
-                continue;
-
-            if(item->ID == atoi(row[0]))
-                ccnt++;
-        }
-
-        if(ccnt != atoi(row[1]))
-            return false;
-    }
-
 	return GetTradeRecipe(recipe_id, c_type, some_id, char_id, spec);
 }
 
 bool ZoneDatabase::GetTradeRecipe(uint32 recipe_id, uint8 c_type, uint32 some_id,
 	uint32 char_id, DBTradeskillRecipe_Struct *spec)
 {
+	if (!tradeskill_recipes_loaded)
+		LoadTradeskillRecipes();
 
-	// make where clause segment for container(s)
-	std::string containers;
-	if (some_id == 0)
-		containers = StringFormat("= %u", c_type); // world combiner so no item number
-	else
-		containers = StringFormat("IN (%u,%u)", c_type, some_id); // container in inventory
+	auto iter = tradeskill_recipes.find(recipe_id);
+	if (iter == tradeskill_recipes.end())
+		return false;//just not found i guess..
 
-	std::string query = StringFormat("SELECT tr.id, tr.tradeskill, tr.skillneeded, "
-                                    "tr.trivial, tr.nofail, tr.replace_container, "
-                                    "tr.name, tr.must_learn, tr.quest, crl.madecount "
-                                    "FROM tradeskill_recipe AS tr "
-                                    "INNER JOIN tradeskill_recipe_entries AS tre "
-                                    "ON tr.id = tre.recipe_id "
-                                    "LEFT JOIN (SELECT recipe_id, madecount "
-                                    "FROM char_recipe_list WHERE char_id = %u) AS crl "
-                                    "ON tr.id = crl.recipe_id "
-                                    "WHERE tr.id = %lu AND tre.item_id %s AND tr.enabled "
-                                    "GROUP BY tr.id",
-                                    char_id, (unsigned long)recipe_id, containers.c_str());
-    auto results = QueryDatabase(query);
+	// the recipe has to list the container being used
+	const TradeskillRecipe_Struct &recipe = iter->second;
+	if (!HasRecipeEntry(recipe, c_type) && (some_id == 0 || !HasRecipeEntry(recipe, some_id)))
+		return false;
+
+	if(recipe.spec.onsuccess.empty()) {
+		Log.Out(Logs::General, Logs::Error, "Error in GetTradeRecept success: no success items returned");
+		return false;
+	}
+
+	*spec = recipe.spec;
+
+	std::string query = StringFormat("SELECT madecount FROM char_recipe_list "
+                                    "WHERE char_id = %u AND recipe_id = %u", char_id, recipe_id);
+	auto results = QueryDatabase(query);
 	if (!results.Success()) {
 		Log.Out(Logs::General, Logs::Error, "Error in GetTradeRecipe, query: %s", query.c_str());
 		Log.Out(Logs::General, Logs::Error, "Error in GetTradeRecipe, error: %s", results.ErrorMessage().c_str());
 		return false;
 	}
 
-	if(results.RowCount() != 1)
-		return false;//just not found i guess..
-
-	auto row = results.begin();
-	spec->tradeskill = (SkillUseTypes)atoi(row[1]);
-	spec->skill_needed	= (int16)atoi(row[2]);
-	spec->trivial = (uint16)atoi(row[3]);
-	spec->nofail = atoi(row[4]) ? true : false;
-	spec->replace_container	= atoi(row[5]) ? true : false;
-	spec->name = row[6];
-	spec->must_learn = (uint8)atoi(row[7]);
-	spec->quest = atoi(row[8]) ? true : false;
-
-	if (row[9] == nullptr) {
+	if (results.RowCount() == 0) {
 		spec->has_learnt = false;
 		spec->madecount = 0;
 	} else {
+		auto row = results.begin();
 		spec->has_learnt = true;
-		spec->madecount = (uint32)atoul(row[9]);
-	}
-	spec->recipe_id = recipe_id;
-
-	//Pull the on-success items...
-	query = StringFormat("SELECT item_id,successcount FROM tradeskill_recipe_entries "
-                        "WHERE successcount > 0 AND recipe_id = %u", recipe_id);
-    results = QueryDatabase(query);
-	if (!results.Success()) {
-		return false;
-	}
-
-	if(results.RowCount() < 1) {
-		Log.Out(Logs::General, Logs::Error, "Error in GetTradeRecept success: no success items returned");
-		return false;
-	}
-
-	spec->onsuccess.clear();
-	for(auto row = results.begin(); row != results.end(); ++row) {
-		uint32 item = (uint32)atoi(row[0]);
-		uint8 num = (uint8) atoi(row[1]);
-		spec->onsuccess.push_back(std::pair<uint32,uint8>(item, num));
+		spec->madecount = (uint32)atoul(row[0]);
 	}
 
-    spec->onfail.clear();
-	//Pull the on-fail items...
-	query = StringFormat("SELECT item_id, failcount FROM tradeskill_recipe_entries "
-                        "WHERE failcount > 0 AND recipe_id = %u", recipe_id);
-	results = QueryDatabase(query);
-	if (results.Success())
-		for(auto row = results.begin(); row != results.end(); ++row) {
-			uint32 item = (uint32)atoi(row[0]);
-			uint8 num = (uint8) atoi(row[1]);
-			spec->onfail.push_back(std::pair<uint32,uint8>(item, num));
-		}
-
-    spec->salvage.clear();
-
-    // Don't bother with the query if TS is nofail
-    if (spec->nofail)
-        return true;
-
-	// Pull the salvage list
-	query = StringFormat("SELECT item_id, salvagecount "
-                        "FROM tradeskill_recipe_entries "
-                        "WHERE salvagecount > 0 AND recipe_id = %u", recipe_id);
-    results = QueryDatabase(query);
-	if (results.Success())
-		for(auto row = results.begin(); row != results.begin(); ++row) {
-			uint32 item = (uint32)atoi(row[0]);
-			uint8 num = (uint8)atoi(row[1]);
-			spec->salvage.push_back(std::pair<uint32,uint8>(item, num));
-		}
-
 	return true;
 }
 
@@ -1112,6 +1055,7 @@ bool ZoneDatabase::EnableRecipe(uint32 recipe_id)
 	std::string query = StringFormat("UPDATE tradeskill_recipe SET enabled = 1 "
                                     "WHERE id = %u;", recipe_id);
     auto results = QueryDatabase(query);
+	ClearTradeskillRecipes();
 	if (!results.Success())
 
 	return results.RowsAffected() > 0;
@@ -1122,6 +1066,7 @@ bool ZoneDatabase::DisableRecipe(uint32 recipe_id)
 	std::string query = StringFormat("UPDATE tradeskill_recipe SET enabled = 0 "
                                     "WHERE id = %u;", recipe_id);
     auto results = QueryDatabase(query);
+	ClearTradeskillRecipes();
 	if (!results.Success())
 
 	return results.RowsAffected() > 0;
@@ -1629,215 +1629,54 @@ void Client::BuyTraderItem(TraderBuy_Struct* tbs,Client* Trader,const EQApplicat
 
 void Client::SendBazaarWelcome()
 {
-	const std::string query = "SELECT COUNT(DISTINCT char_id), count(char_id) FROM trader";
-	auto results = database.QueryDatabase(query);
-	if (results.Success() && results.RowCount() == 1){
-		auto row = results.begin();
-
-		EQApplicationPacket* outapp = new EQApplicationPacket(OP_BazaarSearch, sizeof(BazaarWelcome_Struct));
-		memset(outapp->pBuffer,0,outapp->size);
-		BazaarWelcome_Struct* bws = (BazaarWelcome_Struct*)outapp->pBuffer;
-		bws->Beginning.Action = BazaarWelcome;
-		bws->Traders = atoi(row[0]);
-		bws->Items = atoi(row[1]);
+	const BazaarIndex& bazaar = database.GetBazaarIndex();
 
-		QueuePacket(outapp);
-		safe_delete(outapp);
-	}
+	EQApplicationPacket* outapp = new EQApplicationPacket(OP_BazaarSearch, sizeof(BazaarWelcome_Struct));
+	memset(outapp->pBuffer,0,outapp->size);
+	BazaarWelcome_Struct* bws = (BazaarWelcome_Struct*)outapp->pBuffer;
+	bws->Beginning.Action = BazaarWelcome;
+	bws->Traders = bazaar.GetTraderCount();
+	bws->Items = bazaar.GetCount();
+
+	QueuePacket(outapp);
+	safe_delete(outapp);
 }
 
 void Client::SendBazaarResults(uint32 TraderID, uint32 Class_, uint32 Race, uint32 ItemStat, uint32 Slot, uint32 Type,
 					char Name[64], uint32 MinPrice, uint32 MaxPrice) {
 
-	std::string searchValues = " COUNT(item_id), trader.char_id, trader.item_id, trader.item_cost, items.name ";
-	std::string searchCriteria = " WHERE trader.item_id = items.id ";
+	BazaarIndex::Filter filter;
+	filter.char_id = 0;
+	filter.class_ = Class_;
+	filter.race = Race;
+	filter.slot = Slot;
+	filter.type = Type;
+	filter.stat = ItemStat;
+	filter.min_price = MinPrice;
+	filter.max_price = MaxPrice;
+	filter.name = Name;
 
 	if(TraderID > 0) {
 		Client* trader = entity_list.GetClientByID(TraderID);
 
 		if(trader)
-			searchCriteria.append(StringFormat(" AND trader.char_id = %i", trader->CharacterID()));
-	}
-
-	if(MinPrice != 0)
-		searchCriteria.append(StringFormat(" AND trader.item_cost >= %i", MinPrice));
-
-	if(MaxPrice != 0)
-		searchCriteria.append(StringFormat(" AND trader.item_cost <= %i", MaxPrice));
-
-	if(strlen(Name) > 0) {
-		char *safeName = RemoveApostrophes(Name);
-		searchCriteria.append(StringFormat(" AND items.name LIKE '%%%s%%'", safeName));
-		safe_delete_array(safeName);
-	}
-
-	if(Class_ != 0xFFFF)
-		searchCriteria.append(StringFormat(" AND MID(REVERSE(BIN(items.classes)), %i, 1) = 1", Class_));
-
-	if(Race != 0xFFFF)
-		searchCriteria.append(StringFormat(" AND MID(REVERSE(BIN(items.races)), %i, 1) = 1", Race));
-
-	if(Slot != 0xFFFF)
-		searchCriteria.append(StringFormat(" AND MID(REVERSE(BIN(items.slots)), %i, 1) = 1", Slot + 1));
-
-	switch(Type){
-        case 0xFFFF:
-            break;
-        case 0:
-            // 1H Slashing
-            searchCriteria.append(" AND items.itemtype = 0 AND damage > 0");
-            break;
-        case 31:
-            searchCriteria.append(" AND items.itemclass = 2");
-            break;
-        case 46:
-            searchCriteria.append(" AND items.spellid > 0 AND items.spellid < 65000");
-            break;
-        case 47:
-            searchCriteria.append(" AND items.spellid = 998");
-            break;
-        case 48:
-            searchCriteria.append(" AND items.spellid >= 1298 AND items.spellid <= 1307");
-            break;
-        case 49:
-            searchCriteria.append(" AND items.focuseffect > 0");
-            break;
-
-        default:
-            searchCriteria.append(StringFormat(" AND items.itemtype = %i", Type));
-    }
-
-	switch(ItemStat) {
-
-		case STAT_AC:
-			searchCriteria.append(" AND items.ac > 0");
-			searchValues.append(", items.ac");
-			break;
-
-		case STAT_AGI:
-			searchCriteria.append(" AND items.aagi > 0");
-			searchValues.append(", items.aagi");
-			break;
-
-		case STAT_CHA:
-			searchCriteria.append(" AND items.acha > 0");
-			searchValues.append(", items.acha");
-			break;
-
-		case STAT_DEX:
-			searchCriteria.append(" AND items.adex > 0");
-			searchValues.append(", items.adex");
-			break;
-
-		case STAT_INT:
-			searchCriteria.append(" AND items.aint > 0");
-			searchValues.append(", items.aint");
-			break;
-
-		case STAT_STA:
-			searchCriteria.append(" AND items.asta > 0");
-			searchValues.append(", items.asta");
-			break;
-
-		case STAT_STR:
-			searchCriteria.append(" AND items.astr > 0");
-			searchValues.append(", items.astr");
-			break;
-
-		case STAT_WIS:
-			searchCriteria.append(" AND items.awis > 0");
-			searchValues.append(", items.awis");
-			break;
-
-		case STAT_COLD:
-			searchCriteria.append(" AND items.cr > 0");
-			searchValues.append(", items.cr");
-			break;
-
-		case STAT_DISEASE:
-			searchCriteria.append(" AND items.dr > 0");
-			searchValues.append(", items.dr");
-			break;
-
-		case STAT_FIRE:
-			searchCriteria.append(" AND items.fr > 0");
-			searchValues.append(", items.fr");
-			break;
-
-		case STAT_MAGIC:
-            searchCriteria.append(" AND items.mr > 0");
-			searchValues.append(", items.mr");
-			break;
-
-		case STAT_POISON:
-			searchCriteria.append(" AND items.pr > 0");
-			searchValues.append(", items.pr");
-			break;
-
-		case STAT_HP:
-			searchCriteria.append(" AND items.hp > 0");
-			searchValues.append(", items.hp");
-			break;
-
-		case STAT_MANA:
-			searchCriteria.append(" AND items.mana > 0");
-			searchValues.append(", items.mana");
-			break;
-
-		case STAT_ENDURANCE:
-			searchCriteria.append(" AND items.endur > 0");
-			searchValues.append(", items.endur");
-			break;
-
-		case STAT_ATTACK:
-			searchCriteria.append(" AND items.attack > 0");
-			searchValues.append(", items.attack");
-			break;
-
-		case STAT_HP_REGEN:
-			searchCriteria.append(" AND items.regen > 0");
-			searchValues.append(", items.regen");
-			break;
-
-		case STAT_MANA_REGEN:
-			searchCriteria.append(" AND items.manaregen > 0");
-			searchValues.append(", items.manaregen");
-			break;
-
-		case STAT_HASTE:
-			searchCriteria.append(" AND items.haste > 0");
-			searchValues.append(", items.haste");
-			break;
-
-		case STAT_DAMAGE_SHIELD:
-			searchCriteria.append(" AND items.damageshield > 0");
-			searchValues.append(", items.damageshield");
-			break;
-
-		default:
-			searchValues.append(", 0");
-			break;
+			filter.char_id = trader->CharacterID();
 	}
 
-    std::string query = StringFormat("SELECT %s, SUM(charges), items.stackable "
-                                    "FROM trader, items %s GROUP BY items.id, charges, char_id LIMIT %i",
-                                    searchValues.c_str(), searchCriteria.c_str(), RuleI(Bazaar, MaxSearchResults));
-    auto results = database.QueryDatabase(query);
-	Log.Out(Logs::Detail, Logs:: Bazaar, "Query was: SELECT %s, SUM(charges), items.stackable FROM trader, items %s GROUP BY items.id, charges, char_id LIMIT %i", searchValues.c_str(), searchCriteria.c_str(), RuleI(Bazaar, MaxSearchResults));
-    if (!results.Success()) {
-		return;
-    }
+	std::vector<BazaarIndex::Result> results;
+	database.GetBazaarIndex().Search(filter, RuleI(Bazaar, MaxSearchResults), results);
 
-    Log.Out(Logs::Detail, Logs::Trading, "SRCH: %s", query.c_str());
+	Log.Out(Logs::Detail, Logs::Trading, "SRCH: trader %u class %u race %u slot %u type %u stat %u price %u-%u name '%s', %u results",
+		filter.char_id, Class_, Race, Slot, Type, ItemStat, MinPrice, MaxPrice, Name, (uint32)results.size());
 
     int Size = 0;
     uint32 ID = 0;
 
-    if (results.RowCount() == static_cast<unsigned long>(RuleI(Bazaar, MaxSearchResults)))
+    if (results.size() == static_cast<size_t>(RuleI(Bazaar, MaxSearchResults)))
 			Message(CC_Yellow, "Your search reached the limit of %i results. Please narrow your search down by selecting more options.",
 					RuleI(Bazaar, MaxSearchResults));
 
-    if(results.RowCount() == 0) {
+    if(results.empty()) {
 		EQApplicationPacket* outapp2 = new EQApplicationPacket(OP_BazaarSearch, sizeof(BazaarReturnDone_Struct));
 		BazaarReturnDone_Struct* brds = (BazaarReturnDone_Struct*)outapp2->pBuffer;
 		brds->TraderID = ID;
@@ -1859,20 +1698,20 @@ void Client::SendBazaarResults(uint32 TraderID, uint32 Class_, uint32 Race, uint
 		memset(buffer, 0, Size);
 
 		bsrs->Action = BazaarSearchResults;
-		bsrs->NumItems = atoi(row[0]);
-		Client* Trader2=entity_list.GetClientByCharID(atoi(row[1]));
+		bsrs->NumItems = row->count;
+		Client* Trader2=entity_list.GetClientByCharID(row->char_id);
 		if(Trader2)
 		{
 			bsrs->SellerID = Trader2->GetID();
 		}
 		else
 		{
-			Log.Out(Logs::Detail, Logs::Bazaar, "Unable to find trader: %i\n",atoi(row[1]));
+			Log.Out(Logs::Detail, Logs::Bazaar, "Unable to find trader: %i\n",row->char_id);
 		}
 
-		bsrs->ItemID = atoi(row[2]);
-		bsrs->Cost = atoul(row[3]);
-		memcpy(bsrs->ItemName, row[4], strlen(row[4]));
+		bsrs->ItemID = row->item_id;
+		bsrs->Cost = row->cost;
+		strn0cpy(bsrs->ItemName, row->item->Name, sizeof(bsrs->ItemName));
 
 		Log.Out(Logs::Detail, Logs:: Bazaar, "Adding item: %s (%d) with cost: %d to results.", bsrs->ItemName, bsrs->ItemID, bsrs->Cost);
 		EQApplicationPacket* outapp = new EQApplicationPacket(OP_BazaarSearch, Size);
@@ -1,16 +1,43 @@
 #include "water_map_v2.h"
 
+#include <algorithm>
+#include <cmath>
+
+#define WATERMAP_GRID_MAX_CELLS 128	//per side
+#define WATERMAP_GRID_MIN_CELL_SIZE 16.0f
+
 WaterMapV2::WaterMapV2() {
+	grid_min = glm::vec2(0.0f, 0.0f);
+	grid_cell_size = WATERMAP_GRID_MIN_CELL_SIZE;
+	grid_width = 0;
+	grid_height = 0;
 }
 
 WaterMapV2::~WaterMapV2() {
 }
 
 WaterRegionType WaterMapV2::ReturnRegionType(const glm::vec3& location) const {
-	size_t sz = regions.size();
-	for(size_t i = 0; i < sz; ++i) {
-		auto const &region = regions[i];
-		if (region.second.ContainsPoint(glm::vec3(location.y, location.x, location.z))) {
+	glm::vec3 point(location.y, location.x, location.z);
+
+	//written so a NaN falls out as well
+	if (!(point.x >= grid_min.x && point.y >= grid_min.y))
+		return RegionTypeNormal;
+
+	int cell_x = static_cast<int>((point.x - grid_min.x) / grid_cell_size);
+	int cell_y = static_cast<int>((point.y - grid_min.y) / grid_cell_size);
+	if (cell_x >= grid_width || cell_y >= grid_height)
+		return RegionTypeNormal;
+
+	int cell = cell_y * grid_width + cell_x;
+	for (uint32 i = grid_cells[cell]; i < grid_cells[cell + 1]; ++i) {
+		uint32 index = grid_regions[i];
+		const RegionBounds &b = bounds[index];
+		if (point.x < b.min.x || point.x > b.max.x || point.y < b.min.y || point.y > b.max.y ||
+			point.z < b.min.z || point.z > b.max.z)
+			continue;
+
+		auto const &region = regions[index];
+		if (region.second.ContainsPoint(point)) {
 			return region.first;
 		}
 	}
@@ -30,7 +57,87 @@ bool WaterMapV2::InLava(const glm::vec3& location) const {
 }
 
 bool WaterMapV2::InLiquid(const glm::vec3& location) const {
-	return InWater(location) || InLava(location);
+	WaterRegionType type = ReturnRegionType(location);
+	return type == RegionTypeWater || type == RegionTypeLava;
+}
+
+//a degenerate box has no inverse and never contains anything, keep it out of the grid
+static bool IsUsable(const glm::vec3 &min, const glm::vec3 &max) {
+	return std::isfinite(min.x) && std::isfinite(min.y) && std::isfinite(min.z) &&
+		std::isfinite(max.x) && std::isfinite(max.y) && std::isfinite(max.z);
+}
+
+void WaterMapV2::BuildGrid() {
+	grid_width = 0;
+	grid_height = 0;
+	grid_cells.clear();
+	grid_regions.clear();
+	bounds.resize(regions.size());
+	if (regions.empty())
+		return;
+
+	//padded a little, the bounds come from the forward transform and ContainsPoint uses the inverse
+	glm::vec2 grid_max;
+	bool have_bounds = false;
+	for (size_t i = 0; i < regions.size(); ++i) {
+		RegionBounds &b = bounds[i];
+		regions[i].second.GetBounds(b.min, b.max);
+		b.min -= glm::vec3(1.0f);
+		b.max += glm::vec3(1.0f);
+		if (!IsUsable(b.min, b.max))
+			continue;
+
+		if (!have_bounds) {
+			grid_min = glm::vec2(b.min.x, b.min.y);
+			grid_max = glm::vec2(b.max.x, b.max.y);
+			have_bounds = true;
+			continue;
+		}
+		grid_min.x = std::min(grid_min.x, b.min.x);
+		grid_min.y = std::min(grid_min.y, b.min.y);
+		grid_max.x = std::max(grid_max.x, b.max.x);
+		grid_max.y = std::max(grid_max.y, b.max.y);
+	}
+
+	if (!have_bounds)
+		return;
+
+	float span = std::max(grid_max.x - grid_min.x, grid_max.y - grid_min.y);
+	grid_cell_size = std::max(span / WATERMAP_GRID_MAX_CELLS, WATERMAP_GRID_MIN_CELL_SIZE);
+	grid_width = static_cast<int>((grid_max.x - grid_min.x) / grid_cell_size) + 1;
+	grid_height = static_cast<int>((grid_max.y - grid_min.y) / grid_cell_size) + 1;
+
+	//count, then fill, so every cell's list is one slice of grid_regions
+	std::vector<uint32> counts(grid_width * grid_height, 0);
+	for (int pass = 0; pass < 2; ++pass) {
+		for (size_t i = 0; i < regions.size(); ++i) {
+			if (!IsUsable(bounds[i].min, bounds[i].max))
+				continue;
+
+			int x0 = static_cast<int>((bounds[i].min.x - grid_min.x) / grid_cell_size);
+			int y0 = static_cast<int>((bounds[i].min.y - grid_min.y) / grid_cell_size);
+			int x1 = std::min(static_cast<int>((bounds[i].max.x - grid_min.x) / grid_cell_size), grid_width - 1);
+			int y1 = std::min(static_cast<int>((bounds[i].max.y - grid_min.y) / grid_cell_size), grid_height - 1);
+			for (int y = std::max(y0, 0); y <= y1; ++y) {
+				for (int x = std::max(x0, 0); x <= x1; ++x) {
+					int cell = y * grid_width + x;
+					if (pass == 0)
+						counts[cell]++;
+					else
+						grid_regions[grid_cells[cell] + counts[cell]++] = static_cast<uint32>(i);
+				}
+			}
+		}
+
+		if (pass == 0) {
+			grid_cells.resize(counts.size() + 1);
+			grid_cells[0] = 0;
+			for (size_t c = 0; c < counts.size(); ++c)
+				grid_cells[c + 1] = grid_cells[c] + counts[c];
+			grid_regions.resize(grid_cells.back());
+			std::fill(counts.begin(), counts.end(), 0);
+		}
+	}
 }
 
 bool WaterMapV2::Load(FILE *fp) {
@@ -110,5 +217,6 @@ bool WaterMapV2::Load(FILE *fp) {
 			OrientedBoundingBox(glm::vec3(x, y, z), glm::vec3(x_rot, y_rot, z_rot), glm::vec3(x_scale, y_scale, z_scale), glm::vec3(x_extent, y_extent, z_extent))));
 	}
 
+	BuildGrid();
 	return true;
 }
@@ -3,6 +3,7 @@
 
 #include "water_map.h"
 #include "oriented_bounding_box.h"
+#include <glm/vec2.hpp>
 #include <vector>
 #include <utility>
 
@@ -20,8 +21,24 @@ public:
 
 protected:
 	virtual bool Load(FILE *fp);
+	void BuildGrid();
 
 	std::vector<std::pair<WaterRegionType, OrientedBoundingBox>> regions;
+
+	// Uniform grid over the region bounds on the x/y plane of box space (x and y
+	// swapped from zone coordinates). A cell lists every region whose bounds touch
+	// it, in load order, so the first hit is the same region the full scan finds.
+	struct RegionBounds {
+		glm::vec3 min;
+		glm::vec3 max;
+	};
+	std::vector<RegionBounds> bounds;
+	glm::vec2 grid_min;
+	float grid_cell_size;
+	int grid_width;
+	int grid_height;
+	std::vector<uint32> grid_cells;		// cell c lists grid_regions[grid_cells[c]] up to grid_cells[c + 1]
+	std::vector<uint32> grid_regions;
 	friend class WaterMap;
 };
 
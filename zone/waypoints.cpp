@@ -634,7 +634,7 @@ bool Mob::MakeNewPositionAndSendUpdate(float x, float y, float z, float speed, b
 		if(!NPCFlyMode && !IsBoat() && checkZ && zone->HasMap() && RuleB(Map, FixPathingZWhenMoving))
 		{
 			if(!RuleB(Watermap, CheckForWaterWhenMoving) || !zone->HasWaterMap() ||
-			   (zone->HasWaterMap() && !zone->watermap->InWater(glm::vec3(m_Position))))
+			   (zone->HasWaterMap() && GetRegionType() != RegionTypeWater))
 			{
 				glm::vec3 dest(m_Position.x, m_Position.y, m_Position.z);
 
@@ -764,7 +764,7 @@ bool Mob::MakeNewPositionAndSendUpdate(float x, float y, float z, float speed, b
 	if(!NPCFlyMode && !IsBoat() && checkZ && zone->HasMap() && RuleB(Map, FixPathingZWhenMoving)) {
 
 		if(!RuleB(Watermap, CheckForWaterWhenMoving) || !zone->HasWaterMap() ||
-		   (zone->HasWaterMap() && !zone->watermap->InWater(glm::vec3(m_Position))))
+		   (zone->HasWaterMap() && GetRegionType() != RegionTypeWater))
 		{
 			glm::vec3 dest(m_Position.x, m_Position.y, m_Position.z);
 
@@ -917,7 +917,7 @@ bool Mob::CalculateNewPosition(float x, float y, float z, float speed, bool chec
 	if(!NPCFlyMode && !IsBoat() && checkZ && zone->HasMap() && RuleB(Map, FixPathingZWhenMoving))
 	{
 		if(!RuleB(Watermap, CheckForWaterWhenMoving) || !zone->HasWaterMap() ||
-			(zone->HasWaterMap() && !zone->watermap->InWater(glm::vec3(m_Position))))
+			(zone->HasWaterMap() && GetRegionType() != RegionTypeWater))
 		{
 			glm::vec3 dest(m_Position.x, m_Position.y, m_Position.z);
 
@@ -1068,7 +1068,7 @@ void Mob::SendTo(float new_x, float new_y, float new_z) {
 	if(zone->HasMap() && RuleB(Map, FixPathingZOnSendTo) && !IsBoat())
 	{
 		if(!RuleB(Watermap, CheckForWaterOnSendTo) || !zone->HasWaterMap() ||
-			(zone->HasWaterMap() && !zone->watermap->InWater(glm::vec3(m_Position))))
+			(zone->HasWaterMap() && GetRegionType() != RegionTypeWater))
 		{
 			glm::vec3 dest(m_Position.x, m_Position.y, m_Position.z);
 
@@ -1102,7 +1102,7 @@ void Mob::SendToFixZ(float new_x, float new_y, float new_z) {
 	if(zone->HasMap() && RuleB(Map, FixPathingZOnSendTo) && !IsBoat())
 	{
 		if(!RuleB(Watermap, CheckForWaterOnSendTo) || !zone->HasWaterMap() ||
-			(zone->HasWaterMap() && !zone->watermap->InWater(glm::vec3(m_Position))))
+			(zone->HasWaterMap() && GetRegionType() != RegionTypeWater))
 		{
 			glm::vec3 dest(m_Position.x, m_Position.y, m_Position.z);
 
@@ -0,0 +1,121 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "../common/global_define.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool()
+:	stopping(false),
+	generation(0),
+	busy(0),
+	job(nullptr),
+	job_count(0),
+	job_chunk(1),
+	next(0)
+{
+}
+
+WorkerPool::~WorkerPool() {
+	SetThreads(0);
+}
+
+void WorkerPool::SetThreads(uint32 count) {
+	if (count == threads.size())
+		return;
+
+	if (!threads.empty()) {
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (size_t i = 0; i < threads.size(); ++i)
+			threads[i].join();
+		threads.clear();
+		stopping = false;
+	}
+
+	//a thread that only reaches the lock after the next Run() must still see that job as new
+	uint64 seen;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		seen = generation;
+	}
+	for (uint32 i = 0; i < count; ++i)
+		threads.push_back(std::thread(&WorkerPool::Worker, this, seen));
+}
+
+void WorkerPool::Run(uint32 count, uint32 chunk, const std::function<void(uint32)> &fn) {
+	if (chunk < 1)
+		chunk = 1;
+
+	//not worth waking anybody for
+	if (threads.empty() || count <= chunk) {
+		for (uint32 i = 0; i < count; ++i)
+			fn(i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		job = &fn;
+		job_count = count;
+		job_chunk = chunk;
+		next = 0;
+		busy = threads.size();
+		generation++;
+	}
+	wake.notify_all();
+
+	Work();
+
+	std::unique_lock<std::mutex> guard(lock);
+	done.wait(guard, [this] { return busy == 0; });
+	job = nullptr;
+}
+
+void WorkerPool::Work() {
+	while (true) {
+		uint32 start = next.fetch_add(job_chunk);
+		if (start >= job_count)
+			return;
+
+		uint32 end = std::min(start + job_chunk, job_count);
+		for (uint32 i = start; i < end; ++i)
+			(*job)(i);
+	}
+}
+
+void WorkerPool::Worker(uint64 seen) {
+	std::unique_lock<std::mutex> guard(lock);
+	while (true) {
+		wake.wait(guard, [&] { return stopping || generation != seen; });
+		if (stopping)
+			return;
+		seen = generation;
+
+		guard.unlock();
+		Work();
+		guard.lock();
+
+		if (--busy == 0)
+			done.notify_one();
+	}
+}
@@ -0,0 +1,70 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+/*
+	Threads that run one parallel loop at a time for the main thread.
+
+	Run() hands out the indexes in chunks from a shared counter, so a thread
+	that finishes early keeps taking chunks the others haven't reached, and
+	the calling thread works through chunks alongside them. It returns once
+	every index is done. The function is called from several threads at once
+	and must only write to what belongs to its own index.
+*/
+
+#include "../common/types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool
+{
+public:
+	WorkerPool();
+	~WorkerPool();
+
+	//threads besides the caller, 0 runs everything on the caller. only between Run()s
+	void	SetThreads(uint32 count);
+	inline uint32	GetThreads() const	{ return threads.size(); }
+
+	void	Run(uint32 count, uint32 chunk, const std::function<void(uint32)> &fn);
+
+private:
+	void	Worker(uint64 seen);
+	void	Work();
+
+	std::vector<std::thread>	threads;
+	std::mutex	lock;
+	std::condition_variable	wake;
+	std::condition_variable	done;
+	bool	stopping;
+	uint64	generation;	//bumped for every job, workers wait for it to change
+	uint32	busy;	//workers still inside the current job
+
+	const std::function<void(uint32)>	*job;
+	uint32	job_count;
+	uint32	job_chunk;
+	std::atomic<uint32>	next;
+};
+
+#endif
@@ -974,7 +974,7 @@ void WorldServer::Process() {
 
 				Raid *r = entity_list.GetRaidByID(rga->rid);
 				if(r){
-					r->LearnMembers();
+					r->ApplyMemberUpdate(rga);
 					r->VerifyRaid();
 					r->SendRaidAddAll(rga->playername);
 				}
@@ -995,7 +995,7 @@ void WorldServer::Process() {
 					if(rem){
 						r->SendRaidDisband(rem);
 					}
-					r->LearnMembers();
+					r->ApplyMemberRemove(rga->playername);
 					r->VerifyRaid();
 				}
 			}
@@ -1011,7 +1011,7 @@ void WorldServer::Process() {
 				Raid *r = entity_list.GetRaidByID(rga->rid);
 				if(r){
 					r->SendRaidDisbandAll();
-					r->LearnMembers();
+					r->ApplyDisband();
 					r->VerifyRaid();
 				}
 			}
@@ -1044,7 +1044,7 @@ void WorldServer::Process() {
 
 				Raid *r = entity_list.GetRaidByID(rga->rid);
 				if(r){
-					r->LearnMembers();
+					r->ApplyMemberUpdate(rga);
 					r->VerifyRaid();
 					Client *c = entity_list.GetClientByName(rga->playername);
 					if(c){
@@ -1084,6 +1084,11 @@ void WorldServer::Process() {
 			if(zone){
 				if(rga->zoneid == zone->GetZoneID() && rga->instance_id == zone->GetInstanceID())
 					break;
+
+				Raid *r = entity_list.GetRaidByID(rga->rid);
+				if(r){
+					r->ApplyMemberUpdate(rga);
+				}
 			}
 			break;
 		}
@@ -1101,7 +1106,7 @@ void WorldServer::Process() {
 					if(c){
 						r->SetLeader(c);
 					}
-					r->LearnMembers();
+					r->ApplyRaidLeader(rga->playername);
 					r->VerifyRaid();
 					r->SendMakeLeaderPacket(rga->playername);
 				}
@@ -1118,7 +1123,8 @@ void WorldServer::Process() {
 				Raid *r = entity_list.GetRaidByID(rga->rid);
 				if(r){
 					r->GetRaidDetails();
-					r->LearnMembers();
+					if(rga->playername[0])
+						r->ApplyMemberUpdate(rga);
 					r->VerifyRaid();
 				}
 			}
@@ -1150,7 +1156,6 @@ void WorldServer::Process() {
 			if(zone){
 				Raid *r = entity_list.GetRaidByID(rga->rid);
 				if(r){
-					r->LearnMembers();
 					r->VerifyRaid();
 					EQApplicationPacket* outapp = new EQApplicationPacket(OP_GroupUpdate, sizeof(GroupJoin_Struct));
 					GroupJoin_Struct* gj = (GroupJoin_Struct*) outapp->pBuffer;
@@ -1181,7 +1186,6 @@ void WorldServer::Process() {
 			if(zone){
 				Raid *r = entity_list.GetRaidByID(rga->rid);
 				if(r){
-					r->LearnMembers();
 					r->VerifyRaid();
 					EQApplicationPacket* outapp = new EQApplicationPacket(OP_GroupUpdate, sizeof(GroupJoin_Struct));
 					GroupJoin_Struct* gj = (GroupJoin_Struct*) outapp->pBuffer;
@@ -1619,6 +1623,11 @@ void WorldServer::Process() {
 				Log.Out(Logs::General, Logs::Error, "Loading npcs faction lists FAILED!");
 			}
 
+			Log.Out(Logs::General, Logs::Zone_Server, "Loading npc types");
+			if(!database.LoadNPCTypes(hotfix_name)) {
+				Log.Out(Logs::General, Logs::Error, "Loading npc types FAILED!");
+			}
+
 			Log.Out(Logs::General, Logs::Zone_Server, "Loading loot tables");
 			if(!database.LoadLoot(hotfix_name)) {
 				Log.Out(Logs::General, Logs::Error, "Loading loot FAILED!");
@@ -37,6 +37,7 @@
 #include "../common/string_util.h"
 #include "../common/eqemu_logsys.h"
 
+#include "corpse.h"
 #include "guild_mgr.h"
 #include "map.h"
 #include "net.h"
@@ -304,11 +305,11 @@ bool Zone::LoadGroundSpawns() {
 
 int Zone::SaveTempItem(uint32 merchantid, uint32 npcid, uint32 item, int32 charges, bool sold) {
 	int freeslot = 0;
-	std::list<MerchantList> merlist = merchanttable[merchantid];
-	std::list<MerchantList>::const_iterator itr;
+	std::vector<MerchantList> &merlist = merchanttable[merchantid];
+	std::vector<MerchantList>::const_iterator itr;
 	uint32 i = 1;
 	for (itr = merlist.begin(); itr != merlist.end(); ++itr) {
-		MerchantList ml = *itr;
+		const MerchantList &ml = *itr;
 		if (ml.item == item && ml.quantity <= 0)
 			return 0;
 
@@ -316,8 +317,8 @@ int Zone::SaveTempItem(uint32 merchantid, uint32 npcid, uint32 item, int32 charg
 		if (ml.slot >= i)
 			i = ml.slot + 1;
 	}
-	std::list<TempMerchantList> tmp_merlist = tmpmerchanttable[npcid];
-	std::list<TempMerchantList>::const_iterator tmp_itr;
+	std::vector<TempMerchantList> &tmp_merlist = tmpmerchanttable[npcid];
+	std::vector<TempMerchantList>::const_iterator tmp_itr;
 	bool update_charges = false;
 	TempMerchantList ml;
 	while (freeslot == 0 && !update_charges) {
@@ -337,52 +338,49 @@ int Zone::SaveTempItem(uint32 merchantid, uint32 npcid, uint32 item, int32 charg
 	}
 	if (update_charges)
 	{
-		tmp_merlist.clear();
-		std::list<TempMerchantList> oldtmp_merlist = tmpmerchanttable[npcid];
-		for (tmp_itr = oldtmp_merlist.begin(); tmp_itr != oldtmp_merlist.end(); ++tmp_itr) 
+		size_t index = 0;
+		while (index < tmp_merlist.size())
 		{
-			TempMerchantList ml2 = *tmp_itr;
-			if(ml2.item != item)
+			if(tmp_merlist[index].item != item)
 			{
-				//Push the items not affected back into the list. 
-				tmp_merlist.push_back(ml2);
+				//Leave the items not affected where they are.
+				++index;
+				continue;
 			}
-			else 
+
+			if (sold)
 			{
-				if (sold)
+				if(database.ItemQuantityType(item) != Quantity_Stacked)
 				{
-					if(database.ItemQuantityType(item) != Quantity_Stacked)
-					{
-						++ml.quantity;
-					}
-					ml.charges = ml.charges + charges;
+					++ml.quantity;
 				}
-				else
+				ml.charges = ml.charges + charges;
+			}
+			else
+			{
+				if(database.ItemQuantityType(item) != Quantity_Stacked)
 				{
-					if(database.ItemQuantityType(item) != Quantity_Stacked)
-					{
-						--ml.quantity;
-					}
-					ml.charges = charges;
+					--ml.quantity;
 				}
+				ml.charges = charges;
+			}
 
-				if (!ml.origslot)
-					ml.origslot = ml.slot;
+			if (!ml.origslot)
+				ml.origslot = ml.slot;
 
-				if ((database.ItemQuantityType(item) != Quantity_Stacked && ml.quantity > 0) || charges > 0) //This is a save
-				{
-					database.SaveMerchantTemp(npcid, ml.origslot, item, ml.charges, ml.quantity);
-					tmp_merlist.push_back(ml);
-					Log.Out(Logs::General, Logs::Trading, "%d SAVED to temp in slot %d with charges/qty %d/%d", item, ml.origslot, ml.charges, ml.quantity);
-				}
-				else //This is a delete
-				{
-					database.DeleteMerchantTemp(npcid, ml.origslot);
-					Log.Out(Logs::General, Logs::Trading, "%d DELETED from temp in slot %d", item, ml.origslot);
-				}
+			if ((database.ItemQuantityType(item) != Quantity_Stacked && ml.quantity > 0) || charges > 0) //This is a save
+			{
+				SaveMerchantTemp(npcid, ml.origslot, item, ml.charges, ml.quantity);
+				tmp_merlist[index++] = ml;
+				Log.Out(Logs::General, Logs::Trading, "%d SAVED to temp in slot %d with charges/qty %d/%d", item, ml.origslot, ml.charges, ml.quantity);
+			}
+			else //This is a delete
+			{
+				DeleteMerchantTemp(npcid, ml.origslot);
+				tmp_merlist.erase(tmp_merlist.begin() + index);
+				Log.Out(Logs::General, Logs::Trading, "%d DELETED from temp in slot %d", item, ml.origslot);
 			}
 		}
-		tmpmerchanttable[npcid] = tmp_merlist;
 
 		if (sold)
 			return ml.slot;
@@ -391,10 +389,9 @@ int Zone::SaveTempItem(uint32 merchantid, uint32 npcid, uint32 item, int32 charg
 	if (freeslot) {
 		if (charges < 0) //sanity check only, shouldnt happen
 			charges = 0x7FFF;
-		database.SaveMerchantTemp(npcid, freeslot, item, charges, 1);
+		SaveMerchantTemp(npcid, freeslot, item, charges, 1);
 		Log.Out(Logs::General, Logs::Trading, "%d ADDED to temp in slot %d with charges/qty %d/%d", item, freeslot, charges, 1);
 
-		tmp_merlist = tmpmerchanttable[npcid];
 		TempMerchantList ml2;
 		ml2.charges = charges;
 		ml2.item = item;
@@ -403,87 +400,132 @@ int Zone::SaveTempItem(uint32 merchantid, uint32 npcid, uint32 item, int32 charg
 		ml2.origslot = ml2.slot;
 		ml2.quantity = 1;
 		tmp_merlist.push_back(ml2);
-		tmpmerchanttable[npcid] = tmp_merlist;
 	}
 	return freeslot;
 }
 
 void Zone::SaveMerchantItem(uint32 merchantid, int16 item, int8 charges, int8 slot) 
 {
-	std::list<MerchantList> merlist = merchanttable[merchantid];
-	std::list<MerchantList>::const_iterator itr;
-	bool update_charges = false;
-	MerchantList ml;
+	MerchantList *ml = GetMerchantSlot(merchantid, slot);
+	if (ml == nullptr || ml->item != item)
+		return;
+
+	std::vector<MerchantList> &merlist = merchanttable[merchantid];
+	std::vector<MerchantList>::iterator itr;
 	for (itr = merlist.begin(); itr != merlist.end(); ++itr) {
-		ml = *itr;
-		if (ml.item == item && ml.slot == slot)
+		if(itr->item == item || itr->slot == slot)
 		{
-			update_charges = true;
-			break;
-		}
-	}
-
-	if (update_charges)
-	{
-		merlist.clear();
-		std::list<MerchantList> old_merlist = merchanttable[merchantid];
-		for (itr = old_merlist.begin(); itr != old_merlist.end(); ++itr) {
-			MerchantList ml2 = *itr;
-			if(ml2.item != item && ml2.slot != slot)
-			{
-				merlist.push_back(ml2);
-			}
-			else
-			{
-				Log.Out(Logs::General, Logs::Trading, "Merchant %d is saving item %d with %d charges", merchantid, item, charges);
-				ml2.qty_left = charges;
-				merlist.push_back(ml2);
-			}
+			Log.Out(Logs::General, Logs::Trading, "Merchant %d is saving item %d with %d charges", merchantid, item, charges);
+			itr->qty_left = charges;
 		}
-		merchanttable[merchantid] = merlist;
 	}
 }
 
 void Zone::ResetMerchantQuantity(uint32 merchantid) 
 {
-	std::list<MerchantList> merlist = merchanttable[merchantid];
-	std::list<MerchantList>::const_iterator itr;
-	bool update_charges = false;
-	MerchantList ml;
+	std::vector<MerchantList> &merlist = merchanttable[merchantid];
+	std::vector<MerchantList>::iterator itr;
 	for (itr = merlist.begin(); itr != merlist.end(); ++itr) {
-		ml = *itr;
-		if (ml.quantity > 0)
+		if(itr->quantity > 0)
 		{
-			update_charges = true;
-			break;
+			Log.Out(Logs::General, Logs::Trading, "Merchant %d is restting item %d to %d charges", merchantid, itr->item, itr->quantity);
+			itr->qty_left = itr->quantity;
 		}
 	}
+}
 
-	if (update_charges)
-	{
-		merlist.clear();
-		std::list<MerchantList> old_merlist = merchanttable[merchantid];
-		for (itr = old_merlist.begin(); itr != old_merlist.end(); ++itr) {
-			MerchantList ml2 = *itr;
-			if(ml2.quantity <= 0)
-			{
-				merlist.push_back(ml2);
-			}
-			else
-			{
-				Log.Out(Logs::General, Logs::Trading, "Merchant %d is restting item %d to %d charges", merchantid, ml2.item, ml2.quantity);
-				ml2.qty_left = ml2.quantity;
-				merlist.push_back(ml2);
-			}
-		}
-		merchanttable[merchantid] = merlist;
+MerchantList* Zone::GetMerchantSlot(uint32 merchantid, uint32 slot)
+{
+	auto iter = merchanttable.find(merchantid);
+	if (iter == merchanttable.end() || slot == 0)
+		return nullptr;
+
+	// Lists are loaded in slot order and rarely have gaps, so a slot is usually found at slot - 1.
+	std::vector<MerchantList> &merlist = iter->second;
+	if (slot <= merlist.size() && merlist[slot - 1].slot == slot)
+		return &merlist[slot - 1];
+
+	size_t low = 0;
+	size_t high = merlist.size();
+	while (low < high) {
+		size_t mid = (low + high) / 2;
+		if (merlist[mid].slot < slot)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	if (low < merlist.size() && merlist[low].slot == slot)
+		return &merlist[low];
+
+	return nullptr;
+}
+
+void Zone::SaveMerchantTemp(uint32 npcid, uint32 slot, uint32 item, uint32 charges, uint32 quantity)
+{
+	TempMerchantList &ml = merchant_temp_writes[std::make_pair(npcid, slot)];
+	ml.npcid = npcid;
+	ml.slot = slot;
+	ml.origslot = slot;
+	ml.item = item;
+	ml.charges = charges;
+	ml.quantity = quantity;
+}
+
+void Zone::DeleteMerchantTemp(uint32 npcid, uint32 slot)
+{
+	TempMerchantList &ml = merchant_temp_writes[std::make_pair(npcid, slot)];
+	memset(&ml, 0, sizeof(ml));
+	ml.npcid = npcid;
+	ml.slot = slot;
+	ml.origslot = slot;
+}
+
+void Zone::FlushMerchantTemp()
+{
+	if (merchant_temp_writes.empty())
+		return;
+
+	std::vector<TempMerchantList> saves;
+	std::vector<TempMerchantList> deletes;
+	for (auto iter = merchant_temp_writes.begin(); iter != merchant_temp_writes.end(); ++iter) {
+		if (iter->second.item == 0)
+			deletes.push_back(iter->second);
+		else
+			saves.push_back(iter->second);
 	}
+	merchant_temp_writes.clear();
+
+	database.DeleteMerchantTemp(deletes);
+	database.SaveMerchantTemp(saves);
+}
+
+void Zone::QueueCorpseSave(uint16 corpse_id)
+{
+	corpse_saves.insert(corpse_id);
+}
+
+void Zone::FlushCorpseSaves()
+{
+	if (corpse_saves.empty())
+		return;
+
+	std::set<uint16> saves;
+	saves.swap(corpse_saves);
+
+	// one commit for every corpse and its backup instead of one per query
+	database.TransactionBegin();
+	for (auto iter = saves.begin(); iter != saves.end(); ++iter) {
+		Corpse *corpse = entity_list.GetCorpseByID(*iter);
+		if (corpse && corpse->IsSaveQueued())
+			corpse->Flush();
+	}
+	database.TransactionCommit();
 }
 
 uint32 Zone::GetTempMerchantQuantity(uint32 NPCID, uint32 Slot) {
 
-	std::list<TempMerchantList> TmpMerchantList = tmpmerchanttable[NPCID];
-	std::list<TempMerchantList>::const_iterator Iterator;
+	std::vector<TempMerchantList> &TmpMerchantList = tmpmerchanttable[NPCID];
+	std::vector<TempMerchantList>::const_iterator Iterator;
 
 	for (Iterator = TmpMerchantList.begin(); Iterator != TmpMerchantList.end(); ++Iterator)
 		if ((*Iterator).slot == Slot)
@@ -494,8 +536,8 @@ uint32 Zone::GetTempMerchantQuantity(uint32 NPCID, uint32 Slot) {
 
 int8 Zone::GetTempMerchantQtyNoSlot(uint32 NPCID, int16 itemid) {
 
-	std::list<TempMerchantList> TmpMerchantList = tmpmerchanttable[NPCID];
-	std::list<TempMerchantList>::const_iterator Iterator;
+	std::vector<TempMerchantList> &TmpMerchantList = tmpmerchanttable[NPCID];
+	std::vector<TempMerchantList>::const_iterator Iterator;
 
 	for (Iterator = TmpMerchantList.begin(); Iterator != TmpMerchantList.end(); ++Iterator)
 	{
@@ -528,7 +570,7 @@ void Zone::LoadTempMerchantData() {
 	if (!results.Success()) {
 		return;
 	}
-	std::map<uint32, std::list<TempMerchantList> >::iterator cur;
+	std::map<uint32, std::vector<TempMerchantList> >::iterator cur;
 	uint32 npcid = 0;
 	for (auto row = results.begin(); row != results.end(); ++row) {
 		TempMerchantList ml;
@@ -536,7 +578,7 @@ void Zone::LoadTempMerchantData() {
 		if (npcid != ml.npcid){
 			cur = tmpmerchanttable.find(ml.npcid);
 			if (cur == tmpmerchanttable.end()) {
-				std::list<TempMerchantList> empty;
+				std::vector<TempMerchantList> empty;
 				tmpmerchanttable[ml.npcid] = empty;
 				cur = tmpmerchanttable.find(ml.npcid);
 			}
@@ -556,7 +598,7 @@ void Zone::LoadNewMerchantData(uint32 merchantid) {
 
 	Log.Out(Logs::General, Logs::Status, "Merchant: %d is loading...", merchantid);
 
-	std::list<MerchantList> merlist;
+	std::vector<MerchantList> merlist;
 	std::string query = StringFormat("SELECT item, slot, faction_required, level_required, "
                                      "classes_required, quantity FROM merchantlist WHERE merchantid=%d ORDER BY slot", merchantid);
     auto results = database.QueryDatabase(query);
@@ -604,7 +646,7 @@ void Zone::GetMerchantDataForZoneLoad() {
 		"AND se.spawngroupid = s2.spawngroupid AND s2.zone = '%s' AND s2.version = %i  "
 		"ORDER BY ml.slot															   ", GetShortName(), GetInstanceVersion());
 	auto results = database.QueryDatabase(query);
-	std::map<uint32, std::list<MerchantList> >::iterator cur;
+	std::map<uint32, std::vector<MerchantList> >::iterator cur;
 	uint32 npcid = 0;
 	if (results.RowCount() == 0) {
 		Log.Out(Logs::General, Logs::None, "No Merchant Data found for %s.", GetShortName());
@@ -616,14 +658,14 @@ void Zone::GetMerchantDataForZoneLoad() {
 		if (npcid != ml.id) {
 			cur = merchanttable.find(ml.id);
 			if (cur == merchanttable.end()) {
-				std::list<MerchantList> empty;
+				std::vector<MerchantList> empty;
 				merchanttable[ml.id] = empty;
 				cur = merchanttable.find(ml.id);
 			}
 			npcid = ml.id;
 		}
 
-		std::list<MerchantList>::iterator iter = cur->second.begin();
+		std::vector<MerchantList>::iterator iter = cur->second.begin();
 		bool found = false;
 		while (iter != cur->second.end()) {
 			if ((*iter).item == ml.id) {
@@ -654,6 +696,9 @@ void Zone::GetMerchantDataForZoneLoad() {
 
 void Zone::ClearMerchantLists()
 {
+	// the lists are about to be reloaded from the database
+	FlushMerchantTemp();
+
 	std::string query = StringFormat("SELECT nt.id "
 									" FROM npc_types AS nt, "
 									" merchantlist AS ml, "
@@ -708,6 +753,8 @@ void Zone::Shutdown(bool quite)
 		return;
 
 	entity_list.StopMobAI();
+	zone->FlushMerchantTemp();
+	zone->FlushCorpseSaves();
 
 	std::map<uint32,NPCType *>::iterator itr;
 	while(!zone->npctable.empty()) {
@@ -768,6 +815,8 @@ Zone::Zone(uint32 in_zoneid, uint32 in_instanceid, const char* in_short_name)
 	spawn2_timer(1000),
 	qglobal_purge_timer(30000),
 	hotzone_timer(120000),
+	merchant_temp_timer(10000),
+	corpse_save_timer(RuleI(Character, CorpseSaveDelayMS)),
 	m_SafePoint(0.0f,0.0f,0.0f),
 	m_Graveyard(0.0f,0.0f,0.0f,0.0f)
 {
@@ -1039,6 +1088,9 @@ void Zone::ReloadStaticData() {
 	NPCEmoteList.Clear();
 	zone->LoadNPCEmotes(&NPCEmoteList);
 
+	Log.Out(Logs::General, Logs::Status, "Clearing tradeskill recipes...");
+	database.ClearTradeskillRecipes();
+
 	//load the zone config file.
 	if (!LoadZoneCFG(zone->GetShortName(), zone->GetInstanceVersion(), true)) // try loading the zone name...
 		LoadZoneCFG(zone->GetFileName(), zone->GetInstanceVersion()); // if that fails, try the file name, then load defaults
@@ -1259,6 +1311,10 @@ bool Zone::Process() {
 
 	if(hotzone_timer.Check()) { UpdateHotzone(); }
 
+	if(merchant_temp_timer.Check()) { FlushMerchantTemp(); }
+
+	if(corpse_save_timer.Check()) { FlushCorpseSaves(); }
+
 	return true;
 }
 
@@ -1422,15 +1478,14 @@ void Zone::ClearNPCTypeCache(int id) {
 		npctable.clear();
 	}
 	else {
-		auto iter = npctable.begin();
-		while (iter != npctable.end()) {
-			if (iter->first == (uint32)id) {
-				delete iter->second;
-				npctable.erase(iter);
-				return;
-			}
-			++iter;
+		auto iter = npctable.find((uint32)id);
+		if (iter != npctable.end()) {
+			delete iter->second;
+			npctable.erase(iter);
 		}
+		// the shared segment only changes with a hotfix, so pull the current row in over it
+		if (database.GetSharedNPCType(id))
+			database.LoadNPCType(id);
 	}
 }
 
@@ -28,6 +28,8 @@
 #include "spawn2.h"
 #include "spawngroup.h"
 
+#include <set>
+
 struct ZonePoint
 {
 	float x;
@@ -173,6 +175,12 @@ public:
 	void	SaveMerchantItem(uint32 merchantid, int16 item, int8 charges, int8 slot);
 	void	ResetMerchantQuantity(uint32 merchantid);
 	void	ClearMerchantLists();
+	MerchantList* GetMerchantSlot(uint32 merchantid, uint32 slot);
+	void	SaveMerchantTemp(uint32 npcid, uint32 slot, uint32 item, uint32 charges, uint32 quantity);
+	void	DeleteMerchantTemp(uint32 npcid, uint32 slot);
+	void	FlushMerchantTemp();
+	void	QueueCorpseSave(uint16 corpse_id);
+	void	FlushCorpseSaves();
 
 	uint8	GetZoneExpansion() { return newzone_data.expansion; }
 
@@ -182,8 +190,8 @@ public:
 	void SetInstanceTimer(uint32 new_duration);
 
 	std::map<uint32,NPCType *> npctable;
-	std::map<uint32,std::list<MerchantList> > merchanttable;
-	std::map<uint32,std::list<TempMerchantList> > tmpmerchanttable;
+	std::map<uint32,std::vector<MerchantList> > merchanttable;	//each list is in slot order
+	std::map<uint32,std::vector<TempMerchantList> > tmpmerchanttable;
 	std::map<uint32, ZoneEXPModInfo> level_exp_mod;
 	std::map<uint32, SkillDifficulty> skill_difficulty;
 
@@ -340,6 +348,14 @@ private:
 	QGlobalCache *qGlobals;
 
 	Timer	hotzone_timer;
+
+	//merchantlist_temp writes waiting for merchant_temp_timer, keyed by npcid and slot. item 0 is a delete.
+	std::map<std::pair<uint32, uint32>, TempMerchantList> merchant_temp_writes;
+	Timer	merchant_temp_timer;
+
+	//entity ids of player corpses with changes waiting for corpse_save_timer, see Corpse::Save()
+	std::set<uint16> corpse_saves;
+	Timer	corpse_save_timer;
 };
 
 #endif
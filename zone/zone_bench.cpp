@@ -0,0 +1,429 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*
+	zone_bench: headless zone simulation
+
+	Boots a zone against the configured database without a world server,
+	spawns synthetic NPCs and scripted clients, runs the zone main loop for
+	a fixed duration and reports tick time percentiles per subsystem.
+
+	usage: zone_bench <zone short name> [npcs] [clients] [seconds] [npc type id] [spell id]
+
+	Clients are driven with the first [clients] characters found in
+	character_data, they will be saved back to the database so point this at
+	a fixture database, not a live one.
+*/
+
+#define PLATFORM_ZONE 1
+
+#include "../common/global_define.h"
+#include "../common/features.h"
+#include "../common/eq_packet.h"
+#include "../common/eq_stream_intf.h"
+#include "../common/eqemu_logsys.h"
+#include "../common/rdtsc.h"
+#include "../common/rulesys.h"
+#include "../common/servertalk.h"
+#include "../common/string_util.h"
+#include "../common/timer.h"
+#include "../common/platform.h"
+
+#include "command.h"
+#include "masterentity.h"
+#include "net.h"
+#include "quest_parser_collection.h"
+#include "titles.h"
+#include "guild_mgr.h"
+#include "zone.h"
+#include "zone_config.h"
+#include "questmgr.h"
+#include "zone_profiler.h"
+#include "lua_parser.h"
+#include "embparser.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+extern Zone* zone;
+extern volatile bool ZoneLoaded;
+extern EntityList entity_list;
+extern QuestParserCollection *parse;
+extern TitleManager title_manager;
+extern NetConnection net;
+extern npcDecayTimes_Struct npcCorpseDecayTimes[100];
+extern const SPDat_Spell_Struct* spells;
+extern int32 SPDAT_RECORDS;
+extern EQEmuLogSys Log;
+extern uint32 numclients;
+extern void MapOpcodes();
+
+namespace ZoneBench {
+
+	//full run samples in microseconds, the profiler itself only keeps a rolling window
+	static std::vector<uint32> tick_samples[ZoneProfiler::MaxPhase];
+
+	static void EndTick() {
+		ZoneProfiler::EndTick();
+		for (int i = 0; i < ZoneProfiler::MaxPhase; ++i)
+			tick_samples[i].push_back(ZoneProfiler::GetLastSample(static_cast<ZoneProfiler::Phase>(i)));
+	}
+
+	static double Percentile(const std::vector<uint32> &sorted, double pct) {
+		if (sorted.empty())
+			return 0.0;
+		size_t idx = static_cast<size_t>(pct * (sorted.size() - 1) + 0.5);
+		return sorted[idx] / 1000.0;
+	}
+
+	static void Report(uint32 npcs, uint32 clients) {
+		printf("\nzone_bench: %s, %u npcs, %u clients, %u ticks\n", zone ? zone->GetShortName() : "<none>",
+			npcs, clients, (uint32)tick_samples[ZoneProfiler::Tick].size());
+		printf("%-24s %10s %10s %10s %10s %10s %12s\n", "phase (ms/tick)", "p50", "p90", "p99", "max", "mean", "calls");
+		for (int i = 0; i < ZoneProfiler::MaxPhase; ++i) {
+			ZoneProfiler::Phase id = static_cast<ZoneProfiler::Phase>(i);
+			std::vector<uint32> sorted = tick_samples[i];
+			std::sort(sorted.begin(), sorted.end());
+			uint64 sum = 0;
+			for (size_t r = 0; r < sorted.size(); ++r)
+				sum += sorted[r];
+			double mean = sorted.empty() ? 0.0 : sum / 1000.0 / sorted.size();
+			ZoneProfiler::PhaseStats stats;
+			ZoneProfiler::GetStats(id, stats);
+			printf("%-24s %10.3f %10.3f %10.3f %10.3f %10.3f %12llu\n", ZoneProfiler::GetPhaseName(id),
+				Percentile(sorted, 0.50), Percentile(sorted, 0.90), Percentile(sorted, 0.99),
+				Percentile(sorted, 1.0), mean, (unsigned long long)stats.calls);
+		}
+	}
+}
+
+/*
+	Loopback stream for the scripted clients, outbound packets are counted
+	and dropped, inbound packets are whatever the script queued.
+*/
+class BenchStream : public EQStreamInterface {
+public:
+	BenchStream(uint32 ip) : m_ip(ip), m_state(ESTABLISHED), m_sent_packets(0), m_sent_bytes(0) { }
+	virtual ~BenchStream() {
+		while (!m_inbound.empty()) {
+			delete m_inbound.front();
+			m_inbound.pop_front();
+		}
+	}
+
+	virtual void QueuePacket(const EQApplicationPacket *p, bool ack_req = true) {
+		if (p) {
+			m_sent_packets++;
+			m_sent_bytes += p->size;
+		}
+	}
+	virtual void FastQueuePacket(EQApplicationPacket **p, bool ack_req = true) {
+		if (p && *p) {
+			QueuePacket(*p, ack_req);
+			safe_delete(*p);
+		}
+	}
+	virtual EQApplicationPacket *PopPacket() {
+		if (m_inbound.empty())
+			return nullptr;
+		EQApplicationPacket *p = m_inbound.front();
+		m_inbound.pop_front();
+		return p;
+	}
+	virtual void Close() { m_state = CLOSED; }
+	virtual void ReleaseFromUse() { }
+	virtual void RemoveData() { }
+	virtual uint32 GetRemoteIP() const { return m_ip; }
+	virtual uint16 GetRemotePort() const { return 0; }
+	virtual bool CheckState(EQStreamState state) { return m_state == state; }
+	virtual std::string Describe() const { return "Bench Stream"; }
+	virtual const uint32 GetBytesSent() const { return m_sent_bytes; }
+	virtual const EQClientVersion ClientVersion() const { return EQClientMac; }
+	virtual bool IsInUse() { return true; }
+
+	void Push(EmuOpcode op, const void *data, uint32 len) {
+		m_inbound.push_back(new EQApplicationPacket(op, (const unsigned char *)data, len));
+	}
+
+	uint32 GetPacketsSent() const { return m_sent_packets; }
+
+private:
+	uint32 m_ip;
+	EQStreamState m_state;
+	uint32 m_sent_packets;
+	uint32 m_sent_bytes;
+	std::deque<EQApplicationPacket *> m_inbound;
+};
+
+struct BenchClient {
+	BenchStream *stream;
+	Client *client;
+	std::string name;
+	float angle;
+	uint16 target_id;
+};
+
+static bool LoadStaticData() {
+	database.LoadVariables();
+
+	char hotfix_name[256] = { 0 };
+	database.GetVariable("hotfix_name", hotfix_name, 256);
+
+	database.LoadZoneNames();
+	if (!database.LoadItems(hotfix_name))
+		Log.Out(Logs::General, Logs::Error, "Loading items FAILED, continuing.");
+	if (!database.LoadNPCTypes(hotfix_name))
+		Log.Out(Logs::General, Logs::Error, "Loading npc types FAILED, continuing.");
+	if (!database.LoadNPCFactionLists(hotfix_name) || !database.LoadLoot(hotfix_name) ||
+		!database.LoadSkillCaps(std::string(hotfix_name)) || !database.LoadSpells(hotfix_name, &SPDAT_RECORDS, &spells) ||
+		!database.LoadBaseData(hotfix_name)) {
+		Log.Out(Logs::General, Logs::Error, "Loading shared data FAILED, run shared_memory first.");
+		return false;
+	}
+
+	guild_mgr.LoadGuilds();
+	database.LoadFactionData();
+	title_manager.LoadTitles();
+	database.LoadAAEffects();
+	database.GetDecayTimes(npcCorpseDecayTimes);
+	command_init();
+
+	char tmp[64];
+	if (!database.GetVariable("RuleSet", tmp, sizeof(tmp) - 1))
+		strcpy(tmp, "default");
+	RuleManager::Instance()->LoadRules(&database, tmp);
+
+	//an empty zone would idle and skip most of the work we are trying to measure
+	RuleManager::Instance()->SetRule("Zone:IdleWhenEmpty", "false");
+	return true;
+}
+
+static void SpawnBenchNPCs(uint32 count, uint32 npc_type_id) {
+	const NPCType *npc_type = database.GetNPCType(npc_type_id);
+	if (npc_type == nullptr) {
+		Log.Out(Logs::General, Logs::Error, "npc type %u not found, no npcs spawned.", npc_type_id);
+		return;
+	}
+
+	glm::vec3 safe = zone->GetSafePoint();
+	int side = static_cast<int>(sqrt(static_cast<double>(count))) + 1;
+	for (uint32 i = 0; i < count; ++i) {
+		glm::vec4 pos(safe.x + (i % side) * 10.0f - side * 5.0f, safe.y + (i / side) * 10.0f - side * 5.0f, safe.z, 0.0f);
+		NPC *npc = new NPC(npc_type, nullptr, pos, FlyMode3);
+		entity_list.AddNPC(npc);
+	}
+}
+
+static void ConnectBenchClients(std::vector<BenchClient> &out, uint32 count) {
+	std::string query = StringFormat("SELECT `id`, `account_id`, `name` FROM `character_data` ORDER BY `id` LIMIT %u", count);
+	auto results = database.QueryDatabase(query);
+	if (!results.Success())
+		return;
+
+	uint32 ip = 0x0100007F;
+	for (auto row = results.begin(); row != results.end(); ++row) {
+		ServerZoneIncomingClient_Struct szic;
+		memset(&szic, 0, sizeof(szic));
+		szic.zoneid = zone->GetZoneID();
+		szic.ip = ip;
+		szic.wid = out.size() + 1;
+		szic.charid = atoi(row[0]);
+		szic.accid = atoi(row[1]);
+		szic.version = EQClientMac;
+		strn0cpy(szic.charname, row[2], sizeof(szic.charname));
+		zone->AddAuth(&szic);
+
+		BenchClient bc;
+		bc.stream = new BenchStream(ip);
+		bc.client = new Client(bc.stream);
+		bc.name = row[2];
+		bc.angle = out.size() * 0.5f;
+		bc.target_id = 0;
+		entity_list.AddClient(bc.client);
+
+		ClientZoneEntry_Struct cze;
+		memset(&cze, 0, sizeof(cze));
+		strn0cpy(cze.char_name, row[2], sizeof(cze.char_name));
+		bc.stream->Push(OP_ZoneEntry, &cze, sizeof(cze));
+		bc.stream->Push(OP_ReqNewZone, nullptr, 0);
+		bc.stream->Push(OP_ReqClientSpawn, nullptr, 0);
+		bc.stream->Push(OP_ClientUpdate, nullptr, 0);
+		out.push_back(bc);
+	}
+}
+
+/*
+	Per tick client script: run in a circle around the safe point, pick the
+	closest NPC and auto attack it and every few seconds cast a spell on it.
+*/
+static void DriveBenchClient(BenchClient &bc, uint32 tick) {
+	Client *c = bc.client;
+	if (!c->Connected())
+		return;
+
+	glm::vec3 safe = zone->GetSafePoint();
+	bc.angle += 0.05f;
+	SpawnPositionUpdate_Struct spu;
+	memset(&spu, 0, sizeof(spu));
+	spu.spawn_id = c->GetID();
+	spu.x_pos = static_cast<int16>(safe.x + cosf(bc.angle) * 50.0f);
+	spu.y_pos = static_cast<int16>(safe.y + sinf(bc.angle) * 50.0f);
+	spu.z_pos = static_cast<int16>(safe.z * 10.0f);
+	spu.heading = static_cast<uint8>(static_cast<int>(bc.angle * 40.0f) & 0xFF);
+	spu.anim_type = 1;
+	bc.stream->Push(OP_ClientUpdate, &spu, sizeof(spu));
+
+	if (tick % 100 == 0) {
+		Mob *target = entity_list.GetClosestMobByBodyType(c, BT_Humanoid);
+		if (target && target->IsNPC() && target->GetID() != bc.target_id) {
+			bc.target_id = target->GetID();
+			ClientTarget_Struct ct;
+			ct.new_target = bc.target_id;
+			bc.stream->Push(OP_TargetMouse, &ct, sizeof(ct));
+			uint32 attack = 1;
+			bc.stream->Push(OP_AutoAttack, &attack, sizeof(attack));
+		}
+	}
+}
+
+int main(int argc, char **argv) {
+	RegisterExecutablePlatform(ExePlatformZone);
+	Log.LoadLogSettingsDefaults();
+
+	if (argc < 2) {
+		printf("usage: %s <zone short name> [npcs] [clients] [seconds] [npc type id] [spell id]\n", argv[0]);
+		return 1;
+	}
+
+	const char *zone_name = argv[1];
+	uint32 npc_count = argc > 2 ? atoi(argv[2]) : 500;
+	uint32 client_count = argc > 3 ? atoi(argv[3]) : 0;
+	uint32 seconds = argc > 4 ? atoi(argv[4]) : 60;
+	uint32 npc_type_id = argc > 5 ? atoi(argv[5]) : RuleI(NPC, NPCTemplateID);
+	uint16 spell_id = argc > 6 ? atoi(argv[6]) : 200;
+
+	if (!ZoneConfig::LoadConfig()) {
+		Log.Out(Logs::General, Logs::Error, "Loading server configuration failed.");
+		return 1;
+	}
+	const ZoneConfig *Config = ZoneConfig::get();
+
+	if (!database.Connect(Config->DatabaseHost.c_str(), Config->DatabaseUsername.c_str(),
+		Config->DatabasePassword.c_str(), Config->DatabaseDB.c_str(), Config->DatabasePort)) {
+		Log.Out(Logs::General, Logs::Error, "Cannot continue without a database connection.");
+		return 1;
+	}
+	database.LoadLogSettings(Log.log_settings);
+	guild_mgr.SetDatabase(&database);
+	MapOpcodes();
+
+	if (!LoadStaticData())
+		return 1;
+
+	parse = new QuestParserCollection();
+#ifdef LUA_EQEMU
+	LuaParser *lua_parser = new LuaParser();
+	parse->RegisterQuestInterface(lua_parser, "lua");
+#endif
+#ifdef EMBPERL
+	PerlembParser *perl_parser = new PerlembParser();
+	parse->RegisterQuestInterface(perl_parser, "pl");
+#endif
+	parse->ReloadQuests();
+
+	Timer::SetCurrentTime();
+	if (!Zone::Bootup(database.GetZoneID(zone_name), 0, true)) {
+		Log.Out(Logs::General, Logs::Error, "Zone Bootup failed for '%s'", zone_name);
+		return 1;
+	}
+
+	SpawnBenchNPCs(npc_count, npc_type_id);
+	std::vector<BenchClient> clients;
+	ConnectBenchClients(clients, client_count);
+
+	Timer quest_timers(100);
+	Timer bench_timer(seconds * 1000);
+	uint32 tick = 0;
+	while (!bench_timer.Check()) {
+		Timer::SetCurrentTime();
+		{
+			PROFILE_PHASE(Tick);
+
+			if (net.group_timer.Enabled() && net.group_timer.Check())
+				entity_list.GroupProcess();
+			if (net.door_timer.Enabled() && net.door_timer.Check())
+				entity_list.DoorProcess();
+			if (net.object_timer.Enabled() && net.object_timer.Check())
+				entity_list.ObjectProcess();
+			if (net.corpse_timer.Enabled() && net.corpse_timer.Check())
+				entity_list.CorpseProcess();
+			if (net.trap_timer.Enabled() && net.trap_timer.Check())
+				entity_list.TrapProcess();
+			if (net.raid_timer.Enabled() && net.raid_timer.Check())
+				entity_list.RaidProcess();
+
+			{
+				PROFILE_PHASE(EntityProcess);
+				entity_list.Process();
+			}
+			entity_list.MobProcess();
+			entity_list.BeaconProcess();
+			entity_list.EncounterProcess();
+
+			{
+				PROFILE_PHASE(ZoneProcess);
+				zone->Process();
+			}
+
+			if (quest_timers.Check())
+				quest_manager.Process();
+		}
+		ZoneBench::EndTick();
+
+		for (size_t i = 0; i < clients.size(); ++i) {
+			DriveBenchClient(clients[i], tick);
+			Client *c = clients[i].client;
+			if (c->Connected() && tick % 300 == 0 && clients[i].target_id)
+				c->CastSpell(spell_id, clients[i].target_id);
+		}
+
+		++tick;
+		Sleep(ZoneTimerResolution);
+	}
+
+	ZoneBench::Report(npc_count, clients.size());
+
+	entity_list.Clear();
+	parse->ClearInterfaces();
+#ifdef EMBPERL
+	safe_delete(perl_parser);
+#endif
+#ifdef LUA_EQEMU
+	safe_delete(lua_parser);
+#endif
+	Zone::Shutdown(true);
+	for (size_t i = 0; i < clients.size(); ++i)
+		safe_delete(clients[i].stream);
+	command_deinit();
+	safe_delete(parse);
+	return 0;
+}
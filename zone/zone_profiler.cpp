@@ -0,0 +1,209 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "../common/global_define.h"
+#include "../common/misc_functions.h"
+#include "../common/servertalk.h"
+#include "../common/string_util.h"
+
+#include "client.h"
+#include "entity.h"
+#include "opcode_metrics.h"
+#include "worldserver.h"
+#include "zone.h"
+#include "zonedb.h"
+#include "zone_profiler.h"
+
+#include <algorithm>
+#include <vector>
+
+extern EntityList entity_list;
+extern WorldServer worldserver;
+extern Zone *zone;
+extern uint32 numclients;
+
+namespace ZoneProfiler {
+
+	static const char *PhaseName[MaxPhase] = {
+		"Tick",
+		"WorldServer",
+		"Network",
+		"EntityProcess",
+		"PacketDispatch",
+		"MobProcess",
+		"AIProcess",
+		"Pathing",
+		"SpellProcess",
+		"QuestEvents",
+		"PositionUpdates",
+		"ZoneProcess"
+	};
+
+	int64 phase_ticks[MaxPhase];
+	uint64 phase_calls[MaxPhase];
+	LoopStats loop_stats;
+
+	static uint32 window[MaxPhase][ZONE_PROFILER_WINDOW];
+	static uint32 window_pos = 0;
+	static uint32 window_count = 0;
+
+	const char *GetPhaseName(Phase id) {
+		return id < MaxPhase ? PhaseName[id] : "Unknown";
+	}
+
+	void EndTick() {
+		int64 per_us = RDTSC_Timer::ticksPerMS() / 1000;
+		if (per_us < 1)
+			per_us = 1;
+
+		for (int i = 0; i < MaxPhase; ++i) {
+			window[i][window_pos] = static_cast<uint32>(phase_ticks[i] / per_us);
+			phase_ticks[i] = 0;
+		}
+
+		window_pos = (window_pos + 1) % ZONE_PROFILER_WINDOW;
+		if (window_count < ZONE_PROFILER_WINDOW)
+			window_count++;
+	}
+
+	void CheckOverrun(uint32 interval_ms) {
+		uint32 work_ms = GetLastSample(Tick) / 1000;
+		if (work_ms <= interval_ms)
+			return;
+
+		uint32 over = work_ms - interval_ms;
+		loop_stats.overruns++;
+		loop_stats.overrun_ms += over;
+		if (over > loop_stats.overrun_max)
+			loop_stats.overrun_max = over;
+	}
+
+	uint32 GetLastSample(Phase id) {
+		if (window_count == 0)
+			return 0;
+		return window[id][(window_pos + ZONE_PROFILER_WINDOW - 1) % ZONE_PROFILER_WINDOW];
+	}
+
+	void GetStats(Phase id, PhaseStats &out) {
+		memset(&out, 0, sizeof(PhaseStats));
+		out.calls = phase_calls[id];
+		if (window_count == 0)
+			return;
+
+		std::vector<uint32> sorted(window[id], window[id] + window_count);
+		std::sort(sorted.begin(), sorted.end());
+
+		uint64 sum = 0;
+		for (size_t i = 0; i < sorted.size(); ++i)
+			sum += sorted[i];
+
+		out.samples = window_count;
+		out.p50 = sorted[(sorted.size() - 1) * 50 / 100];
+		out.p90 = sorted[(sorted.size() - 1) * 90 / 100];
+		out.p99 = sorted[(sorted.size() - 1) * 99 / 100];
+		out.max = sorted.back();
+		out.mean = static_cast<uint32>(sum / sorted.size());
+	}
+
+	void Reset() {
+		memset(phase_ticks, 0, sizeof(phase_ticks));
+		memset(phase_calls, 0, sizeof(phase_calls));
+		memset(&loop_stats, 0, sizeof(loop_stats));
+		window_pos = 0;
+		window_count = 0;
+	}
+
+	void SendStats(Client *to) {
+		to->Message(CC_Yellow, "Zone profile, last %u ticks (ms per tick):", window_count);
+		to->Message(CC_Default, "%-16s %8s %8s %8s %8s %8s %10s", "phase", "p50", "p90", "p99", "max", "mean", "calls");
+		for (int i = 0; i < MaxPhase; ++i) {
+			PhaseStats s;
+			GetStats(static_cast<Phase>(i), s);
+			to->Message(CC_Default, "%-16s %8.2f %8.2f %8.2f %8.2f %8.2f %10llu", PhaseName[i],
+				s.p50 / 1000.0f, s.p90 / 1000.0f, s.p99 / 1000.0f, s.max / 1000.0f, s.mean / 1000.0f,
+				(unsigned long long)s.calls);
+		}
+		to->Message(CC_Default, "Loop: %llu waits, %llu woken by packets, %llu overruns (max %u ms, total %llu ms)",
+			(unsigned long long)loop_stats.waits, (unsigned long long)loop_stats.wakes,
+			(unsigned long long)loop_stats.overruns, loop_stats.overrun_max, (unsigned long long)loop_stats.overrun_ms);
+	}
+
+	void SendToWorld() {
+		if (!zone || !worldserver.Connected() || window_count == 0)
+			return;
+
+		ServerPacket* pack = new ServerPacket(ServerOP_ZoneProfile, sizeof(ServerZoneProfile_Struct));
+		ServerZoneProfile_Struct* zp = (ServerZoneProfile_Struct*)pack->pBuffer;
+		zp->zoneid = zone->GetZoneID();
+		zp->instanceid = zone->GetInstanceID();
+		zp->clients = numclients;
+		zp->samples = window_count;
+
+		PhaseStats s;
+		GetStats(Tick, s);
+		zp->tick_p50 = s.p50;
+		zp->tick_p99 = s.p99;
+		zp->tick_max = s.max;
+
+		//the tick itself covers every other phase, report the worst one below it
+		for (int i = Tick + 1; i < MaxPhase; ++i) {
+			GetStats(static_cast<Phase>(i), s);
+			if (s.p99 >= zp->worst_phase_p99) {
+				zp->worst_phase_p99 = s.p99;
+				strn0cpy(zp->worst_phase, PhaseName[i], sizeof(zp->worst_phase));
+			}
+		}
+
+		worldserver.SendPacket(pack);
+		safe_delete(pack);
+	}
+
+	void SendMetrics() {
+		if (!zone || !worldserver.Connected())
+			return;
+
+		ServerPacket* pack = new ServerPacket(ServerOP_ZoneMetrics, sizeof(ServerZoneMetrics_Struct));
+		ServerZoneMetrics_Struct* zm = (ServerZoneMetrics_Struct*)pack->pBuffer;
+		zm->zoneid = zone->GetZoneID();
+		zm->instanceid = zone->GetInstanceID();
+
+		PhaseStats s;
+		GetStats(Tick, s);
+		zm->tick_p50 = s.p50;
+		zm->tick_p99 = s.p99;
+		zm->tick_max = s.max;
+
+		zm->clients = numclients;
+		zm->npcs = entity_list.GetNPCCount();
+		zm->mobs = entity_list.GetMobCount();
+		zm->corpses = entity_list.GetCorpseCount();
+
+		zm->packets_in = OpcodeMetrics::totals.packets_in;
+		zm->bytes_in = OpcodeMetrics::totals.bytes_in;
+		zm->packets_out = OpcodeMetrics::totals.packets_out;
+		zm->bytes_out = OpcodeMetrics::totals.bytes_out;
+
+		zm->db_queries = database.GetQueryCount();
+		zm->db_query_time_us = database.GetQueryTimeUS();
+		zm->db_query_max_us = database.TakeQueryMaxUS();
+		zm->rss_bytes = GetResidentMemory();
+
+		worldserver.SendPacket(pack);
+		safe_delete(pack);
+	}
+}
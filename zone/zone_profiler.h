@@ -0,0 +1,113 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2016 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef ZONE_PROFILER_H
+#define ZONE_PROFILER_H
+
+/*
+	Always-on phase profiler for the zone main loop.
+
+	PROFILE_PHASE() puts a scoped rdtsc probe around a block, the time is
+	summed into the phase until the main loop calls EndTick(), which turns
+	the per tick totals into one sample per phase. The last
+	ZONE_PROFILER_WINDOW samples of every phase are kept for #profile and
+	the periodic report to world.
+
+	Phases are inclusive, a probe nested in another phase (AI_Process inside
+	MobProcess) counts towards both.
+*/
+
+#include "../common/rdtsc.h"
+#include "../common/types.h"
+
+#define ZONE_PROFILER_WINDOW 1024
+
+class Client;
+
+namespace ZoneProfiler {
+
+	enum Phase {
+		Tick = 0,
+		WorldServer,
+		Network,
+		EntityProcess,
+		PacketDispatch,
+		MobProcess,
+		AIProcess,
+		Pathing,
+		SpellProcess,
+		QuestEvents,
+		PositionUpdates,
+		ZoneProcess,
+		MaxPhase
+	};
+
+	struct PhaseStats {
+		uint32 p50;		//microseconds per tick
+		uint32 p90;
+		uint32 p99;
+		uint32 max;
+		uint32 mean;
+		uint32 samples;
+		uint64 calls;	//probe hits since the last reset
+	};
+
+	//how the main loop spent its time between passes
+	struct LoopStats {
+		uint64 waits;
+		uint64 wakes;		//waits cut short by a new client connection or a world packet
+		uint64 overruns;	//zone updates whose work ran past the update interval
+		uint64 overrun_ms;	//total time past the interval
+		uint32 overrun_max;	//ms
+	};
+
+	extern int64 phase_ticks[MaxPhase];
+	extern uint64 phase_calls[MaxPhase];
+	extern LoopStats loop_stats;
+
+	inline void AddTicks(Phase id, int64 ticks) {
+		phase_ticks[id] += ticks;
+		phase_calls[id]++;
+	}
+
+	const char *GetPhaseName(Phase id);
+	void EndTick();
+	void CheckOverrun(uint32 interval_ms);	//after EndTick(), against the tick just closed
+	uint32 GetLastSample(Phase id);
+	void GetStats(Phase id, PhaseStats &out);
+	void Reset();
+
+	void SendStats(Client *to);
+	void SendToWorld();
+	void SendMetrics();		//counters for the world metrics endpoint, see ServerZoneMetrics_Struct
+
+	class ScopedProbe {
+	public:
+		inline ScopedProbe(Phase id) : m_id(id), m_timer(true) { }
+		inline ~ScopedProbe() {
+			m_timer.stop();
+			AddTicks(m_id, m_timer.getTicks());
+		}
+	private:
+		Phase m_id;
+		RDTSC_Timer m_timer;
+	};
+}
+
+#define PROFILE_PHASE(name) ZoneProfiler::ScopedProbe __zone_profiler_probe(ZoneProfiler::name)
+
+#endif
@@ -6,6 +6,9 @@
 #include "position.h"
 #include "../common/faction.h"
 #include "../common/eqemu_logsys.h"
+#include "bazaar_index.h"
+
+#include <unordered_map>
 
 class Client;
 class Corpse;
@@ -89,6 +92,26 @@ struct DBnpcspellseffects_Struct {
 	DBnpcspellseffects_entries_Struct entries[0];
 };
 
+struct AISpells_Struct {
+	uint16	type;			// 0 = never, must be one (and only one) of the defined values
+	uint16	spellid;		// <= 0 = no spell
+	int16	manacost;		// -1 = use spdat, -2 = no cast time
+	int32	recast_delay;
+	int16	priority;
+	int16	resist_adjust;
+};
+
+// An npc_spells list merged with its parent list and cut down to one level,
+// sorted by priority. Built once by ZoneDatabase::GetNPCSpellsList() and shared
+// by every NPC of that list and level, so it is never written after that; the
+// recast times live on the NPC.
+struct AISpellsList_Struct {
+	std::vector<AISpells_Struct> spells;
+	std::vector<uint8> by_type[16];	// indexes into spells for each SpellType_ bit, in spells order
+	uint16	types;					// every SpellType_ bit found in spells
+	bool	has_zero_priority;		// a detrimental spell with priority 0
+};
+
 struct DBTradeskillRecipe_Struct {
 	SkillUseTypes tradeskill;
 	int16 skill_needed;
@@ -106,6 +129,15 @@ struct DBTradeskillRecipe_Struct {
 	bool quest;
 };
 
+// An enabled tradeskill_recipe with its entries, held by ZoneDatabase so a
+// combine needs no recipe queries. has_learnt and madecount in spec are per
+// character and filled in by GetTradeRecipe().
+struct TradeskillRecipe_Struct {
+	DBTradeskillRecipe_Struct spec;
+	std::vector<uint32> components;	// item id once per componentcount, sorted
+	std::vector<uint32> entries;	// every entry's item id, sorted, for the container checks
+};
+
 struct PetRecord {
 	uint32 npc_type;	// npc_type id for the pet data to use
 	bool temporary;
@@ -169,6 +201,7 @@ public:
 	ItemInst* LoadSingleTraderItem(uint32 char_id, int uniqueid);
 	Trader_Struct* LoadTraderItem(uint32 char_id);
 	TraderCharges_Struct* LoadTraderItemWithCharges(uint32 char_id);
+	const BazaarIndex& GetBazaarIndex() const { return bazaar_index; }
 	int8 ItemQuantityType(int16 item_id);
 
 	/* General Character Related Stuff  */
@@ -221,6 +254,7 @@ public:
 
 	/* Corpses  */
 	bool		DeleteItemOffCharacterCorpse(uint32 db_id, uint32 equip_slot, uint32 item_id);
+	bool		DeleteItemsOffCharacterCorpse(uint32 db_id, const std::vector<std::pair<int16, uint32>>& items);
 	uint32		GetCharacterCorpseItemCount(uint32 corpse_id);
 	bool		LoadCharacterCorpseData(uint32 corpse_id, PlayerCorpse_Struct* pcs);
 	Corpse*		LoadCharacterCorpse(uint32 player_corpse_id);
@@ -328,9 +362,11 @@ public:
 	uint32		GetMaxNPCSpellsEffectsID();
 
 	DBnpcspells_Struct*				GetNPCSpells(uint32 iDBSpellsID);
+	const AISpellsList_Struct*		GetNPCSpellsList(uint32 iDBSpellsID, uint8 level);
 	DBnpcspellseffects_Struct*		GetNPCSpellsEffects(uint32 iDBSpellsEffectsID);
 	const NPCType*					GetNPCType(uint32 id);
 	NPCType*					    GetNPCTypeTemp(uint32 id);
+	NPCType*						LoadNPCType(uint32 id);	//always queries, caches into zone->npctable
 
 	/* Petitions   */
 	void	UpdateBug(BugStruct* bug, uint32 clienttype);
@@ -343,12 +379,14 @@ public:
 	int		RemoveSoulMark(uint32 charid);
 
 	/* Merchants  */
-	void	SaveMerchantTemp(uint32 npcid, uint32 slot, uint32 item, uint32 charges, uint32 quantity);
-	void	DeleteMerchantTemp(uint32 npcid, uint32 slot);
+	void	SaveMerchantTemp(const std::vector<TempMerchantList> &rows);
+	void	DeleteMerchantTemp(const std::vector<TempMerchantList> &rows);
 
 	/* Tradeskills  */
 	bool	GetTradeRecipe(const ItemInst* container, uint8 c_type, uint32 some_id, uint32 char_id, DBTradeskillRecipe_Struct *spec);
 	bool	GetTradeRecipe(uint32 recipe_id, uint8 c_type, uint32 some_id, uint32 char_id, DBTradeskillRecipe_Struct *spec);
+	void	LoadTradeskillRecipes();
+	void	ClearTradeskillRecipes();	//reloaded on the next combine
 	uint32	GetZoneForage(uint32 ZoneID, uint8 skill); /* for foraging */
 	uint32	GetZoneFishing(uint32 ZoneID, uint8 skill, uint32 &npc_id, uint8 &npc_chance);
 	void	UpdateRecipeMadecount(uint32 recipe_id, uint32 char_id, uint32 madecount);
@@ -418,8 +456,13 @@ protected:
 	uint32 npc_spellseffects_maxid;
 	DBnpcspells_Struct** npc_spells_cache;
 	bool*				npc_spells_loadtried;
+	std::map<uint64, AISpellsList_Struct*> npc_spells_lists;	// (npc_spells_id << 8) | level
 	DBnpcspellseffects_Struct** npc_spellseffects_cache;
 	bool*				npc_spellseffects_loadtried;
+	std::map<uint32, TradeskillRecipe_Struct> tradeskill_recipes;
+	std::unordered_multimap<uint64, uint32> tradeskill_index;	// hash of the sorted components -> recipe id
+	bool				tradeskill_recipes_loaded;
+	BazaarIndex			bazaar_index;	// trader rows written by this zone
 	uint8 door_isopen_array[255];
 };
 
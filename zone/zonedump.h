@@ -29,110 +29,10 @@ spawn2 mediumblob, npcs mediumblob, npc_loot mediumblob, gmspawntype mediumblob,
 #include "../common/faction.h"
 #include "../common/eq_packet_structs.h"
 #include "../common/item.h"
+#include "../common/npc_types.h"
 
 #pragma pack(1)
 
-struct NPCType
-{
-	char	name[64];
-	char	lastname[70]; 
-	int32	cur_hp;
-	int32	max_hp; 
-	float	size;
-	float	runspeed;
-	float	walkspeed;
-	uint8	gender;
-	uint16	race;
-	uint8	class_;
-	uint8	bodytype;	// added for targettype support
-	uint8	deity;		//not loaded from DB
-	uint8	level;
-	uint32	npc_id;
-	uint8	texture;
-	uint8	helmtexture;
-	uint32	loottable_id;
-	uint32	npc_spells_id;
-	uint32	npc_spells_effects_id;
-	int32	npc_faction_id;
-	uint32	merchanttype;
-	uint32	trap_template;
-	uint8	light;
-	uint32	AC;
-	uint32	Mana;	//not loaded from DB
-	uint32	ATK;	//not loaded from DB
-	uint32	STR;
-	uint32	STA;
-	uint32	DEX;
-	uint32	AGI;
-	uint32	INT;
-	uint32	WIS;
-	uint32	CHA;
-	int32	MR;
-	int32	FR;
-	int32	CR;
-	int32	PR;
-	int32	DR;
-	int32	Corrup;
-	int32   PhR;
-	uint8	haircolor;
-	uint8	beardcolor;
-	uint8	eyecolor1;			// the eyecolors always seem to be the same, maybe left and right eye?
-	uint8	eyecolor2;
-	uint8	hairstyle;
-	uint8	luclinface;			//
-	uint8	beard;				//
-	uint32	armor_tint[_MaterialCount];
-	uint32	min_dmg;
-	uint32	max_dmg;
-	int16	attack_count;
-	char	special_abilities[512];
-	uint16	d_melee_texture1;
-	uint16	d_melee_texture2;
-	char	ammo_idfile[30];
-	uint8	prim_melee_type;
-	uint8	sec_melee_type;
-	uint8	ranged_type;
-	int32	hp_regen;
-	int32	mana_regen;
-	int32	aggroradius; // added for AI improvement - neotokyo
-	int32	assistradius; // assist radius, defaults to aggroradis if not set
-	uint8	see_invis;			// See Invis flag added
-	bool	see_invis_undead;	// See Invis vs. Undead flag added
-	bool	see_hide;
-	bool	see_improved_hide;
-	bool	qglobal;
-	bool	npc_aggro;
-	uint8	spawn_limit;	//only this many may be in zone at a time (0=no limit)
-	uint8	mount_color;	//only used by horse class
-	uint8	attack_delay;	//delay between attacks in 10ths of a second
-	int		accuracy_rating;	//10 = 1% accuracy
-	int		avoidance_rating;	//10 = 1% avoidance
-	bool	findable;		//can be found with find command
-	bool	trackable;
-	int16	slow_mitigation;	
-	uint8	maxlevel;
-	uint32	scalerate;
-	bool	private_corpse;
-	bool	unique_spawn_by_name;
-	bool	underwater;
-	uint32	emoteid;
-	float	spellscale;
-	float	healscale;
-	bool	no_target_hotkey;
-	bool	raid_target;
-	uint8 	probability;
-	uint32  combat_hp_regen;
-	uint32  combat_mana_regen;
-	bool	aggro_pc;
-	uint8	armtexture;
-	uint8	bracertexture;
-	uint8	handtexture;
-	uint8	legtexture;
-	uint8	feettexture;
-	uint8	chesttexture;
-	float	ignore_distance;
-};
-
 namespace player_lootitem {
 	struct ServerLootItem_Struct {
 		uint32	item_id;